@@ -0,0 +1,129 @@
+#include "bmp280.h"
+
+uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND bmp280_calib_reg_addr  = BMP280_REG_CALIB;
+uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND bmp280_id_reg_addr     = BMP280_REG_ID;
+uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND bmp280_status_reg_addr = BMP280_REG_STATUS;
+uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND bmp280_press_reg_addr  = BMP280_REG_PRESS;
+
+// config is only written reliably in sleep mode, so ctrl_meas is cleared
+// first. The register address auto-increment does not apply to writes,
+// every value is preceded by its register address.
+static uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND default_config[] =
+{
+    BMP280_REG_CTRL_MEAS, BMP280_MODE_SLEEP,
+    BMP280_REG_CONFIG,    BMP280_DEFAULT_CONFIG,
+    BMP280_REG_CTRL_MEAS, BMP280_CTRL_MEAS(BMP280_DEFAULT_OSRS_T,
+                                           BMP280_DEFAULT_OSRS_P,
+                                           BMP280_DEFAULT_MODE)
+};
+
+uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND bmp280_forced_measurement[BMP280_FORCED_MEASUREMENT_SIZE] =
+{
+    BMP280_REG_CTRL_MEAS, BMP280_CTRL_MEAS(BMP280_DEFAULT_OSRS_T,
+                                           BMP280_DEFAULT_OSRS_P,
+                                           BMP280_MODE_FORCED)
+};
+
+nrf_twi_mngr_transfer_t const bmp280_init_transfers[BMP280_INIT_TRANSFER_COUNT] =
+{
+    NRF_TWI_MNGR_WRITE(BMP280_ADDR, default_config, sizeof(default_config), 0)
+};
+
+nrf_twi_mngr_transfer_t const bmp280_forced_transfers[BMP280_FORCED_TRANSFER_COUNT] =
+{
+    BMP280_WRITE_FORCED()
+};
+
+static uint16_t calib_u16(uint8_t const * p_raw, uint8_t idx)
+{
+    return (uint16_t)(p_raw[2 * idx] | ((uint16_t)p_raw[2 * idx + 1] << 8));
+}
+
+void bmp280_calib_parse(uint8_t const * p_raw, bmp280_calib_t * p_calib)
+{
+    // Little endian words in the order of the struct.
+    p_calib->dig_T1 = calib_u16(p_raw, 0);
+    p_calib->dig_T2 = (int16_t)calib_u16(p_raw, 1);
+    p_calib->dig_T3 = (int16_t)calib_u16(p_raw, 2);
+    p_calib->dig_P1 = calib_u16(p_raw, 3);
+    p_calib->dig_P2 = (int16_t)calib_u16(p_raw, 4);
+    p_calib->dig_P3 = (int16_t)calib_u16(p_raw, 5);
+    p_calib->dig_P4 = (int16_t)calib_u16(p_raw, 6);
+    p_calib->dig_P5 = (int16_t)calib_u16(p_raw, 7);
+    p_calib->dig_P6 = (int16_t)calib_u16(p_raw, 8);
+    p_calib->dig_P7 = (int16_t)calib_u16(p_raw, 9);
+    p_calib->dig_P8 = (int16_t)calib_u16(p_raw, 10);
+    p_calib->dig_P9 = (int16_t)calib_u16(p_raw, 11);
+}
+
+int32_t bmp280_compensate_t(bmp280_calib_t const * p_calib, int32_t adc_t, int32_t * p_t_fine)
+{
+    int32_t var1 = ((((adc_t >> 3) - ((int32_t)p_calib->dig_T1 << 1))) *
+                    ((int32_t)p_calib->dig_T2)) >> 11;
+    int32_t var2 = (((((adc_t >> 4) - ((int32_t)p_calib->dig_T1)) *
+                      ((adc_t >> 4) - ((int32_t)p_calib->dig_T1))) >> 12) *
+                    ((int32_t)p_calib->dig_T3)) >> 14;
+
+    *p_t_fine = var1 + var2;
+    return (*p_t_fine * 5 + 128) >> 8;
+}
+
+uint32_t bmp280_compensate_p(bmp280_calib_t const * p_calib, int32_t adc_p, int32_t t_fine)
+{
+    int64_t var1 = ((int64_t)t_fine) - 128000;
+    int64_t var2 = var1 * var1 * (int64_t)p_calib->dig_P6;
+    int64_t p;
+
+    var2 = var2 + ((var1 * (int64_t)p_calib->dig_P5) << 17);
+    var2 = var2 + (((int64_t)p_calib->dig_P4) << 35);
+    var1 = ((var1 * var1 * (int64_t)p_calib->dig_P3) >> 8) +
+           ((var1 * (int64_t)p_calib->dig_P2) << 12);
+    var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)p_calib->dig_P1) >> 33;
+
+    if (var1 == 0)
+    {
+        return 0; // Avoid division by zero
+    }
+
+    p    = 1048576 - adc_p;
+    p    = (((p << 31) - var2) * 3125) / var1;
+    var1 = (((int64_t)p_calib->dig_P9) * (p >> 13) * (p >> 13)) >> 25;
+    var2 = (((int64_t)p_calib->dig_P8) * p) >> 19;
+    p    = ((p + var1 + var2) >> 8) + (((int64_t)p_calib->dig_P7) << 4);
+
+    return (uint32_t)p;
+}
+
+uint32_t bmp280_compensate_p32(bmp280_calib_t const * p_calib, int32_t adc_p, int32_t t_fine)
+{
+    int32_t  var1 = (((int32_t)t_fine) >> 1) - (int32_t)64000;
+    int32_t  var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t)p_calib->dig_P6);
+    uint32_t p;
+
+    var2 = var2 + ((var1 * ((int32_t)p_calib->dig_P5)) << 1);
+    var2 = (var2 >> 2) + (((int32_t)p_calib->dig_P4) << 16);
+    var1 = (((p_calib->dig_P3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) +
+            ((((int32_t)p_calib->dig_P2) * var1) >> 1)) >> 18;
+    var1 = ((((32768 + var1)) * ((int32_t)p_calib->dig_P1)) >> 15);
+
+    if (var1 == 0)
+    {
+        return 0; // Avoid division by zero
+    }
+
+    p = (((uint32_t)(((int32_t)1048576) - adc_p) - (uint32_t)(var2 >> 12))) * 3125;
+    if (p < 0x80000000)
+    {
+        p = (p << 1) / ((uint32_t)var1);
+    }
+    else
+    {
+        p = (p / (uint32_t)var1) * 2;
+    }
+
+    var1 = (((int32_t)p_calib->dig_P9) * ((int32_t)(((p >> 3) * (p >> 3)) >> 13))) >> 12;
+    var2 = (((int32_t)(p >> 2)) * ((int32_t)p_calib->dig_P8)) >> 13;
+    p    = (uint32_t)((int32_t)p + ((var1 + var2 + p_calib->dig_P7) >> 4));
+
+    return p;
+}
@@ -0,0 +1,184 @@
+#ifndef BMP280_H__
+#define BMP280_H__
+
+#include "nrf_twi_mngr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Default BMP280 I2C address (SDO pin tied to GND, 0x77 with SDO high).
+ *  This should be set according to the configuration of the hardware.
+ */
+#ifndef BMP280_ADDR
+#define BMP280_ADDR         0x76
+#endif
+
+/** Register Map. */
+#define BMP280_REG_CALIB    0x88 //Trimming parameters dig_T1..dig_P9, 24 bytes
+#define BMP280_REG_ID       0xD0 //Chip ID
+#define BMP280_REG_RESET    0xE0 //Soft reset
+#define BMP280_REG_STATUS   0xF3 //Conversion and NVM copy status
+#define BMP280_REG_CTRL_MEAS 0xF4 //Oversampling and power mode
+#define BMP280_REG_CONFIG   0xF5 //Standby time and IIR filter
+#define BMP280_REG_PRESS    0xF7 //press_msb..temp_xlsb, 6 bytes
+
+#define BMP280_CHIP_ID      0x58
+#define BMP280_RESET_VALUE  0xB6
+#define BMP280_CALIB_SIZE   24
+#define BMP280_DATA_SIZE    6
+
+#define BMP280_STATUS_MEASURING     0x08
+#define BMP280_STATUS_IM_UPDATE     0x01
+
+/** ctrl_meas fields. */
+#define BMP280_OS_SKIP      0
+#define BMP280_OS_X1        1
+#define BMP280_OS_X2        2
+#define BMP280_OS_X4        3
+#define BMP280_OS_X8        4
+#define BMP280_OS_X16       5
+
+#define BMP280_MODE_SLEEP   0x00
+#define BMP280_MODE_FORCED  0x01
+#define BMP280_MODE_NORMAL  0x03
+#define BMP280_MODE_MASK    0x03
+
+#define BMP280_CTRL_MEAS(osrs_t, osrs_p, mode) \
+    ((uint8_t)(((osrs_t) << 5) | ((osrs_p) << 2) | (mode)))
+
+/** config fields. */
+#define BMP280_T_SB_0_5MS   0
+#define BMP280_T_SB_62_5MS  1
+#define BMP280_T_SB_125MS   2
+#define BMP280_T_SB_250MS   3
+#define BMP280_T_SB_500MS   4
+#define BMP280_T_SB_1000MS  5
+#define BMP280_T_SB_2000MS  6
+#define BMP280_T_SB_4000MS  7
+
+#define BMP280_FILTER_OFF   0
+#define BMP280_FILTER_2     1
+#define BMP280_FILTER_4     2
+#define BMP280_FILTER_8     3
+#define BMP280_FILTER_16    4
+
+#define BMP280_CONFIG(t_sb, filter) ((uint8_t)(((t_sb) << 5) | ((filter) << 2)))
+
+// Oversampling setting to number of samples (0 for skipped).
+#define BMP280_OS_SAMPLES(os)       ((os) == 0 ? 0 : (1u << ((os) - 1)))
+
+// Maximum measurement time in microseconds (datasheet, chapter 3.8.1).
+#define BMP280_MEAS_TIME_MAX_US(osrs_t, osrs_p)                 \
+    (1250 + 2300 * BMP280_OS_SAMPLES(osrs_t) +                  \
+     ((osrs_p) == 0 ? 0 : 2300 * BMP280_OS_SAMPLES(osrs_p) + 575))
+
+// Measurement settings used by bmp280_init_transfers and
+// bmp280_forced_transfers (mode bits are set by the transfers).
+#ifndef BMP280_DEFAULT_OSRS_T
+#define BMP280_DEFAULT_OSRS_T       BMP280_OS_X1
+#endif
+#ifndef BMP280_DEFAULT_OSRS_P
+#define BMP280_DEFAULT_OSRS_P       BMP280_OS_X4
+#endif
+#ifndef BMP280_DEFAULT_MODE
+#define BMP280_DEFAULT_MODE         BMP280_MODE_NORMAL
+#endif
+#ifndef BMP280_DEFAULT_CONFIG
+#define BMP280_DEFAULT_CONFIG       BMP280_CONFIG(BMP280_T_SB_500MS, BMP280_FILTER_OFF)
+#endif
+
+#define BMP280_DEFAULT_MEAS_TIME_US \
+    BMP280_MEAS_TIME_MAX_US(BMP280_DEFAULT_OSRS_T, BMP280_DEFAULT_OSRS_P)
+
+#define BMP280_DEFAULT_MEAS_TIME_MS ((BMP280_DEFAULT_MEAS_TIME_US + 999) / 1000)
+
+// Raw 20-bit ADC values from the burst read buffer (press_msb first).
+#define BMP280_GET_ADC(msb, lsb, xlsb) \
+    ((int32_t)(((uint32_t)(msb) << 12) | ((uint32_t)(lsb) << 4) | ((uint32_t)(xlsb) >> 4)))
+
+#define BMP280_GET_ADC_P(p_buffer) BMP280_GET_ADC((p_buffer)[0], (p_buffer)[1], (p_buffer)[2])
+#define BMP280_GET_ADC_T(p_buffer) BMP280_GET_ADC((p_buffer)[3], (p_buffer)[4], (p_buffer)[5])
+
+extern uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND bmp280_calib_reg_addr ;
+extern uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND bmp280_id_reg_addr    ;
+extern uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND bmp280_status_reg_addr;
+extern uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND bmp280_press_reg_addr ;
+
+#define BMP280_READ(p_reg_addr, p_buffer, byte_cnt) \
+    NRF_TWI_MNGR_WRITE(BMP280_ADDR, p_reg_addr, 1, NRF_TWI_MNGR_NO_STOP), \
+    NRF_TWI_MNGR_READ(BMP280_ADDR, p_buffer,   byte_cnt, 0)
+
+#define BMP280_READ_ID(p_buffer) \
+    BMP280_READ(&bmp280_id_reg_addr, p_buffer, 1)
+
+#define BMP280_READ_STATUS(p_buffer) \
+    BMP280_READ(&bmp280_status_reg_addr, p_buffer, 1)
+
+// Calibration block, read once at start-up.
+#define BMP280_READ_CALIB(p_buffer) \
+    BMP280_READ(&bmp280_calib_reg_addr, p_buffer, BMP280_CALIB_SIZE)
+
+// Pressure and temperature in one 6-byte burst from 0xF7, the sensor
+// guarantees both values come from the same measurement.
+#define BMP280_READ_PRESS_TEMP(p_buffer) \
+    BMP280_READ(&bmp280_press_reg_addr, p_buffer, BMP280_DATA_SIZE)
+
+// Puts the sensor to sleep, writes config and then ctrl_meas with
+// BMP280_DEFAULT_MODE (register/value pairs in one write).
+#define BMP280_INIT_TRANSFER_COUNT 1
+
+extern nrf_twi_mngr_transfer_t const bmp280_init_transfers[BMP280_INIT_TRANSFER_COUNT];
+
+// Starts one measurement in forced mode, the sensor returns to sleep after
+// BMP280_DEFAULT_MEAS_TIME_US. The macro form can be combined with transfers
+// to other devices in one transaction.
+#define BMP280_FORCED_MEASUREMENT_SIZE 2
+
+extern uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND bmp280_forced_measurement[BMP280_FORCED_MEASUREMENT_SIZE];
+
+#define BMP280_WRITE_FORCED() \
+    NRF_TWI_MNGR_WRITE(BMP280_ADDR, bmp280_forced_measurement, BMP280_FORCED_MEASUREMENT_SIZE, 0)
+
+#define BMP280_FORCED_TRANSFER_COUNT 1
+
+extern nrf_twi_mngr_transfer_t const bmp280_forced_transfers[BMP280_FORCED_TRANSFER_COUNT];
+
+/** Trimming parameters, parsed once from the 24-byte calibration block.
+ *  All fields are 16 bit, so the struct has the size of the block.
+ */
+typedef struct
+{
+    uint16_t dig_T1;
+    int16_t  dig_T2;
+    int16_t  dig_T3;
+    uint16_t dig_P1;
+    int16_t  dig_P2;
+    int16_t  dig_P3;
+    int16_t  dig_P4;
+    int16_t  dig_P5;
+    int16_t  dig_P6;
+    int16_t  dig_P7;
+    int16_t  dig_P8;
+    int16_t  dig_P9;
+} bmp280_calib_t;
+
+void bmp280_calib_parse(uint8_t const * p_raw, bmp280_calib_t * p_calib);
+
+/** Integer compensation (datasheet, chapter 8.2). */
+
+// Temperature in 0.01 C. p_t_fine receives the fine temperature needed for
+// the pressure compensation.
+int32_t bmp280_compensate_t(bmp280_calib_t const * p_calib, int32_t adc_t, int32_t * p_t_fine);
+
+// Pressure in Pa as unsigned Q24.8 (64-bit arithmetic), 0 if invalid.
+uint32_t bmp280_compensate_p(bmp280_calib_t const * p_calib, int32_t adc_p, int32_t t_fine);
+
+// Pressure in Pa (32-bit arithmetic, 1 Pa resolution), 0 if invalid.
+uint32_t bmp280_compensate_p32(bmp280_calib_t const * p_calib, int32_t adc_p, int32_t t_fine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BMP280_H__
@@ -0,0 +1,27 @@
+#include "cobs.h"
+
+size_t cobs_encode(uint8_t const * p_src, size_t len, uint8_t * p_dst)
+{
+    uint8_t * p_code = p_dst;   // Where the current block's code byte goes
+    uint8_t * p_out  = p_dst + 1;
+    uint8_t   code   = 1;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        if (p_src[i] != 0)
+        {
+            *p_out++ = p_src[i];
+            code++;
+        }
+
+        if (p_src[i] == 0 || code == 0xFF)
+        {
+            *p_code = code;
+            p_code  = p_out++;
+            code    = 1;
+        }
+    }
+    *p_code = code;
+
+    return (size_t)(p_out - p_dst);
+}
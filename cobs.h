@@ -0,0 +1,25 @@
+#ifndef COBS_H__
+#define COBS_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Consistent Overhead Byte Stuffing.
+ *  The encoded frame contains no zero bytes, so a single 0x00 delimits
+ *  frames on the wire. Overhead is one byte per started 254 bytes.
+ */
+#define COBS_ENCODED_MAX(len)   ((len) + ((len) / 254) + 1)
+
+// Encodes len bytes from p_src into p_dst (at least COBS_ENCODED_MAX(len)
+// bytes long). Returns the encoded length, the delimiter is not appended.
+size_t cobs_encode(uint8_t const * p_src, size_t len, uint8_t * p_dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COBS_H__
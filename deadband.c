@@ -0,0 +1,70 @@
+#include "deadband.h"
+
+void deadband_init(deadband_t * p_deadband, deadband_config_t const * p_config)
+{
+    p_deadband->temp.abs   = p_config->temp_abs;
+    p_deadband->temp.rel   = p_config->temp_rel;
+    p_deadband->temp.last  = 0;
+    p_deadband->hum.abs    = p_config->hum_abs;
+    p_deadband->hum.rel    = p_config->hum_rel;
+    p_deadband->hum.last   = 0;
+    p_deadband->heartbeat  = p_config->heartbeat;
+    p_deadband->held       = 0;
+    p_deadband->primed     = false;
+    p_deadband->reported   = 0;
+    p_deadband->suppressed = 0;
+}
+
+static bool outside(deadband_channel_t const * p_channel, uint16_t value)
+{
+    uint32_t band  = ((uint32_t)p_channel->last * p_channel->rel) >> DEADBAND_REL_FRAC_BITS;
+    uint32_t delta = (value > p_channel->last) ? (uint32_t)(value - p_channel->last)
+                                               : (uint32_t)(p_channel->last - value);
+
+    if (band < p_channel->abs)
+    {
+        band = p_channel->abs;
+    }
+    // [a change of exactly the band is still inside - a band of one step
+    //  would otherwise report every quantization flicker]
+    return (band == 0) ? (delta != 0) : (delta > band);
+}
+
+uint8_t deadband_update(deadband_t * p_deadband, uint16_t temp, uint16_t hum)
+{
+    uint8_t reasons = 0;
+
+    if (!p_deadband->primed)
+    {
+        reasons            = DEADBAND_REPORT_FIRST;
+        p_deadband->primed = true;
+    }
+    else
+    {
+        if (outside(&p_deadband->temp, temp))
+        {
+            reasons |= DEADBAND_REPORT_TEMP;
+        }
+        if (outside(&p_deadband->hum, hum))
+        {
+            reasons |= DEADBAND_REPORT_HUM;
+        }
+        if (p_deadband->heartbeat != 0 && p_deadband->held + 1 >= p_deadband->heartbeat)
+        {
+            reasons |= DEADBAND_REPORT_HEARTBEAT;
+        }
+    }
+
+    if (reasons == 0)
+    {
+        p_deadband->held++;
+        p_deadband->suppressed++;
+        return 0;
+    }
+
+    p_deadband->temp.last = temp;
+    p_deadband->hum.last  = hum;
+    p_deadband->held      = 0;
+    p_deadband->reported++;
+    return reasons;
+}
@@ -0,0 +1,65 @@
+#ifndef DEADBAND_H__
+#define DEADBAND_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Report-on-change filter for the T and RH codes.
+ *  A sample is reported when a channel has moved out of its deadband around
+ *  the code of the last reported sample, or when the last report is
+ *  heartbeat samples back. Every channel has an absolute band in codes and a
+ *  relative one as a fraction of the last reported code; the wider of the
+ *  two applies, so the absolute band is the floor for small codes.
+ *  A band of 0 reports every change of that channel, both bands 0 and a
+ *  heartbeat of 1 report every sample.
+ */
+#define DEADBAND_REL_FRAC_BITS  16  // Relative band = code * rel >> 16
+
+// Why a sample was reported, 0 if it was held back.
+#define DEADBAND_REPORT_FIRST       0x01
+#define DEADBAND_REPORT_TEMP        0x02
+#define DEADBAND_REPORT_HUM         0x04
+#define DEADBAND_REPORT_HEARTBEAT   0x08
+
+typedef struct
+{
+    uint16_t abs;   // Codes
+    uint16_t rel;   // Fraction of the last reported code, DEADBAND_REL_FRAC_BITS
+    uint16_t last;  // Last reported code
+} deadband_channel_t;
+
+typedef struct
+{
+    deadband_channel_t temp;
+    deadband_channel_t hum;
+    uint16_t           heartbeat;   // Samples, 0 for none
+    uint16_t           held;        // Samples held back since the last report
+    bool               primed;
+    uint32_t           reported;
+    uint32_t           suppressed;
+} deadband_t;
+
+typedef struct
+{
+    uint16_t temp_abs;
+    uint16_t temp_rel;
+    uint16_t hum_abs;
+    uint16_t hum_rel;
+    uint16_t heartbeat;
+} deadband_config_t;
+
+void deadband_init(deadband_t * p_deadband, deadband_config_t const * p_config);
+
+// Returns the DEADBAND_REPORT_ reasons, 0 if the sample is to be dropped.
+// A reported sample becomes the new reference of both channels.
+uint8_t deadband_update(deadband_t * p_deadband, uint16_t temp, uint16_t hum);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEADBAND_H__
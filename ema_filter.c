@@ -0,0 +1,29 @@
+#include "ema_filter.h"
+
+void ema_filter_init(ema_filter_t * p_filter)
+{
+    p_filter->acc   = 0;
+    p_filter->shift = 0;
+    p_filter->warm  = 0;
+}
+
+uint16_t ema_filter_update(ema_filter_t * p_filter, uint16_t value)
+{
+    int32_t x = (int32_t)((uint32_t)value << EMA_FILTER_SHIFT);
+
+    if (!p_filter->warm)
+    {
+        p_filter->acc  = (uint32_t)x;
+        p_filter->warm = 1;
+    }
+    else
+    {
+        if (p_filter->shift < EMA_FILTER_SHIFT)
+        {
+            p_filter->shift++;
+        }
+        p_filter->acc += (uint32_t)((x - (int32_t)p_filter->acc) >> p_filter->shift);
+    }
+
+    return (uint16_t)((p_filter->acc + (1u << (EMA_FILTER_SHIFT - 1))) >> EMA_FILTER_SHIFT);
+}
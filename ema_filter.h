@@ -0,0 +1,43 @@
+#ifndef EMA_FILTER_H__
+#define EMA_FILTER_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Fixed-point exponential moving average over raw sensor codes.
+ *  y += (x - y) * alpha with alpha = 2^-EMA_FILTER_SHIFT. The state is the
+ *  16-bit average with EMA_FILTER_SHIFT fraction bits, so an update is a
+ *  subtract, a shift and an add.
+ *
+ *  Warm-up: the n-th sample (n = 1, 2, ...) is weighted with 2^-(n-1) until
+ *  alpha is reached, so the first output equals the first input and there is
+ *  no bias towards the initial zero state.
+ */
+#ifndef EMA_FILTER_SHIFT
+#define EMA_FILTER_SHIFT    4   // alpha = 1/16, comparable to a 31 sample mean
+#endif
+
+#if (EMA_FILTER_SHIFT < 1) || (EMA_FILTER_SHIFT > 15)
+    #error EMA_FILTER_SHIFT has to be within 1..15.
+#endif
+
+typedef struct
+{
+    uint32_t acc;   // Average << EMA_FILTER_SHIFT
+    uint8_t  shift; // Current weight shift, grows to EMA_FILTER_SHIFT
+    uint8_t  warm;  // 0 until the first sample has been seen
+} ema_filter_t;
+
+void ema_filter_init(ema_filter_t * p_filter);
+
+// Adds a value and returns the rounded average.
+uint16_t ema_filter_update(ema_filter_t * p_filter, uint16_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMA_FILTER_H__
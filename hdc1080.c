@@ -1,4 +1,5 @@
 #include "hdc1080.h"
+#include "app_util_platform.h"
 
 uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND hdc1080_config_reg_addr = HDC1080_REG_CONFIG;
 uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND hdc1080_temp_reg_addr   = HDC1080_REG_TEMP;
@@ -10,11 +11,222 @@ uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND hdc1080_dev_reg_addr    = HDC1080_REG_DEV_ID
 // bit 12 = 1 (measure both, Temp and Hum)
 // bit 10 = 00 - Temp 14 bit resolution
 // bit 9:8 = 00 - Humidity 14 bit resolution
-static uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND default_config[] = { HDC1080_REG_CONFIG, 0x10, 0x00 };
+static uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND default_config[] =
+{
+    HDC1080_REG_CONFIG,
+    (uint8_t)(HDC1080_CONFIG_DEFAULT >> 8),
+    (uint8_t)(HDC1080_CONFIG_DEFAULT & 0xFF)
+};
 
 nrf_twi_mngr_transfer_t const hdc1080_init_transfers[HDC1080_INIT_TRANSFER_COUNT] =
 {
     NRF_TWI_MNGR_WRITE(HDC1080_ADDR, default_config, sizeof(default_config), 0)
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// Configuration register shadow
+//
+static uint16_t m_config_shadow = HDC1080_CONFIG_RESET_VALUE;
+static uint16_t m_config_readback;
+static bool     m_config_busy;
+
+static nrf_twi_mngr_callback_t m_config_callback;
+static void *                  m_config_user_data;
+
+// [scheduled transfers refer to these buffers after the API call returns]
+static uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND m_config_write[3] = { HDC1080_REG_CONFIG };
+static uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND m_config_read[2];
+
+static nrf_twi_mngr_transfer_t const m_config_write_transfers[] =
+{
+    NRF_TWI_MNGR_WRITE(HDC1080_ADDR, m_config_write, sizeof(m_config_write), 0)
+};
+
+static nrf_twi_mngr_transfer_t const m_config_read_transfers[] =
+{
+    HDC1080_READ(&hdc1080_config_reg_addr, m_config_read, sizeof(m_config_read))
+};
+
+static void config_done(ret_code_t result)
+{
+    nrf_twi_mngr_callback_t callback = m_config_callback;
+
+    m_config_busy = false;
+    if (callback != NULL)
+    {
+        callback(result, m_config_user_data);
+    }
+}
+
+static void config_write_cb(ret_code_t result, void * p_user_data)
+{
+    if (result == NRF_SUCCESS)
+    {
+        uint16_t written = ((uint16_t)m_config_write[1] << 8) | m_config_write[2];
+
+        m_config_shadow = (written & HDC1080_CONFIG_RST) ? HDC1080_CONFIG_RESET_VALUE
+                                                         : written;
+    }
+    config_done(result);
+}
+
+static void config_init_cb(ret_code_t result, void * p_user_data)
+{
+    if (result == NRF_SUCCESS)
+    {
+        hdc1080_config_shadow_init_done();
+    }
+    config_done(result);
+}
+
+static void config_verify_cb(ret_code_t result, void * p_user_data)
+{
+    if (result == NRF_SUCCESS)
+    {
+        m_config_readback = ((uint16_t)m_config_read[0] << 8) | m_config_read[1];
+
+        // BTST is a status bit driven by the sensor, it is never written.
+        if ((m_config_readback & ~HDC1080_CONFIG_BTST) != m_config_shadow)
+        {
+            result = NRF_ERROR_INVALID_DATA;
+        }
+    }
+    config_done(result);
+}
+
+// Claims the configuration transfer slot.
+// [the sampler starts transfers in timer context, the heater and the
+//  buttons in the main loop - the test and the set must not be split]
+static bool config_claim(void)
+{
+    bool claimed = false;
+
+    CRITICAL_REGION_ENTER();
+    if (!m_config_busy)
+    {
+        m_config_busy = true;
+        claimed       = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return claimed;
+}
+
+// Called with the slot claimed, releases it if the transfer is not scheduled.
+static ret_code_t config_schedule(nrf_twi_mngr_t const * p_nrf_twi_mngr,
+                                  nrf_twi_mngr_transaction_t const * p_transaction,
+                                  nrf_twi_mngr_callback_t callback,
+                                  void * p_user_data)
+{
+    ret_code_t err_code;
+
+    m_config_callback  = callback;
+    m_config_user_data = p_user_data;
+
+    err_code = nrf_twi_mngr_schedule(p_nrf_twi_mngr, p_transaction);
+    if (err_code != NRF_SUCCESS)
+    {
+        m_config_busy = false;
+    }
+    return err_code;
+}
+
+void hdc1080_config_shadow_reset(void)
+{
+    m_config_shadow = HDC1080_CONFIG_RESET_VALUE;
+}
+
+void hdc1080_config_shadow_init_done(void)
+{
+    m_config_shadow = HDC1080_CONFIG_DEFAULT;
+}
+
+uint16_t hdc1080_config_shadow_get(void)
+{
+    return m_config_shadow;
+}
+
+uint16_t hdc1080_config_readback_get(void)
+{
+    return m_config_readback;
+}
+
+ret_code_t hdc1080_init(nrf_twi_mngr_t const * p_nrf_twi_mngr,
+                        nrf_twi_mngr_callback_t callback,
+                        void * p_user_data)
+{
+    // [the sensor state is unknown here, so the write is never skipped]
+    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND transaction =
+    {
+        .callback            = config_init_cb,
+        .p_user_data         = NULL,
+        .p_transfers         = hdc1080_init_transfers,
+        .number_of_transfers = HDC1080_INIT_TRANSFER_COUNT
+    };
+
+    if (!config_claim())
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    return config_schedule(p_nrf_twi_mngr, &transaction, callback, p_user_data);
+}
+
+ret_code_t hdc1080_config_update(nrf_twi_mngr_t const * p_nrf_twi_mngr,
+                                 uint16_t set_mask,
+                                 uint16_t clear_mask,
+                                 nrf_twi_mngr_callback_t callback,
+                                 void * p_user_data)
+{
+    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND transaction =
+    {
+        .callback            = config_write_cb,
+        .p_user_data         = NULL,
+        .p_transfers         = m_config_write_transfers,
+        .number_of_transfers = sizeof(m_config_write_transfers) /
+                               sizeof(m_config_write_transfers[0])
+    };
+
+    if (!config_claim())
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    uint16_t config = (m_config_shadow | set_mask) & ~clear_mask & ~HDC1080_CONFIG_BTST;
+
+    if (config == m_config_shadow)
+    {
+        m_config_busy = false;
+        if (callback != NULL)
+        {
+            callback(NRF_SUCCESS, p_user_data);
+        }
+        return NRF_SUCCESS;
+    }
+
+    m_config_write[1] = (uint8_t)(config >> 8);
+    m_config_write[2] = (uint8_t)(config & 0xFF);
+
+    return config_schedule(p_nrf_twi_mngr, &transaction, callback, p_user_data);
+}
+
+ret_code_t hdc1080_config_verify(nrf_twi_mngr_t const * p_nrf_twi_mngr,
+                                 nrf_twi_mngr_callback_t callback,
+                                 void * p_user_data)
+{
+    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND transaction =
+    {
+        .callback            = config_verify_cb,
+        .p_user_data         = NULL,
+        .p_transfers         = m_config_read_transfers,
+        .number_of_transfers = sizeof(m_config_read_transfers) /
+                               sizeof(m_config_read_transfers[0])
+    };
+
+    if (!config_claim())
+    {
+        return NRF_ERROR_BUSY;
+    }
 
+    return config_schedule(p_nrf_twi_mngr, &transaction, callback, p_user_data);
+}
@@ -23,12 +23,44 @@ extern "C" {
 #define HDC1080_REG_MAN_ID  0xFE //ID of Texas Instruments
 #define HDC1080_REG_DEV_ID  0xFF
 
+#define HDC1080_MANUFACTURER_ID     0x5449
+#define HDC1080_DEVICE_ID           0x1050
+
+// Time from triggering a T and RH conversion until the result can be read
+// (6.35 ms + 6.5 ms at 14 bit resolution, with margin).
+#define HDC1080_CONVERSION_MS       20
+
+// Time from power-up until the sensor accepts transfers.
+#define HDC1080_STARTUP_MS          15
+
+// Datasheet conversion time of T and RH at 14 bit resolution, without
+// margin. Until the conversion is done the sensor NACKs reads of its data.
+#define HDC1080_CONVERSION_TYP_US   12850
+
+/** Configuration register (0x02) fields. */
+#define HDC1080_CONFIG_RST          0x8000 //Software reset, self clearing
+#define HDC1080_CONFIG_HEAT         0x2000 //Heater enabled
+#define HDC1080_CONFIG_MODE         0x1000 //T and RH acquired in sequence
+#define HDC1080_CONFIG_BTST         0x0800 //Battery voltage < 2.8V (read only)
+#define HDC1080_CONFIG_TRES_11BIT   0x0400 //Temperature resolution 11 bit
+#define HDC1080_CONFIG_HRES_11BIT   0x0100 //Humidity resolution 11 bit
+#define HDC1080_CONFIG_HRES_8BIT    0x0200 //Humidity resolution 8 bit
+#define HDC1080_CONFIG_TRES_MASK    0x0400
+#define HDC1080_CONFIG_HRES_MASK    0x0300
+
+#define HDC1080_CONFIG_RESET_VALUE  0x1000 //After power-up and soft reset
+#define HDC1080_CONFIG_DEFAULT      HDC1080_CONFIG_MODE //Sent by hdc1080_init_transfers
+
 #define HDC1080_GET_TEMP_VALUE(temp_hi, temp_lo) \
     ((((((int16_t)temp_hi << 8) | temp_lo)) / pow(2.0f, 16.0f)) * 165.0f - 40.0f)
 
 #define HDC1080_GET_HUM_VALUE(hum_hi, hum_lo) \
     ((((((int16_t)hum_hi << 8) | hum_lo)) / pow(2.0f, 16.0f)) * 100.0f)
 
+// Conversion of 16-bit raw register codes.
+#define HDC1080_TEMP_FROM_RAW(raw)  ((float)(raw) * (165.0f / 65536.0f) - 40.0f)
+#define HDC1080_HUM_FROM_RAW(raw)   ((float)(raw) * (100.0f / 65536.0f))
+
 extern uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND hdc1080_config_reg_addr ;
 extern uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND hdc1080_temp_reg_addr   ;
 extern uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND hdc1080_hum_reg_addr    ;
@@ -62,6 +94,47 @@ extern uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND hdc1080_dev_reg_addr    ;
 
 extern nrf_twi_mngr_transfer_t const hdc1080_init_transfers[HDC1080_INIT_TRANSFER_COUNT];
 
+/** Configuration register shadow.
+ *  The driver keeps a RAM copy of HDC1080_REG_CONFIG so that a change of
+ *  heater, resolution or acquisition mode costs a single 3-byte write
+ *  instead of a read-modify-write over the bus.
+ */
+
+// Sets the shadow to the power-up value. Call after power-up of the sensor.
+void hdc1080_config_shadow_reset(void);
+
+// Sets the shadow to HDC1080_CONFIG_DEFAULT. Call after hdc1080_init_transfers
+// have been performed successfully outside of hdc1080_init().
+void hdc1080_config_shadow_init_done(void);
+
+uint16_t hdc1080_config_shadow_get(void);
+
+// Schedules hdc1080_init_transfers, the shadow follows on success.
+ret_code_t hdc1080_init(nrf_twi_mngr_t const * p_nrf_twi_mngr,
+                        nrf_twi_mngr_callback_t callback,
+                        void * p_user_data);
+
+// Writes (shadow | set_mask) & ~clear_mask to the configuration register.
+// The shadow is updated once the write has completed successfully. When the
+// value would not change, no transfer is made and the callback is called
+// right away. Only one update may be pending at a time (NRF_ERROR_BUSY).
+// Setting HDC1080_CONFIG_RST performs a soft reset, after which the shadow
+// returns to HDC1080_CONFIG_RESET_VALUE.
+ret_code_t hdc1080_config_update(nrf_twi_mngr_t const * p_nrf_twi_mngr,
+                                 uint16_t set_mask,
+                                 uint16_t clear_mask,
+                                 nrf_twi_mngr_callback_t callback,
+                                 void * p_user_data);
+
+// Reads the configuration register back and compares it with the shadow
+// (debugging aid). The callback gets NRF_ERROR_INVALID_DATA on mismatch.
+ret_code_t hdc1080_config_verify(nrf_twi_mngr_t const * p_nrf_twi_mngr,
+                                 nrf_twi_mngr_callback_t callback,
+                                 void * p_user_data);
+
+// Value read by the last hdc1080_config_verify().
+uint16_t hdc1080_config_readback_get(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,131 @@
+#include "hdc1080_dump.h"
+#include "hdc1080.h"
+#include "app_timer.h"
+#include "app_error.h"
+
+static nrf_twi_mngr_t const *  mp_nrf_twi_mngr;
+static uint32_t                m_bus_frequency_hz;
+static hdc1080_dump_callback_t m_callback;
+static hdc1080_dump_t          m_dump;
+static bool                    m_ids_cached;
+
+// Config: 0-1, manufacturer ID: 2-3, device ID: 4-5.
+static uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND m_dump_buffer[6];
+
+// First dump - the ID registers are read once.
+static nrf_twi_mngr_transfer_t const m_first_transfers[] =
+{
+    HDC1080_READ(&hdc1080_man_reg_addr,    &m_dump_buffer[2], 2),
+    HDC1080_READ(&hdc1080_dev_reg_addr,    &m_dump_buffer[4], 2),
+    HDC1080_READ(&hdc1080_config_reg_addr, &m_dump_buffer[0], 2)
+};
+
+// [the tail of the first dump list without the ID reads]
+static nrf_twi_mngr_transfer_t const * const mp_cached_transfers = &m_first_transfers[4];
+#define CACHED_TRANSFER_COUNT   2
+
+static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND m_dump_transaction;
+
+static uint16_t buffer_word(uint8_t idx)
+{
+    return ((uint16_t)m_dump_buffer[idx] << 8) | m_dump_buffer[idx + 1];
+}
+
+static void dump_cb(ret_code_t result, void * p_user_data)
+{
+    hdc1080_dump_callback_t callback = m_callback;
+    uint8_t                 count    = m_dump_transaction.number_of_transfers;
+
+    m_dump.transfers     = count;
+    m_dump.bus_bytes     = hdc1080_dump_bus_bytes(m_dump_transaction.p_transfers, count);
+    m_dump.bus_time_us   = hdc1080_dump_bus_time_us(m_dump_transaction.p_transfers, count);
+    m_dump.elapsed_ticks = app_timer_cnt_diff_compute(app_timer_cnt_get(),
+                                                      m_dump.elapsed_ticks);
+
+    if (result == NRF_SUCCESS)
+    {
+        if (!m_ids_cached)
+        {
+            m_dump.manufacturer_id = buffer_word(2);
+            m_dump.device_id       = buffer_word(4);
+            m_ids_cached           = true;
+        }
+        m_dump.config = buffer_word(0);
+    }
+
+    m_callback = NULL;
+    callback(result, &m_dump);
+}
+
+uint16_t hdc1080_dump_bus_bytes(nrf_twi_mngr_transfer_t const * p_transfers,
+                                uint8_t number_of_transfers)
+{
+    uint16_t bytes = 0;
+
+    for (uint8_t i = 0; i < number_of_transfers; i++)
+    {
+        bytes += 1 + p_transfers[i].length; // address byte + data
+    }
+    return bytes;
+}
+
+uint32_t hdc1080_dump_bus_time_us(nrf_twi_mngr_transfer_t const * p_transfers,
+                                  uint8_t number_of_transfers)
+{
+    // 9 clocks per byte (8 data + ACK) and one per (repeated) START / STOP.
+    uint32_t clocks = 9 * hdc1080_dump_bus_bytes(p_transfers, number_of_transfers);
+
+    for (uint8_t i = 0; i < number_of_transfers; i++)
+    {
+        clocks += (p_transfers[i].flags & NRF_TWI_MNGR_NO_STOP) ? 1 : 2;
+    }
+    return (uint32_t)(((uint64_t)clocks * 1000000 + m_bus_frequency_hz - 1) /
+                      m_bus_frequency_hz);
+}
+
+ret_code_t hdc1080_dump_init(nrf_twi_mngr_t const * p_nrf_twi_mngr,
+                             uint32_t bus_frequency_hz)
+{
+    mp_nrf_twi_mngr    = p_nrf_twi_mngr;
+    m_bus_frequency_hz = bus_frequency_hz;
+
+    m_dump_transaction.callback    = dump_cb;
+    m_dump_transaction.p_user_data = NULL;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t hdc1080_dump_start(uint16_t temp_raw, uint16_t hum_raw,
+                              hdc1080_dump_callback_t callback)
+{
+    ret_code_t err_code;
+
+    if (m_callback != NULL)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    if (m_ids_cached)
+    {
+        m_dump_transaction.p_transfers         = mp_cached_transfers;
+        m_dump_transaction.number_of_transfers = CACHED_TRANSFER_COUNT;
+    }
+    else
+    {
+        m_dump_transaction.p_transfers         = m_first_transfers;
+        m_dump_transaction.number_of_transfers =
+            sizeof(m_first_transfers) / sizeof(m_first_transfers[0]);
+    }
+
+    m_callback           = callback;
+    m_dump.temp_raw      = temp_raw;
+    m_dump.hum_raw       = hum_raw;
+    m_dump.elapsed_ticks = app_timer_cnt_get();
+
+    err_code = nrf_twi_mngr_schedule(mp_nrf_twi_mngr, &m_dump_transaction);
+    if (err_code != NRF_SUCCESS)
+    {
+        m_callback = NULL;
+    }
+    return err_code;
+}
@@ -0,0 +1,51 @@
+#ifndef HDC1080_DUMP_H__
+#define HDC1080_DUMP_H__
+
+#include "nrf_twi_mngr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Register dump with the least bus traffic.
+ *  Only the configuration register is read, the ID registers on the first
+ *  dump only and served from a cache afterwards. T and RH are the codes of
+ *  the last sample, passed in - reading them would take a pointer write of
+ *  the dump's own, which triggers a conversion next to the sampling.
+ */
+typedef struct
+{
+    uint16_t config;
+    uint16_t temp_raw;
+    uint16_t hum_raw;
+    uint16_t manufacturer_id;
+    uint16_t device_id;
+    uint8_t  transfers;     // Number of transfers made by this dump
+    uint16_t bus_bytes;     // Bytes on the bus, address bytes included
+    uint32_t bus_time_us;   // Time the bus was busy at the given frequency
+    uint32_t elapsed_ticks; // app_timer ticks from start to completion
+} hdc1080_dump_t;
+
+typedef void (* hdc1080_dump_callback_t)(ret_code_t result,
+                                         hdc1080_dump_t const * p_dump);
+
+// bus_frequency_hz is used for the bus time figure only (e.g. 100000).
+ret_code_t hdc1080_dump_init(nrf_twi_mngr_t const * p_nrf_twi_mngr,
+                             uint32_t bus_frequency_hz);
+
+// temp_raw and hum_raw are reported as they are. Returns NRF_ERROR_BUSY if
+// a dump is in progress.
+ret_code_t hdc1080_dump_start(uint16_t temp_raw, uint16_t hum_raw,
+                              hdc1080_dump_callback_t callback);
+
+// Bus bytes (address bytes included) and time of a transfer list.
+uint16_t hdc1080_dump_bus_bytes(nrf_twi_mngr_transfer_t const * p_transfers,
+                                uint8_t number_of_transfers);
+uint32_t hdc1080_dump_bus_time_us(nrf_twi_mngr_transfer_t const * p_transfers,
+                                  uint8_t number_of_transfers);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HDC1080_DUMP_H__
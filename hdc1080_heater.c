@@ -0,0 +1,222 @@
+#include "hdc1080_heater.h"
+#include "hdc1080.h"
+#include "app_timer.h"
+#include "app_error.h"
+#include "nrf_log.h"
+#include "task_timer.h"
+
+typedef enum
+{
+    HEATER_IDLE,
+    HEATER_ENABLING,  // Waiting for the heater bit to be written
+    HEATER_TRIGGER,   // Waiting for a conversion to be triggered
+    HEATER_CONVERT,   // Waiting for the conversion to complete
+    HEATER_READ,      // Waiting for the conversion result to be read
+    HEATER_DISABLING, // Waiting for the heater bit to be cleared
+    HEATER_COOLDOWN
+} heater_state_t;
+
+APP_TIMER_DEF(m_heater_timer);
+static task_timer_t m_heater_task;      // Conversion steps and retries
+static task_timer_t m_cooldown_task;
+static bool         m_task_timer;       // The tasks instead of m_heater_timer
+
+static nrf_twi_mngr_t const * mp_nrf_twi_mngr;
+static heater_state_t         m_state = HEATER_IDLE;
+static uint16_t               m_conversions_left;
+
+// [the result is discarded, the conversions only heat the die]
+static uint8_t NRF_TWI_MNGR_BUFFER_LOC_IND m_heater_buffer[4];
+
+static void heater_step(void);
+
+static void heater_timer_start(task_timer_t * p_task, uint32_t ticks)
+{
+    if (m_task_timer)
+    {
+        APP_ERROR_CHECK(task_timer_start(p_task, ticks, 0, NULL));
+    }
+    else
+    {
+        APP_ERROR_CHECK(app_timer_start(m_heater_timer, ticks, NULL));
+    }
+}
+
+static void heater_retry(void)
+{
+    heater_timer_start(&m_heater_task, APP_TIMER_TICKS(HDC1080_HEATER_CONVERSION_MS));
+}
+
+static void heater_transfer_cb(ret_code_t result, void * p_user_data)
+{
+    // Errors are not fatal here; a regular sample triggered in between may
+    // have restarted the conversion and caused a NACK on our read.
+    if (result != NRF_SUCCESS)
+    {
+        NRF_LOG_DEBUG("heater state %d - error: %d", m_state, (int)result);
+    }
+
+    switch (m_state)
+    {
+    case HEATER_ENABLING:
+        if (result != NRF_SUCCESS)
+        {
+            // Retry, the heater bit has not been set yet.
+            heater_retry();
+            return;
+        }
+        m_state = HEATER_TRIGGER;
+        break;
+
+    case HEATER_TRIGGER:
+        m_state = HEATER_CONVERT;
+        heater_retry();
+        return;
+
+    case HEATER_READ:
+        if (--m_conversions_left == 0)
+        {
+            m_state = HEATER_DISABLING;
+        }
+        else
+        {
+            m_state = HEATER_TRIGGER;
+        }
+        break;
+
+    case HEATER_DISABLING:
+        if (result != NRF_SUCCESS)
+        {
+            heater_retry();
+            return;
+        }
+        m_state = HEATER_COOLDOWN;
+        heater_timer_start(&m_cooldown_task, APP_TIMER_TICKS(HDC1080_HEATER_COOLDOWN_MS));
+        return;
+
+    default:
+        return;
+    }
+
+    heater_step();
+}
+
+static void heater_step(void)
+{
+    static nrf_twi_mngr_transfer_t const trigger_transfers[] =
+    {
+        HDC1080_WRITE_T_AND_HR(&hdc1080_temp_reg_addr)
+    };
+    static nrf_twi_mngr_transfer_t const read_transfers[] =
+    {
+        HDC1080_READ_T_AND_HR(m_heater_buffer)
+    };
+    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND trigger =
+    {
+        .callback            = heater_transfer_cb,
+        .p_user_data         = NULL,
+        .p_transfers         = trigger_transfers,
+        .number_of_transfers = sizeof(trigger_transfers) / sizeof(trigger_transfers[0])
+    };
+    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND read =
+    {
+        .callback            = heater_transfer_cb,
+        .p_user_data         = NULL,
+        .p_transfers         = read_transfers,
+        .number_of_transfers = sizeof(read_transfers) / sizeof(read_transfers[0])
+    };
+
+    ret_code_t err_code;
+
+    switch (m_state)
+    {
+    case HEATER_ENABLING:
+        err_code = hdc1080_config_update(mp_nrf_twi_mngr, HDC1080_CONFIG_HEAT, 0,
+                                         heater_transfer_cb, NULL);
+        break;
+
+    case HEATER_TRIGGER:
+        err_code = nrf_twi_mngr_schedule(mp_nrf_twi_mngr, &trigger);
+        break;
+
+    case HEATER_READ:
+        err_code = nrf_twi_mngr_schedule(mp_nrf_twi_mngr, &read);
+        break;
+
+    case HEATER_DISABLING:
+        err_code = hdc1080_config_update(mp_nrf_twi_mngr, 0, HDC1080_CONFIG_HEAT,
+                                         heater_transfer_cb, NULL);
+        break;
+
+    default:
+        return;
+    }
+
+    // Queue full or configuration write pending - try again later.
+    if (err_code != NRF_SUCCESS)
+    {
+        heater_retry();
+    }
+}
+
+static void heater_timer_handler(void * p_context)
+{
+    switch (m_state)
+    {
+    case HEATER_CONVERT:
+        m_state = HEATER_READ;
+        break;
+
+    case HEATER_COOLDOWN:
+        m_state = HEATER_IDLE;
+        NRF_LOG_INFO("heater cycle finished");
+        return;
+
+    default:
+        // Retry of the current state.
+        break;
+    }
+
+    heater_step();
+}
+
+ret_code_t hdc1080_heater_init(nrf_twi_mngr_t const * p_nrf_twi_mngr, bool task_timer)
+{
+    mp_nrf_twi_mngr = p_nrf_twi_mngr;
+    m_task_timer    = task_timer;
+
+    if (task_timer)
+    {
+        task_timer_create(&m_heater_task, heater_timer_handler, 0);
+        task_timer_create(&m_cooldown_task, heater_timer_handler,
+                          APP_TIMER_TICKS(HDC1080_HEATER_COOLDOWN_TOLERANCE_MS));
+        return NRF_SUCCESS;
+    }
+    return app_timer_create(&m_heater_timer, APP_TIMER_MODE_SINGLE_SHOT,
+                            heater_timer_handler);
+}
+
+ret_code_t hdc1080_heater_start(uint16_t conversions)
+{
+    if (m_state != HEATER_IDLE)
+    {
+        return NRF_ERROR_BUSY;
+    }
+    if (conversions == 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    NRF_LOG_INFO("heater cycle started, %d conversions", conversions);
+
+    m_conversions_left = conversions;
+    m_state            = HEATER_ENABLING;
+    heater_step();
+
+    return NRF_SUCCESS;
+}
+
+bool hdc1080_heater_is_active(void)
+{
+    return m_state != HEATER_IDLE;
+}
@@ -0,0 +1,52 @@
+#ifndef HDC1080_HEATER_H__
+#define HDC1080_HEATER_H__
+
+#include "nrf_twi_mngr.h"
+#include "hdc1080.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Heater controller for condensation recovery.
+ *  Sets the heater bit in the configuration register, runs a burst of
+ *  back-to-back conversions to heat the die and restores normal mode.
+ *  Every step is a scheduled TWI transaction or a timeout - on its own
+ *  app_timer or as a task of the shared one (task_timer.h) - so regular
+ *  sampling keeps going on the same TWI manager in the meantime.
+ */
+
+// Time allowed for one heater conversion.
+#ifndef HDC1080_HEATER_CONVERSION_MS
+#define HDC1080_HEATER_CONVERSION_MS    HDC1080_CONVERSION_MS
+#endif
+
+// The die stays warm for a while after the heater is switched off, samples
+// are still reported as heater affected during this time.
+#ifndef HDC1080_HEATER_COOLDOWN_MS
+#define HDC1080_HEATER_COOLDOWN_MS      2000
+#endif
+
+// How late the end of the cool-down may be as a task of the shared
+// app_timer - it only flags a few more samples. The conversion steps run
+// on time, waiting longer between them would heat the die less.
+#ifndef HDC1080_HEATER_COOLDOWN_TOLERANCE_MS
+#define HDC1080_HEATER_COOLDOWN_TOLERANCE_MS    (HDC1080_HEATER_COOLDOWN_MS / 4)
+#endif
+
+// Timeouts on task_timer.h if task_timer is set, task_timer_init() has to
+// be done then. Otherwise the heater creates its own app_timer.
+ret_code_t hdc1080_heater_init(nrf_twi_mngr_t const * p_nrf_twi_mngr, bool task_timer);
+
+// Starts a heater cycle of the given number of conversions.
+// Returns NRF_ERROR_BUSY if a cycle is already running.
+ret_code_t hdc1080_heater_start(uint16_t conversions);
+
+// True from the start of a cycle until the cool-down has expired.
+bool hdc1080_heater_is_active(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HDC1080_HEATER_H__
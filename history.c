@@ -0,0 +1,243 @@
+#include <string.h>
+#include "history.h"
+#include "app_util.h"
+
+STATIC_ASSERT(sizeof(history_t) <= HISTORY_RAM_BUDGET, "History exceeds its RAM budget");
+
+#define MINUTES_PER_HOUR    60
+#define MS_PER_MINUTE       60000u
+
+static void acc_reset(history_acc_t * p_acc)
+{
+    memset(p_acc, 0, sizeof(*p_acc));
+    p_acc->temp_min = UINT16_MAX;
+    p_acc->hum_min  = UINT16_MAX;
+}
+
+static void acc_sample(history_acc_t * p_acc, uint16_t temp_raw, uint16_t hum_raw)
+{
+    p_acc->temp_sum += temp_raw;
+    p_acc->hum_sum  += hum_raw;
+    p_acc->count++;
+    p_acc->temp_min = MIN(p_acc->temp_min, temp_raw);
+    p_acc->temp_max = MAX(p_acc->temp_max, temp_raw);
+    p_acc->hum_min  = MIN(p_acc->hum_min, hum_raw);
+    p_acc->hum_max  = MAX(p_acc->hum_max, hum_raw);
+}
+
+// Folds a finished minute into the running hour.
+static void acc_merge(history_acc_t * p_dst, history_acc_t const * p_src)
+{
+    p_dst->temp_sum += p_src->temp_sum;
+    p_dst->hum_sum  += p_src->hum_sum;
+    p_dst->count    += p_src->count;
+    p_dst->temp_min = MIN(p_dst->temp_min, p_src->temp_min);
+    p_dst->temp_max = MAX(p_dst->temp_max, p_src->temp_max);
+    p_dst->hum_min  = MIN(p_dst->hum_min, p_src->hum_min);
+    p_dst->hum_max  = MAX(p_dst->hum_max, p_src->hum_max);
+}
+
+static void acc_to_agg(history_acc_t const * p_acc, history_agg_t * p_agg)
+{
+    if (p_acc->count == 0)
+    {
+        memset(p_agg, 0, sizeof(*p_agg));
+        return;
+    }
+    p_agg->temp_min  = p_acc->temp_min;
+    p_agg->temp_max  = p_acc->temp_max;
+    p_agg->temp_mean = (uint16_t)ROUNDED_DIV(p_acc->temp_sum, p_acc->count);
+    p_agg->hum_min   = p_acc->hum_min;
+    p_agg->hum_max   = p_acc->hum_max;
+    p_agg->hum_mean  = (uint16_t)ROUNDED_DIV(p_acc->hum_sum, p_acc->count);
+    p_agg->count     = (uint16_t)MIN(p_acc->count, UINT16_MAX);
+}
+
+// Newest entry at age 0.
+static uint32_t ring_index(uint32_t head, uint32_t age, uint32_t size)
+{
+    return (head + size - 1 - age) % size;
+}
+
+typedef struct
+{
+    int64_t n;
+    int64_t sum_x;
+    int64_t sum_xx;
+    int64_t sum_y[2];   // T, RH
+    int64_t sum_xy[2];
+} fit_t;
+
+// Least squares slope of y over x, per unit of x, rounded.
+static int32_t slope(fit_t const * p_fit, int channel)
+{
+    int64_t den = p_fit->n * p_fit->sum_xx - p_fit->sum_x * p_fit->sum_x;
+    int64_t num = p_fit->n * p_fit->sum_xy[channel] - p_fit->sum_x * p_fit->sum_y[channel];
+
+    if (den == 0)
+    {
+        return 0;
+    }
+    return (int32_t)((num >= 0) ? (num + den / 2) / den : -((-num + den / 2) / den));
+}
+
+// Range, mean and slope over the stored hours and the running one.
+static void trend_update(history_t * p_history)
+{
+    history_acc_t   total;
+    history_agg_t   hour;
+    history_trend_t trend;
+    fit_t           fit;
+    uint8_t         stored = MIN(p_history->hour_count, HISTORY_HOURS - 1);
+
+    acc_reset(&total);
+    memset(&fit, 0, sizeof(fit));
+
+    // Oldest first, so x grows with time.
+    for (int age = stored - 1; age >= -1; age--)
+    {
+        if (age >= 0)
+        {
+            hour = p_history->hours[ring_index(p_history->hour_head, (uint32_t)age,
+                                               HISTORY_HOURS)];
+            if (hour.count == 0)
+            {
+                continue;
+            }
+            total.temp_sum += (uint64_t)hour.temp_mean * hour.count;
+            total.hum_sum  += (uint64_t)hour.hum_mean * hour.count;
+            total.count    += hour.count;
+            total.temp_min  = MIN(total.temp_min, hour.temp_min);
+            total.temp_max  = MAX(total.temp_max, hour.temp_max);
+            total.hum_min   = MIN(total.hum_min, hour.hum_min);
+            total.hum_max   = MAX(total.hum_max, hour.hum_max);
+        }
+        else
+        {
+            if (p_history->hour.count == 0)
+            {
+                continue;
+            }
+            acc_to_agg(&p_history->hour, &hour);
+            acc_merge(&total, &p_history->hour);
+        }
+
+        // [x is the hour's position in the window - hours without data are
+        //  left out of the fit, not taken as zero]
+        int64_t x = (int64_t)stored - 1 - age;
+
+        fit.n++;
+        fit.sum_x     += x;
+        fit.sum_xx    += x * x;
+        fit.sum_y[0]  += hour.temp_mean;
+        fit.sum_xy[0] += x * hour.temp_mean;
+        fit.sum_y[1]  += hour.hum_mean;
+        fit.sum_xy[1] += x * hour.hum_mean;
+    }
+
+    acc_to_agg(&total, &trend.range);
+    trend.hours      = (uint8_t)fit.n;
+    trend.temp_slope = slope(&fit, 0);
+    trend.hum_slope  = slope(&fit, 1);
+    p_history->trend = trend;
+}
+
+static uint8_t minute_end(history_t * p_history)
+{
+    uint8_t rolled = HISTORY_ROLL_MINUTE;
+
+    acc_to_agg(&p_history->minute, &p_history->minutes[p_history->minute_head]);
+    p_history->minute_head  = (uint8_t)((p_history->minute_head + 1) % HISTORY_MINUTES);
+    p_history->minute_count = (uint8_t)MIN(p_history->minute_count + 1, HISTORY_MINUTES);
+    acc_merge(&p_history->hour, &p_history->minute);
+    acc_reset(&p_history->minute);
+
+    if (++p_history->hour.slots >= MINUTES_PER_HOUR)
+    {
+        acc_to_agg(&p_history->hour, &p_history->hours[p_history->hour_head]);
+        p_history->hour_head  = (uint8_t)((p_history->hour_head + 1) % HISTORY_HOURS);
+        p_history->hour_count = (uint8_t)MIN(p_history->hour_count + 1, HISTORY_HOURS);
+        acc_reset(&p_history->hour);
+        rolled |= HISTORY_ROLL_HOUR;
+    }
+    return rolled;
+}
+
+static uint8_t slot_end(history_t * p_history)
+{
+    uint8_t rolled = 0;
+
+    // [periods that do not divide a minute carry the remainder over, so
+    //  minutes hold one sample more or less but stay aligned with time]
+    p_history->minute_ms += p_history->period_ms;
+    while (p_history->minute_ms >= MS_PER_MINUTE)
+    {
+        p_history->minute_ms -= MS_PER_MINUTE;
+        rolled |= minute_end(p_history);
+    }
+
+    if (rolled != 0)
+    {
+        trend_update(p_history);
+    }
+    return rolled;
+}
+
+void history_init(history_t * p_history, uint32_t period_ms)
+{
+    memset(p_history, 0, sizeof(*p_history));
+    acc_reset(&p_history->minute);
+    acc_reset(&p_history->hour);
+    p_history->period_ms = MAX(period_ms, 1);
+}
+
+uint8_t history_add(history_t * p_history, uint16_t temp_raw, uint16_t hum_raw)
+{
+    p_history->raw[p_history->raw_head].temp_raw = temp_raw;
+    p_history->raw[p_history->raw_head].hum_raw  = hum_raw;
+    p_history->raw_head  = (uint16_t)((p_history->raw_head + 1) % HISTORY_RAW_SAMPLES);
+    p_history->raw_count = (uint16_t)MIN(p_history->raw_count + 1, HISTORY_RAW_SAMPLES);
+
+    acc_sample(&p_history->minute, temp_raw, hum_raw);
+    return slot_end(p_history);
+}
+
+uint8_t history_skip(history_t * p_history)
+{
+    return slot_end(p_history);
+}
+
+bool history_raw_get(history_t const * p_history, uint16_t age, history_raw_t * p_raw)
+{
+    if (age >= p_history->raw_count)
+    {
+        return false;
+    }
+    *p_raw = p_history->raw[ring_index(p_history->raw_head, age, HISTORY_RAW_SAMPLES)];
+    return true;
+}
+
+bool history_minute_get(history_t const * p_history, uint8_t age, history_agg_t * p_agg)
+{
+    if (age >= p_history->minute_count)
+    {
+        return false;
+    }
+    *p_agg = p_history->minutes[ring_index(p_history->minute_head, age, HISTORY_MINUTES)];
+    return true;
+}
+
+bool history_hour_get(history_t const * p_history, uint8_t age, history_agg_t * p_agg)
+{
+    if (age >= p_history->hour_count)
+    {
+        return false;
+    }
+    *p_agg = p_history->hours[ring_index(p_history->hour_head, age, HISTORY_HOURS)];
+    return true;
+}
+
+void history_trend_get(history_t const * p_history, history_trend_t * p_trend)
+{
+    *p_trend = p_history->trend;
+}
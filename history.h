@@ -0,0 +1,122 @@
+#ifndef HISTORY_H__
+#define HISTORY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** On-device T/RH history in three tiers of ring buffers:
+ *    raw      the last HISTORY_RAW_SAMPLES codes
+ *    minutes  min/max/mean per minute for the last HISTORY_MINUTES minutes
+ *    hours    the same per hour for the last HISTORY_HOURS hours
+ *  Each minute is rolled into the minute ring and folded into the running
+ *  hour, each hour into the hour ring. Every sample slot is period_ms long
+ *  (history_init()) and the tiers roll by the time elapsed: a slot ending
+ *  past several minutes rolls all of them, those without a sample empty
+ *  (count 0). Slots without data (heater, read error) are passed with
+ *  history_skip() so the tiers stay aligned with time.
+ *
+ *  The 24 h trend (range, mean and slope over the last HISTORY_HOURS hours,
+ *  the running one included) is brought up to date at every minute roll,
+ *  so history_trend_get() is a copy. Everything lives in history_t, which
+ *  has to fit HISTORY_RAM_BUDGET.
+ */
+#ifndef HISTORY_RAW_SAMPLES
+#define HISTORY_RAW_SAMPLES     120
+#endif
+#ifndef HISTORY_MINUTES
+#define HISTORY_MINUTES         60
+#endif
+#ifndef HISTORY_HOURS
+#define HISTORY_HOURS           24
+#endif
+#ifndef HISTORY_RAM_BUDGET
+#define HISTORY_RAM_BUDGET      2048
+#endif
+
+#if (HISTORY_MINUTES > 255) || (HISTORY_HOURS > 255) || (HISTORY_RAW_SAMPLES > 65535)
+    #error History tier too long.
+#endif
+
+// history_add()/history_skip() results.
+#define HISTORY_ROLL_MINUTE     0x01
+#define HISTORY_ROLL_HOUR       0x02
+
+typedef struct
+{
+    uint16_t temp_raw;
+    uint16_t hum_raw;
+} history_raw_t;
+
+typedef struct
+{
+    uint16_t temp_min;
+    uint16_t temp_max;
+    uint16_t temp_mean;
+    uint16_t hum_min;
+    uint16_t hum_max;
+    uint16_t hum_mean;
+    uint16_t count;     // Samples with data
+} history_agg_t;
+
+typedef struct
+{
+    uint64_t temp_sum;
+    uint64_t hum_sum;
+    uint32_t count;
+    uint16_t temp_min;
+    uint16_t temp_max;
+    uint16_t hum_min;
+    uint16_t hum_max;
+    uint16_t slots;     // Minutes so far (running hour)
+} history_acc_t;
+
+typedef struct
+{
+    uint8_t       hours;        // Hours covered, the running one included
+    history_agg_t range;        // count saturates at UINT16_MAX
+    int32_t       temp_slope;   // Codes per hour, least squares fit of the
+    int32_t       hum_slope;    // hourly means
+} history_trend_t;
+
+typedef struct
+{
+    history_raw_t   raw[HISTORY_RAW_SAMPLES];
+    history_agg_t   minutes[HISTORY_MINUTES];
+    history_agg_t   hours[HISTORY_HOURS];
+    history_acc_t   minute;     // Running minute
+    history_acc_t   hour;       // Running hour
+    history_trend_t trend;
+    uint16_t        raw_head;   // Next entry to write
+    uint16_t        raw_count;
+    uint8_t         minute_head;
+    uint8_t         minute_count;
+    uint8_t         hour_head;
+    uint8_t         hour_count;
+    uint32_t        period_ms;  // Per sample slot
+    uint32_t        minute_ms;  // Elapsed in the running minute
+} history_t;
+
+void history_init(history_t * p_history, uint32_t period_ms);
+
+// Adds a sample, returns HISTORY_ROLL_* for the tiers rolled over.
+uint8_t history_add(history_t * p_history, uint16_t temp_raw, uint16_t hum_raw);
+
+// Sample slot without data.
+uint8_t history_skip(history_t * p_history);
+
+// Entries by age, 0 being the newest. Return false past the oldest.
+bool history_raw_get(history_t const * p_history, uint16_t age, history_raw_t * p_raw);
+bool history_minute_get(history_t const * p_history, uint8_t age, history_agg_t * p_agg);
+bool history_hour_get(history_t const * p_history, uint8_t age, history_agg_t * p_agg);
+
+void history_trend_get(history_t const * p_history, history_trend_t * p_trend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HISTORY_H__
@@ -0,0 +1,64 @@
+#include <string.h>
+#include "jitter.h"
+
+static uint8_t bucket_get(uint32_t deviation_us)
+{
+    uint8_t bucket = 0;
+
+    while (deviation_us != 0 && bucket < JITTER_BUCKETS - 1)
+    {
+        deviation_us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void jitter_init(jitter_t * p_jitter, uint32_t period_us)
+{
+    memset(p_jitter, 0, sizeof(*p_jitter));
+    p_jitter->period_us = period_us;
+}
+
+void jitter_record(jitter_t * p_jitter, uint32_t interval_us)
+{
+    int32_t  error_us     = (int32_t)(interval_us - p_jitter->period_us);
+    uint32_t deviation_us = (error_us < 0) ? (uint32_t)-error_us : (uint32_t)error_us;
+
+    p_jitter->histogram[bucket_get(deviation_us)]++;
+    p_jitter->phase_us += error_us;
+    p_jitter->samples++;
+
+    if (deviation_us > p_jitter->max_us)
+    {
+        p_jitter->max_us = deviation_us;
+    }
+}
+
+void jitter_report_get(jitter_t const * p_jitter, jitter_report_t * p_report)
+{
+    uint32_t samples = p_jitter->samples;
+    uint32_t limit   = samples - samples / 100; // At least 99 %
+    uint32_t count   = 0;
+    uint8_t  bucket  = 0;
+
+    p_report->samples       = samples;
+    p_report->max_us        = p_jitter->max_us;
+    p_report->phase_us      = p_jitter->phase_us;
+    p_report->mean_error_us = (samples != 0) ? (int32_t)(p_jitter->phase_us / samples) : 0;
+
+    for (bucket = 0; bucket < JITTER_BUCKETS - 1; bucket++)
+    {
+        count += p_jitter->histogram[bucket];
+        if (count >= limit)
+        {
+            break;
+        }
+    }
+
+    // [the last bucket is open ended - the maximum bounds it]
+    p_report->p99_us = (bucket == 0) ? 0 : (1u << bucket) - 1;
+    if (p_report->p99_us > p_jitter->max_us)
+    {
+        p_report->p99_us = p_jitter->max_us;
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef JITTER_H__
+#define JITTER_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Sampling period jitter and phase.
+ *  Every sampling instant is recorded as its interval to the previous one.
+ *  The deviation from the nominal period goes into a histogram with
+ *  power-of-two buckets (bucket 0 holds exact hits, bucket b deviations of
+ *  2^(b-1)..2^b - 1 us), and its running sum is the phase of the latest
+ *  sample against an ideal clock started with the first one.
+ */
+#ifndef JITTER_BUCKETS
+#define JITTER_BUCKETS  24  // Up to 8.4 s deviation
+#endif
+
+typedef struct
+{
+    uint32_t period_us;
+    uint32_t samples;
+    uint32_t max_us;
+    int64_t  phase_us;
+    uint32_t histogram[JITTER_BUCKETS];
+} jitter_t;
+
+typedef struct
+{
+    uint32_t samples;       // Intervals recorded
+    int32_t  mean_error_us; // Mean of interval - period
+    uint32_t p99_us;        // Bucket bound covering 99 % of |interval - period|
+    uint32_t max_us;        // Largest |interval - period|
+    int64_t  phase_us;      // Latest sample against samples * period
+} jitter_report_t;
+
+void jitter_init(jitter_t * p_jitter, uint32_t period_us);
+
+void jitter_record(jitter_t * p_jitter, uint32_t interval_us);
+
+void jitter_report_get(jitter_t const * p_jitter, jitter_report_t * p_report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JITTER_H__
@@ -0,0 +1,115 @@
+#include "long_timer.h"
+#include "nrf.h"
+#include "nrf_rtc.h"
+#include "app_util_platform.h"
+
+#define COUNTER_MASK    0x00FFFFFF
+
+static long_timer_handler_t m_handler;
+static void *               m_p_context;
+static uint32_t             m_period_ticks;
+static uint32_t             m_compare;
+static uint32_t             m_wakes;
+
+ret_code_t long_timer_config_get(uint32_t period_ms, long_timer_config_t * p_config)
+{
+    uint64_t const clocks = (uint64_t)period_ms * LONG_TIMER_RTC_FREQ_HZ; // x 1000
+    uint32_t       first  = 0;
+
+    if (period_ms == 0 || period_ms > LONG_TIMER_MAX_PERIOD_MS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    for (uint32_t div = 1; div <= LONG_TIMER_PRESCALER_MAX + 1; div++)
+    {
+        uint64_t ticks = clocks / ((uint64_t)div * 1000);
+
+        if (ticks > LONG_TIMER_MAX_TICKS)
+        {
+            continue;
+        }
+        if (first == 0)
+        {
+            first = div;
+        }
+        if ((clocks % ((uint64_t)div * 1000)) == 0)
+        {
+            p_config->prescaler    = (uint16_t)(div - 1);
+            p_config->period_ticks = (uint32_t)ticks;
+            p_config->exact        = true;
+            return NRF_SUCCESS;
+        }
+    }
+
+    // No exact fit - finest resolution that fits, rounded to the nearest tick.
+    p_config->prescaler    = (uint16_t)(first - 1);
+    p_config->period_ticks = (uint32_t)((clocks + (uint64_t)first * 500) /
+                                        ((uint64_t)first * 1000));
+    p_config->exact        = false;
+    return NRF_SUCCESS;
+}
+
+ret_code_t long_timer_start(uint32_t period_ms, long_timer_handler_t handler, void * p_context)
+{
+    long_timer_config_t config;
+    ret_code_t          err_code = long_timer_config_get(period_ms, &config);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    long_timer_stop();
+
+    m_handler      = handler;
+    m_p_context    = p_context;
+    m_period_ticks = config.period_ticks;
+    m_compare      = config.period_ticks;
+    m_wakes        = 0;
+
+    // [the prescaler can only be written while the RTC is stopped]
+    nrf_rtc_prescaler_set(LONG_TIMER_RTC, config.prescaler);
+    nrf_rtc_task_trigger(LONG_TIMER_RTC, NRF_RTC_TASK_CLEAR);
+    nrf_rtc_cc_set(LONG_TIMER_RTC, 0, m_compare);
+    nrf_rtc_event_clear(LONG_TIMER_RTC, NRF_RTC_EVENT_COMPARE_0);
+    nrf_rtc_int_enable(LONG_TIMER_RTC, NRF_RTC_INT_COMPARE0_MASK);
+
+    NVIC_SetPriority(LONG_TIMER_IRQn, APP_IRQ_PRIORITY_LOWEST);
+    NVIC_ClearPendingIRQ(LONG_TIMER_IRQn);
+    NVIC_EnableIRQ(LONG_TIMER_IRQn);
+
+    nrf_rtc_task_trigger(LONG_TIMER_RTC, NRF_RTC_TASK_START);
+    return NRF_SUCCESS;
+}
+
+void long_timer_stop(void)
+{
+    NVIC_DisableIRQ(LONG_TIMER_IRQn);
+    nrf_rtc_task_trigger(LONG_TIMER_RTC, NRF_RTC_TASK_STOP);
+    nrf_rtc_int_disable(LONG_TIMER_RTC, NRF_RTC_INT_COMPARE0_MASK);
+    nrf_rtc_event_clear(LONG_TIMER_RTC, NRF_RTC_EVENT_COMPARE_0);
+}
+
+uint32_t long_timer_wakes_get(void)
+{
+    return m_wakes;
+}
+
+void LONG_TIMER_IRQHandler(void)
+{
+    m_wakes++;
+
+    if (!nrf_rtc_event_pending(LONG_TIMER_RTC, NRF_RTC_EVENT_COMPARE_0))
+    {
+        return;
+    }
+    nrf_rtc_event_clear(LONG_TIMER_RTC, NRF_RTC_EVENT_COMPARE_0);
+
+    // From the previous compare, not from now - handler latency does not
+    // add up, and the counter wraps around without an interrupt.
+    m_compare = (m_compare + m_period_ticks) & COUNTER_MASK;
+    nrf_rtc_cc_set(LONG_TIMER_RTC, 0, m_compare);
+
+    m_handler(m_p_context);
+}
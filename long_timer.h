@@ -0,0 +1,67 @@
+#ifndef LONG_TIMER_H__
+#define LONG_TIMER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Periodic timer for sampling periods of minutes to days.
+ *  Runs on its own RTC instance with only the COMPARE0 interrupt enabled:
+ *  every compare sets the next one a full period after the previous one, so
+ *  the MCU wakes exactly once per period and the phase never drifts. The
+ *  prescaler is picked per period - the finest resolution at which the
+ *  period is a whole number of ticks that fits the 24-bit counter.
+ *
+ *  app_timer (RTC1) cannot do this: at 16384 Hz its counter overflows, and
+ *  wakes the CPU, every 1024 s, and APP_TIMER_SAFE_WINDOW_MS limits a
+ *  single timeout to 1024 s minus the window.
+ *
+ *  Needs the LFCLK running (nrf_drv_clock_lfclk_request()).
+ */
+#define LONG_TIMER_RTC          NRF_RTC2
+#define LONG_TIMER_IRQn         RTC2_IRQn
+#define LONG_TIMER_IRQHandler   RTC2_IRQHandler
+
+#define LONG_TIMER_RTC_FREQ_HZ  32768
+#define LONG_TIMER_PRESCALER_MAX 4095
+
+// Largest period in ticks - leaves room for the latency of rewriting the
+// compare register behind a compare event.
+#define LONG_TIMER_MAX_TICKS    0x00FF0000
+
+// Longest period in ms (about 24 days).
+#define LONG_TIMER_MAX_PERIOD_MS \
+    ((uint32_t)(((uint64_t)LONG_TIMER_MAX_TICKS * (LONG_TIMER_PRESCALER_MAX + 1) * 1000) / \
+                LONG_TIMER_RTC_FREQ_HZ))
+
+typedef void (* long_timer_handler_t)(void * p_context);
+
+typedef struct
+{
+    uint16_t prescaler;     // RTC PRESCALER register value
+    uint32_t period_ticks;
+    bool     exact;         // period_ticks represents the period without rounding
+} long_timer_config_t;
+
+// Prescaler and tick count for a period. Returns NRF_ERROR_INVALID_PARAM if
+// the period is zero or longer than LONG_TIMER_MAX_PERIOD_MS.
+ret_code_t long_timer_config_get(uint32_t period_ms, long_timer_config_t * p_config);
+
+// Starts the RTC, the first timeout comes one period from now. The handler
+// runs in the RTC interrupt at APP_IRQ_PRIORITY_LOWEST.
+ret_code_t long_timer_start(uint32_t period_ms, long_timer_handler_t handler, void * p_context);
+
+void long_timer_stop(void);
+
+// Interrupts taken since long_timer_start().
+uint32_t long_timer_wakes_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LONG_TIMER_H__
@@ -1,15 +1,34 @@
 #include "nrf_drv_gpiote.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include "boards.h"
 #include "app_util_platform.h"
 #include "app_timer.h"
 #include "nrf_pwr_mgmt.h"
 #include "nrf_drv_clock.h"
+#include "nrf_timer.h"
 #include "bsp.h"
 #include "app_error.h"
 #include "nrf_twi_mngr.h"
 #include "hdc1080.h"
+#include "hdc1080_heater.h"
+#include "bmp280.h"
+#include "hdc1080_dump.h"
+#include "sample.h"
+#include "sample_queue.h"
+#include "sampler.h"
+#include "sample_proc.h"
+#include "psychro.h"
+#include "sampling_config.h"
+#include "timestamp.h"
+#include "sample_stream.h"
+#include "summary.h"
+#include "jitter.h"
+#include "long_timer.h"
+#include "history.h"
+#include "deadband.h"
+#include "task_timer.h"
 #include "compiler_abstraction.h"
 
 #include "nrf_log.h"
@@ -20,10 +39,86 @@
 
 #define TWI_INSTANCE_ID             0
 
-#define MAX_PENDING_TRANSACTIONS    5
+#define MAX_PENDING_TRANSACTIONS    8
 
 NRF_TWI_MNGR_DEF(m_nrf_twi_mngr, MAX_PENDING_TRANSACTIONS, TWI_INSTANCE_ID);
+
+// Sampling tick, acquisition, processing, jitter report and log flushing
+// settings are in sampling_config.h, shared with the emulator runs in
+// tools/emu.
+
+// Samples go out as COBS framed binary records over UARTE (see
+// tools/stream_parser.py) instead of formatted RTT log lines.
+#define SAMPLE_STREAM_ENABLED       1
+
+// Instead of every sample, one summary record (count, min, max, mean and
+// variance of the T and RH codes, window_stats.h, and of the BMP280 codes
+// when there are any) is streamed per SUMMARY_WINDOW_SAMPLES samples.
+#define SUMMARY_ENABLED             1
+
+// Tiered on-device history of the codes (history.h) - the last samples,
+// minutes and hours, and the 24 h trend, logged every hour.
+#define HISTORY_ENABLED             1
+
+#if SUMMARY_ENABLED && !SAMPLE_STREAM_ENABLED
+    #error "Summaries go out over the sample stream"
+#endif
+
+// Report on change (deadband.h) - a sample only reaches the stream or the
+// log when T or RH has left its deadband around the last reported codes,
+// or at least every DEADBAND_HEARTBEAT_MS. The band of a channel is the
+// wider of the absolute one in codes and the relative one in 1/65536 of the
+// last reported code. Averaging, history and the heater still see every
+// sample; heater samples are always reported.
+#define DEADBAND_ENABLED            0
+
+#if DEADBAND_ENABLED && SUMMARY_ENABLED
+    #error "Summaries already reduce the stream - use one or the other"
+#endif
+
+// HDC1080 supply switched by a GPIO - powered up HDC1080_STARTUP_MS ahead of
+// each sample, initialized, sampled and powered down again once the sample
+// has been processed (samples_drain()). Only pays off at long sampling
+// periods, see tools/emu/run_power_gating.c for the crossover.
+// [the I2C pull-ups have to be on the switched supply as well, otherwise
+//  the sensor is back-powered through SDA and SCL]
+#define SENSOR_POWER_GATING_ENABLED 0
+#define SENSOR_POWER_PIN            NRF_GPIO_PIN_MAP(0,28)
+
+// Boot without waiting (boot_start()) - the LFCLK start-up, the HDC1080
+// start-up after power-on and its configuration write overlap, and the first
+// sample is taken over the bus alone: app_timer only counts once the LFCLK
+// runs, and its first tick comes a sampling period after that. The config
+// write is repeated while the sensor NACKs its start-up and the result read
+// while it converts, paced by a BOOT_TIMER compare (FAST_BOOT_RETRY_US and
+// FAST_BOOT_TIMEOUT_US in sampling_config.h). Times since main() are taken
+// with BOOT_TIMER and logged once.
+// [the blocking read_t_and_hr() this replaces fails outright when the
+//  sensor is still starting up, as after a power-on or brown-out]
+#define FAST_BOOT_ENABLED           1
+#define BOOT_TIMER                  NRF_TIMER3
+#define BOOT_TIMER_IRQn             TIMER3_IRQn
+#define BOOT_TIMER_IRQHandler       TIMER3_IRQHandler
+
+// Cycles per sample of the psychro.c tables against the logf()/expf() Magnus
+// formula, counted with the DWT cycle counter and logged once at start-up.
+// Needs PSYCHRO_TABLE_ENABLED (psychro.h) set for the whole build.
+// [tools/bench_psychro.c runs on the host, against a vectorised libm - it
+//  says nothing about the Cortex-M4F]
+#define PSYCHRO_CYCLES_ENABLED      0
+#define PSYCHRO_CYCLES_POINTS       64
+
+#if PSYCHRO_CYCLES_ENABLED && !PSYCHRO_TABLE_ENABLED
+    #error "The psychro cycle count needs PSYCHRO_TABLE_ENABLED"
+#endif
+
+// Sampling tick - a task of the shared app_timer (TASK_TIMER_ENABLED, see
+// sampling_config.h) or an app_timer of its own.
+#if TASK_TIMER_ENABLED
+static task_timer_t m_timer;
+#else
 APP_TIMER_DEF(m_timer);
+#endif
 
 // Pin number for indicating communication with sensors.
 #ifdef BSP_LED_3
@@ -37,28 +132,17 @@ APP_TIMER_DEF(m_timer);
 #define BUFFER_SIZE  10
 static uint8_t m_buffer[BUFFER_SIZE];
 
-// Data structures needed for averaging of data read from sensors.
-// [max 32, otherwise "int16_t" won't be sufficient to hold the sum
-//  of temperature samples]
-#define NUMBER_OF_SAMPLES  16
-
-typedef struct
-{
-    float temp;
-    float hum;
-} sum_t;
-
-static sum_t m_sum = { 0.0f, 0.0f};
-
-typedef struct
-{
-    float temp;
-    float hum;
-} sample_t;
-
-static sample_t m_samples[NUMBER_OF_SAMPLES] = { { 0.0f, 0.0f } };
+// Median filter, averaging, derived values and the heater check
+// (sample_proc.h) of the samples in the main loop.
+static sample_proc_t        m_proc;
+#if !AVERAGING_USE_EMA
+static sample_proc_ring_t   m_proc_ring;
+#endif
+static sample_proc_result_t m_average;
 
-static uint8_t m_sample_idx = 0;
+// Codes of the last valid sample, for the register dump (button 1).
+static uint16_t m_last_temp_raw;
+static uint16_t m_last_hum_raw;
 
 ret_code_t result_mngr_perform;
 
@@ -78,6 +162,10 @@ static nrf_twi_mngr_transfer_t const transfer_read_temp[] =
 float temperature;
 float relative_humidity;
 
+// Derived from the averaged temperature and humidity.
+int16_t  dew_point;         // in 0.01 °C
+uint32_t absolute_humidity; // in mg/m^3
+
 // manufacturer register related variables
 static uint8_t m_manufacturer_buffer[2];
 
@@ -96,109 +184,376 @@ static nrf_twi_mngr_transfer_t const transfer_manufacturer[] =
 
 
 ////////////////////////////////////////////////////////////////////////////////
-// Reading of data from sensors - current temperature and humidity
+// Pressure and temperature from the BMP280
 //
-#if (BUFFER_SIZE < 6)
-    #error Buffer too small.
+#if BMP280_ENABLED
+int32_t  bmp280_temperature; // in 0.01 °C
+uint32_t bmp280_pressure;    // in Pa, Q24.8
+
+// Compensates a pair of ADC codes.
+static void bmp280_data_process(int32_t adc_t, int32_t adc_p)
+{
+    bmp280_calib_t const * p_calib = sampler_bmp280_calib_get();
+    int32_t                t_fine;
+
+    bmp280_temperature = bmp280_compensate_t(p_calib, adc_t, &t_fine);
+    bmp280_pressure    = bmp280_compensate_p(p_calib, adc_p, t_fine);
+
+#if !SAMPLE_STREAM_ENABLED
+    NRF_LOG_RAW_INFO("BMP280 T: %s%d.%02d C, P: %u Pa\r\n",
+                     (bmp280_temperature < 0) ? "-" : "",
+                     abs(bmp280_temperature) / 100, abs(bmp280_temperature) % 100,
+                     bmp280_pressure >> 8);
+#endif
+}
 #endif
 
-void read_all_cb(ret_code_t result, void * p_user_data)
+
+////////////////////////////////////////////////////////////////////////////////
+// Power switching of the HDC1080
+//
+#if SENSOR_POWER_GATING_ENABLED
+static void sensor_power_set(bool on)
 {
+    if (on)
+    {
+        nrf_gpio_pin_set(SENSOR_POWER_PIN);
+    }
+    else
+    {
+        nrf_gpio_pin_clear(SENSOR_POWER_PIN);
+    }
+}
+#endif
 
-    if (result != NRF_SUCCESS)
+
+////////////////////////////////////////////////////////////////////////////////
+// Processing of the samples
+//
+
+// Completed records reach the main loop through m_sample_queue.
+static sample_queue_t m_sample_queue;
+static uint32_t       m_sample_overflows; // Last logged
+
+#if SUMMARY_ENABLED
+static summary_t m_summary;
+#endif
+
+#if DEADBAND_ENABLED
+static deadband_t m_deadband;
+#endif
+
+#if HISTORY_ENABLED
+static history_t m_history;
+
+static void history_update(sample_record_t const * p_record)
+{
+    uint8_t rolled;
+
+    // Slots without a usable sample keep the tiers in step with time.
+    if (p_record->flags & (SAMPLE_FLAG_ERROR | SAMPLE_FLAG_HEATER))
+    {
+        rolled = history_skip(&m_history);
+    }
+    else
+    {
+        rolled = history_add(&m_history, p_record->temp_raw, p_record->hum_raw);
+    }
+
+    if (rolled & HISTORY_ROLL_HOUR)
+    {
+        history_trend_t trend;
+
+        history_trend_get(&m_history, &trend);
+        // [0.01 C and 0.01 % as integers - NRF_LOG takes at most 6
+        //  arguments and NRF_LOG_FLOAT() uses three]
+        NRF_LOG_RAW_INFO("Last %u h: T %d..%d, %d codes/h\r\n", trend.hours,
+                         (int)lroundf(HDC1080_TEMP_FROM_RAW(trend.range.temp_min) * 100.0f),
+                         (int)lroundf(HDC1080_TEMP_FROM_RAW(trend.range.temp_max) * 100.0f),
+                         trend.temp_slope);
+        NRF_LOG_RAW_INFO("           RH %d..%d, %d codes/h\r\n",
+                         (int)lroundf(HDC1080_HUM_FROM_RAW(trend.range.hum_min) * 100.0f),
+                         (int)lroundf(HDC1080_HUM_FROM_RAW(trend.range.hum_max) * 100.0f),
+                         trend.hum_slope);
+    }
+}
+#endif
+
+// Runs in the main loop, for every record taken from m_sample_queue.
+static void sample_process(sample_record_t const * p_record)
+{
+    if (p_record->flags & SAMPLE_FLAG_ERROR)
     {
-        NRF_LOG_WARNING("read_all_cb - error: %d", (int)result);
+#if HISTORY_ENABLED
+        history_update(p_record);
+#endif
         return;
     }
 
-    sample_t * p_sample = &m_samples[m_sample_idx];
+    uint8_t temp_hi = (uint8_t)(p_record->temp_raw >> 8);
+    uint8_t temp_lo = (uint8_t)p_record->temp_raw;
+    uint8_t hum_hi  = (uint8_t)(p_record->hum_raw >> 8);
+    uint8_t hum_lo  = (uint8_t)p_record->hum_raw;
+
+    m_last_temp_raw = p_record->temp_raw;
+    m_last_hum_raw  = p_record->hum_raw;
+
+    temperature       = HDC1080_GET_TEMP_VALUE(temp_hi, temp_lo); // in °C
+    relative_humidity = HDC1080_GET_HUM_VALUE(hum_hi, hum_lo);    // in %
+
+#if BMP280_ENABLED
+    if (p_record->flags & SAMPLE_FLAG_PRESSURE)
+    {
+        bmp280_data_process((int32_t)p_record->ptemp_raw, (int32_t)p_record->press_raw);
+    }
+#endif
+
+#if DEADBAND_ENABLED
+    // Heater samples leave the reference where it is.
+    bool report = (p_record->flags & SAMPLE_FLAG_HEATER) ||
+                  (deadband_update(&m_deadband, p_record->temp_raw, p_record->hum_raw) != 0);
+#else
+    bool report = true;
+#endif
+    UNUSED_VARIABLE(report); // Not with the log off and summaries on
+
+#if SUMMARY_ENABLED
+    if (summary_add(&m_summary, p_record))
+    {
+        sample_stream_summary_put(&m_summary.summary);
+    }
+#elif SAMPLE_STREAM_ENABLED
+    if (report)
+    {
+        sample_stream_put(p_record);
+    }
+#endif
+#if HISTORY_ENABLED
+    history_update(p_record);
+#endif
 
-    m_sum.temp      -= p_sample->temp;
-    m_sum.hum       -= p_sample->hum;
+    if (p_record->flags & SAMPLE_FLAG_HEATER)
+    {
+#if !SAMPLE_STREAM_ENABLED
+        NRF_LOG_RAW_INFO("\r\n(heater) T: " NRF_LOG_FLOAT_MARKER " C, RH: "
+                         NRF_LOG_FLOAT_MARKER " %%\r\n",
+                         NRF_LOG_FLOAT(temperature),
+                         NRF_LOG_FLOAT(relative_humidity));
+#endif
+        return;
+    }
 
-    uint8_t temp_hi = m_buffer[2];
-    uint8_t temp_lo = m_buffer[3];
-    uint8_t hum_hi  = m_buffer[4];
-    uint8_t hum_lo  = m_buffer[5];
+#if !SAMPLE_STREAM_ENABLED
+    if (report)
+    {
+        NRF_LOG_RAW_INFO("\r\nT Register 2 bytes: %x %x\r\n", temp_hi, temp_lo);
+        NRF_LOG_RAW_INFO("\r\nHR Register 2 bytes: %x %x\r\n", hum_hi, hum_lo);
+        NRF_LOG_RAW_INFO("Temperature " NRF_LOG_FLOAT_MARKER " C\r\n",
+                          NRF_LOG_FLOAT(temperature));
+        NRF_LOG_RAW_INFO("Relative Humidity " NRF_LOG_FLOAT_MARKER " %% \r\n",
+                          NRF_LOG_FLOAT(relative_humidity) );
+        if (!(p_record->flags & SAMPLE_FLAG_NO_TIME))
+        {
+            NRF_LOG_RAW_INFO("Triggered at %u, conversion + read %u us\r\n",
+                             p_record->t_trigger,
+                             timestamp_diff_us(p_record->t_done, p_record->t_trigger));
+        }
+    }
+#endif
 
-    p_sample->temp  = HDC1080_GET_TEMP_VALUE(temp_hi, temp_lo);
-    p_sample->hum   = HDC1080_GET_HUM_VALUE(hum_hi, hum_lo);
+    bool processed = sample_proc_update(&m_proc, p_record, &m_average);
 
-    m_sum.temp      += p_sample->temp;
-    m_sum.hum       += p_sample->hum;
+    dew_point         = m_average.dew_point;
+    absolute_humidity = m_average.abs_humidity;
 
-    ++m_sample_idx;
+#if !SAMPLE_STREAM_ENABLED
+    if (report)
+    {
+        NRF_LOG_RAW_INFO("Dew point %s%d.%02d C, absolute humidity %u mg/m3\r\n",
+                         (dew_point < 0) ? "-" : "", abs(dew_point) / 100,
+                         abs(dew_point) % 100, absolute_humidity);
+    }
+#endif
 
-    if (m_sample_idx >= NUMBER_OF_SAMPLES)
+    // [heater_due is that of the last processed sample - a heater sample
+    //  read after the cycle has ended must not start the next one]
+    if (processed && m_average.heater_due && !hdc1080_heater_is_active())
     {
-        m_sample_idx = 0;
+        APP_ERROR_CHECK(hdc1080_heater_start(HEATER_BURST_CONVERSIONS));
     }
 }
-//static void read_all(void)
-//{
-//    // [these structures have to be "static" - they cannot be placed on stack
-//    //  since the transaction is scheduled and these structures most likely
-//    //  will be referred after this function returns]
-//    static nrf_twi_mngr_transfer_t const transfers[] =
-//    {
-//        HDC1080_READ_TEMP(&m_buffer[2])
-//        ,
-//        HDC1080_READ_HUM(&m_buffer[4])
-//    };
-//    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND transaction =
-//    {
-//        .callback            = read_all_cb,
-//        .p_user_data         = NULL,
-//        .p_transfers         = transfers,
-//        .number_of_transfers = sizeof(transfers) / sizeof(transfers[0])
-//    };
-//
-//    APP_ERROR_CHECK(nrf_twi_mngr_schedule(&m_nrf_twi_mngr, &transaction));
+
+#if FAST_BOOT_ENABLED
+static void boot_sample_note(sample_record_t const * p_record);
+#endif
+
+// Record handler of the sampler, in the TWI callback.
+static void sample_put(sample_record_t const * p_record)
+{
+#if FAST_BOOT_ENABLED
+    boot_sample_note(p_record);
+#endif
+    // A full queue drops the sample, the main loop logs the count.
+    (void)sample_queue_put(&m_sample_queue, p_record);
+}
+
+static sampler_config_t const m_sampler_config =
+{
+    .p_twi               = &m_nrf_twi_mngr,
+    .record_handler      = sample_put,
+    .read_delay_ticks    = APP_TIMER_TICKS(READ_DELAY_MS),
+#if READY_POLLING_ENABLED
+    .poll_interval_ticks = APP_TIMER_TICKS(READY_POLL_INTERVAL_MS),
+    .poll_max            = READY_POLL_MAX,
+#endif
+    .fused               = FUSED_ACQUISITION_ENABLED,
+    .task_timer          = TASK_TIMER_ENABLED,
+    .untimed             = LONG_PERIOD_SCHEDULING_ENABLED,
+#if SENSOR_POWER_GATING_ENABLED
+    .power_set           = sensor_power_set
+#endif
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Fast boot - configuration and first sample before app_timer runs
 //
-//    // Signal on LED that something is going on.
-//    bsp_board_led_invert(READ_ALL_INDICATOR);
-//}
+#if FAST_BOOT_ENABLED
+static volatile uint32_t m_boot_lfclk_us;   // 0 until the LFCLK has started
+static uint32_t          m_boot_config_us;  // 0 - configuration failed
+static volatile uint32_t m_boot_sample_us;  // 0 until the first valid sample
+static volatile bool     m_boot_over;       // Boot sampling done, whatever the result
+static volatile bool     m_boot_tick_done;  // A sample of the ticks done since
+static uint32_t          m_boot_start_us;   // Boot sampling started
+static bool              m_boot_reported;
+
+static void boot_timer_start(void)
+{
+    nrf_timer_mode_set(BOOT_TIMER, NRF_TIMER_MODE_TIMER);
+    nrf_timer_bit_width_set(BOOT_TIMER, NRF_TIMER_BIT_WIDTH_32);
+    nrf_timer_frequency_set(BOOT_TIMER, NRF_TIMER_FREQ_1MHz);
+    nrf_timer_task_trigger(BOOT_TIMER, NRF_TIMER_TASK_CLEAR);
+    nrf_timer_task_trigger(BOOT_TIMER, NRF_TIMER_TASK_START);
+
+    // Retries of the boot sampling, at the priority of the TWI callbacks.
+    NVIC_SetPriority(BOOT_TIMER_IRQn, APP_IRQ_PRIORITY_LOWEST);
+    NVIC_ClearPendingIRQ(BOOT_TIMER_IRQn);
+    NVIC_EnableIRQ(BOOT_TIMER_IRQn);
+}
 
-static void read_all(void)
+static uint32_t boot_time_us(void)
 {
-    // [these structures have to be "static" - they cannot be placed on stack
-    //  since the transaction is scheduled and these structures most likely
-    //  will be referred after this function returns]
-     result_mngr_perform = nrf_twi_mngr_perform(&m_nrf_twi_mngr,
-                                        NULL, transfer_write_temp,
-                                        1, NULL);
-    nrf_delay_ms(20);
+    // [called from the TWI and the clock interrupt - a capture by the other
+    //  one in between only makes this reading a few us late]
+    nrf_timer_task_trigger(BOOT_TIMER, NRF_TIMER_TASK_CAPTURE0);
+    return nrf_timer_cc_read(BOOT_TIMER, NRF_TIMER_CC_CHANNEL0);
+}
 
-    result_mngr_perform = nrf_twi_mngr_perform(&m_nrf_twi_mngr,
-                                        NULL, transfer_read_temp,
-                                        1, NULL);
+static void boot_lfclk_handler(nrf_drv_clock_evt_type_t event)
+{
+    if (event == NRF_DRV_CLOCK_EVT_LFCLK_STARTED)
+    {
+        m_boot_lfclk_us = boot_time_us();
+    }
+}
 
-    temperature = ((((((int16_t)m_temp_and_hr_buffer[0] << 8) | \
-      m_temp_and_hr_buffer[1])) / pow(2.0f, 16.0f)) * 165.0f - 40.0f); // in °C
- 
-    relative_humidity = ((((((int16_t)m_temp_and_hr_buffer[2] << 8) | \
-      m_temp_and_hr_buffer[3])) / pow(2.0f, 16.0f)) * 100.0f); // in %
-    
+static nrf_drv_clock_handler_item_t m_boot_lfclk_item =
+{
+    .event_handler = boot_lfclk_handler
+};
 
-    NRF_LOG_RAW_INFO("\r\nResult Read T Register once: %d \r\n",
-                    result_mngr_perform);
-    NRF_LOG_RAW_INFO("\r\nT Register 2 bytes: %x %x\r\n",
-                    m_temp_and_hr_buffer[0], m_temp_and_hr_buffer[1]);
-    NRF_LOG_RAW_INFO("\r\nHR Register 2 bytes: %x %x\r\n",
-                    m_temp_and_hr_buffer[2], m_temp_and_hr_buffer[3]);
-    NRF_LOG_RAW_INFO("Temperature " NRF_LOG_FLOAT_MARKER " C\r\n",
-                      NRF_LOG_FLOAT(temperature));
-    NRF_LOG_RAW_INFO("Relative Humidity " NRF_LOG_FLOAT_MARKER " %% \r\n",
-                      NRF_LOG_FLOAT(relative_humidity) );
+void BOOT_TIMER_IRQHandler(void)
+{
+    nrf_timer_event_clear(BOOT_TIMER, NRF_TIMER_EVENT_COMPARE1);
+    nrf_timer_int_disable(BOOT_TIMER, NRF_TIMER_INT_COMPARE1_MASK);
+    sampler_boot_retry();
+}
 
+// The sensor NACKed - next attempt FAST_BOOT_RETRY_US later, until
+// FAST_BOOT_TIMEOUT_US after the start.
+static void boot_retry_schedule(void)
+{
+    uint32_t now = boot_time_us();
 
-    NRF_LOG_FLUSH();
-    APP_ERROR_CHECK(result_mngr_perform);   
+    if (now - m_boot_start_us >= FAST_BOOT_TIMEOUT_US)
+    {
+        sampler_boot_give_up();
+        return;
+    }
+    nrf_timer_cc_write(BOOT_TIMER, NRF_TIMER_CC_CHANNEL1, now + FAST_BOOT_RETRY_US);
+    nrf_timer_event_clear(BOOT_TIMER, NRF_TIMER_EVENT_COMPARE1);
+    nrf_timer_int_enable(BOOT_TIMER, NRF_TIMER_INT_COMPARE1_MASK);
+}
 
-    // Signal on LED that something is going on.
-    bsp_board_led_invert(READ_ALL_INDICATOR);
+static void boot_handler(sampler_boot_evt_t event, ret_code_t result)
+{
+    switch (event)
+    {
+    case SAMPLER_BOOT_NACKED:
+        boot_retry_schedule();
+        break;
+
+    case SAMPLER_BOOT_CONFIGURED:
+        if (result == NRF_SUCCESS)
+        {
+            m_boot_config_us = boot_time_us();
+        }
+        break;
+
+    default: // SAMPLER_BOOT_SAMPLED
+        m_boot_over = true;
+        break;
+    }
+}
+
+// Every record, from sample_put() - the first valid one is the first sample,
+// whether the boot sampling or a tick took it. [the boot record comes ahead
+// of SAMPLER_BOOT_SAMPLED, records after it are from the ticks]
+static void boot_sample_note(sample_record_t const * p_record)
+{
+    if (m_boot_reported)
+    {
+        return;
+    }
+    if (m_boot_sample_us == 0 && !(p_record->flags & SAMPLE_FLAG_ERROR))
+    {
+        m_boot_sample_us = boot_time_us();
+    }
+    if (m_boot_over)
+    {
+        m_boot_tick_done = true;
+    }
 }
 
+// Configures the HDC1080 and takes the first sample, right after power-on.
+// [done long before the first tick - the sampler is not shared]
+static void boot_start(void)
+{
+    m_boot_start_us = boot_time_us();
+    sampler_boot_start(boot_handler);
+}
+
+// Main loop - logs the boot times once the LFCLK runs and the first valid
+// sample is there, and stops BOOT_TIMER. Without a valid boot sample, the
+// first sample of the ticks ends the wait as well, valid or not (first
+// sample 0 then).
+static void boot_report(void)
+{
+    if (m_boot_reported || m_boot_lfclk_us == 0 || !m_boot_over ||
+        (m_boot_sample_us == 0 && !m_boot_tick_done))
+    {
+        return;
+    }
+    m_boot_reported = true;
+
+    NRF_LOG_INFO("boot: configured %u us, first sample %u us, LFCLK %u us (%u NACKs)",
+                 m_boot_config_us, m_boot_sample_us, m_boot_lfclk_us,
+                 sampler_boot_polls_get());
+    NVIC_DisableIRQ(BOOT_TIMER_IRQn);
+    nrf_timer_task_trigger(BOOT_TIMER, NRF_TIMER_TASK_SHUTDOWN);
+}
+#endif
+
 #if (BUFFER_SIZE < 10)
     #error Buffer too small.
 #endif
@@ -214,10 +569,9 @@ static void read_hdc1080_temp_register_cb(ret_code_t result, void * p_user_data)
     NRF_LOG_DEBUG("hdc1080: ");
     NRF_LOG_HEXDUMP_DEBUG(m_buffer, 10);
     NRF_LOG_RAW_INFO("\r\nResult Read Temp Register: %d \r\n",result);
-    NRF_LOG_FLUSH();
 }
 
-static void read_hdc1080_registers_cb(ret_code_t result, void * p_user_data)
+static void read_hdc1080_registers_cb(ret_code_t result, hdc1080_dump_t const * p_dump)
 {
     if (result != NRF_SUCCESS)
     {
@@ -225,32 +579,54 @@ static void read_hdc1080_registers_cb(ret_code_t result, void * p_user_data)
         return;
     }
 
-    NRF_LOG_DEBUG("hdc1080: ");
-    NRF_LOG_HEXDUMP_DEBUG(m_buffer, 10);
+    NRF_LOG_RAW_INFO("\r\nhdc1080: config %x, T %x, RH %x, man %x, dev %x\r\n",
+                     p_dump->config, p_dump->temp_raw, p_dump->hum_raw,
+                     p_dump->manufacturer_id, p_dump->device_id);
+    NRF_LOG_RAW_INFO("dump: %d transfers, %d bytes, %d us bus, %d ms total\r\n",
+                     p_dump->transfers, p_dump->bus_bytes, p_dump->bus_time_us,
+                     (p_dump->elapsed_ticks * 1000) / APP_TIMER_CLOCK_FREQ);
+
+    if (p_dump->manufacturer_id != HDC1080_MANUFACTURER_ID ||
+        p_dump->device_id != HDC1080_DEVICE_ID)
+    {
+        NRF_LOG_WARNING("hdc1080: unexpected ID");
+    }
 }
+
+static void config_verify_cb(ret_code_t result, void * p_user_data)
+{
+    NRF_LOG_RAW_INFO("\r\nConfig shadow: %x, register: %x, result: %d\r\n",
+                     hdc1080_config_shadow_get(),
+                     hdc1080_config_readback_get(),
+                     result);
+}
+
 static void read_hdc1080_registers(void)
 {
-    // [these structures have to be "static" - they cannot be placed on stack
-    //  since the transaction is scheduled and these structures most likely
-    //  will be referred after this function returns]
-    static nrf_twi_mngr_transfer_t const transfers[] =
-    {
-        HDC1080_READ(&hdc1080_config_reg_addr,  &m_buffer[0], 2),
-        HDC1080_READ(&hdc1080_temp_reg_addr,    &m_buffer[2], 2),
-        HDC1080_READ(&hdc1080_hum_reg_addr,     &m_buffer[4], 2),
-        HDC1080_READ(&hdc1080_man_reg_addr,     &m_buffer[6], 2),
-        HDC1080_READ(&hdc1080_dev_reg_addr,     &m_buffer[8], 2),
-    };
-    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND transaction =
+    // Config register only - the ID registers are read on the first dump,
+    // T and RH are those of the last sample. [reading them would trigger a
+    // conversion in the middle of the sampling]
+    ret_code_t err_code = hdc1080_dump_start(m_last_temp_raw, m_last_hum_raw,
+                                             read_hdc1080_registers_cb);
+
+    if (err_code == NRF_ERROR_BUSY)
     {
-        .callback            = read_hdc1080_registers_cb,
-        .p_user_data         = NULL,
-        .p_transfers         = transfers,
-        .number_of_transfers = sizeof(transfers) / sizeof(transfers[0])
-    };
+        return; // Previous dump still running.
+    }
+    APP_ERROR_CHECK(err_code);
+}
 
-    APP_ERROR_CHECK(nrf_twi_mngr_schedule(&m_nrf_twi_mngr, &transaction));
-    // nrf_delay_ms(50);
+static void verify_hdc1080_config(void)
+{
+    ret_code_t err_code = hdc1080_config_verify(&m_nrf_twi_mngr, config_verify_cb, NULL);
+
+    if (err_code == NRF_ERROR_BUSY)
+    {
+        // A heater, boot or power gating write is running - press again.
+        NRF_LOG_WARNING("hdc1080: config busy, not verified");
+        return;
+    }
+    APP_ERROR_CHECK(err_code);
 }
 
 static void read_hdc1080_temp_register(void)
@@ -283,13 +659,18 @@ static void read_hdc1080_temp_register(void)
 static void bsp_event_handler(bsp_event_t event)
 {
     // Each time the button 1 is pushed we start a transaction reading
-    // values of all registers from HDC1080
+    // values of all registers from HDC1080, button 2 checks the
+    // configuration register against its shadow
     switch (event)
     {
     case BSP_EVENT_KEY_0: // Button 1 pushed.
         read_hdc1080_registers();
         break;
 
+    case BSP_EVENT_KEY_1: // Button 2 pushed.
+        verify_hdc1080_config();
+        break;
+
     default:
         break;
     }
@@ -303,6 +684,9 @@ static void bsp_config(void)
 
     err_code = bsp_init(BSP_INIT_BUTTONS, bsp_event_handler);
     APP_ERROR_CHECK(err_code);
+
+    err_code = timestamp_init();
+    APP_ERROR_CHECK(err_code);
 }
 
 // TWI (with transaction manager) initialization.
@@ -320,6 +704,9 @@ static void twi_config(void)
 
     err_code = nrf_twi_mngr_init(&m_nrf_twi_mngr, &config);
     APP_ERROR_CHECK(err_code);
+
+    err_code = hdc1080_dump_init(&m_nrf_twi_mngr, 100000);
+    APP_ERROR_CHECK(err_code);
 }
 
 static void lfclk_config(void)
@@ -329,22 +716,235 @@ static void lfclk_config(void)
     err_code = nrf_drv_clock_init();
     APP_ERROR_CHECK(err_code);
 
+#if FAST_BOOT_ENABLED
+    nrf_drv_clock_lfclk_request(&m_boot_lfclk_item);
+#else
     nrf_drv_clock_lfclk_request(NULL);
+#endif
 }
 
+#if JITTER_TRACKING_ENABLED
+static jitter_t m_jitter;
+static uint32_t m_tick_last;
+static bool     m_tick_seen;
+
+static void jitter_tick(void)
+{
+    uint32_t now = timestamp_get();
+
+    // [the first tick only sets the reference]
+    if (m_tick_seen)
+    {
+        jitter_record(&m_jitter, timestamp_diff_us(now, m_tick_last));
+    }
+    m_tick_last = now;
+    m_tick_seen = true;
+
+    if (m_jitter.samples != 0 && (m_jitter.samples % JITTER_REPORT_SAMPLES) == 0)
+    {
+        jitter_report_t report;
+        uint64_t        phase_us;
+
+        jitter_report_get(&m_jitter, &report);
+        NRF_LOG_RAW_INFO("Tick jitter: %u intervals, mean error %d us, p99 %u us, "
+                         "max %u us\r\n",
+                         report.samples, report.mean_error_us, report.p99_us,
+                         report.max_us);
+
+        // [the phase is 64-bit and grows without bound - logged in ms, split
+        //  like the BMP280 temperature, 32 bits of ms cover 49 days of drift]
+        phase_us = (report.phase_us < 0) ? (uint64_t)(-report.phase_us)
+                                         : (uint64_t)report.phase_us;
+        NRF_LOG_RAW_INFO("Tick phase: %s%u.%03u ms\r\n",
+                         (report.phase_us < 0) ? "-" : "",
+                         (uint32_t)(phase_us / 1000), (uint32_t)(phase_us % 1000));
+    }
+}
+#endif
+
+#if LONG_PERIOD_SCHEDULING_ENABLED
+#define LONG_PERIOD_SAMPLES_PER_DAY \
+    ((SAMPLING_PERIOD_MS < 86400000u) ? (86400000u / SAMPLING_PERIOD_MS) : 1u)
+
+static uint32_t m_long_samples;
+static uint32_t m_long_wakes_last;
+
+static void long_tick(void)
+{
+    if (++m_long_samples % LONG_PERIOD_SAMPLES_PER_DAY == 0)
+    {
+        uint32_t wakes = long_timer_wakes_get();
+
+        NRF_LOG_RAW_INFO("Sampling wake-ups: %u in %u samples\r\n",
+                         wakes - m_long_wakes_last, LONG_PERIOD_SAMPLES_PER_DAY);
+        m_long_wakes_last = wakes;
+    }
+}
+#endif
+
 void timer_handler(void * p_context)
 {
-    read_all();
+#if JITTER_TRACKING_ENABLED
+    jitter_tick(); // First thing - this is the sampling instant
+#endif
+#if LONG_PERIOD_SCHEDULING_ENABLED
+    long_tick();
+#endif
+
+    sampler_tick();
+
+    // Signal on LED that something is going on.
+    bsp_board_led_invert(READ_ALL_INDICATOR);
+}
+
+#if TASK_TIMER_ENABLED
+static task_timer_t       m_report_timer;
+static task_timer_stats_t m_task_stats_last;
+
+static void report_timer_handler(void * p_context)
+{
+    task_timer_stats_t stats;
+
+    task_timer_stats_get(&stats);
+    NRF_LOG_RAW_INFO("Timer: %u wake-ups for %u handlers, %u restarts\r\n",
+                     stats.wakes - m_task_stats_last.wakes,
+                     stats.runs - m_task_stats_last.runs,
+                     stats.rearms - m_task_stats_last.rearms);
+    m_task_stats_last = stats;
+}
+#endif
+
+#if LOG_FLUSH_BATCHED
+static uint16_t m_log_samples;  // Logged since the last flush
+static uint32_t m_log_flushed;  // timestamp_get() of the last flush
+
+// Main loop only. Anything logged in between, interrupt handlers included,
+// goes out with the next batch.
+static void log_flush(void)
+{
+    if (m_log_samples < LOG_FLUSH_WATERMARK &&
+        timestamp_diff_us(timestamp_get(), m_log_flushed) < LOG_FLUSH_MAX_LATENCY_MS * 1000u)
+    {
+        return;
+    }
+
+    NRF_LOG_FLUSH(); // Every pending entry in one pass
+    m_log_samples = 0;
+    m_log_flushed = timestamp_get();
+}
+#endif
+
+// Main loop side of m_sample_queue.
+static void samples_drain(void)
+{
+    sample_record_t record;
+    uint32_t        overflows;
+
+    while (sample_queue_get(&m_sample_queue, &record))
+    {
+        sample_process(&record);
+#if SENSOR_POWER_GATING_ENABLED
+        // [not before sample_process() - a heater cycle it starts needs
+        //  the sensor powered]
+        sampler_power_release();
+#endif
+#if LOG_FLUSH_BATCHED && !SAMPLE_STREAM_ENABLED
+        m_log_samples++;
+#endif
+    }
+
+    overflows = sample_queue_overflows_get(&m_sample_queue);
+    if (overflows != m_sample_overflows)
+    {
+        NRF_LOG_WARNING("%u samples dropped, queue full", overflows - m_sample_overflows);
+        m_sample_overflows = overflows;
+    }
+}
+
+// Acquisition (sampler.h) and the queue to the main loop - the boot sample
+// goes through them already.
+static void acquisition_config(void)
+{
+    ret_code_t err_code;
+
+#if TASK_TIMER_ENABLED
+    err_code = task_timer_init();
+    APP_ERROR_CHECK(err_code);
+#endif
+
+    sample_queue_init(&m_sample_queue);
+
+    err_code = sampler_init(&m_sampler_config);
+    APP_ERROR_CHECK(err_code);
 }
 
 void read_init(void)
 {
     ret_code_t err_code;
 
+#if TASK_TIMER_ENABLED
+    task_timer_create(&m_timer, timer_handler, 0);
+    task_timer_create(&m_report_timer, report_timer_handler,
+                      APP_TIMER_TICKS(TASK_TIMER_REPORT_TOLERANCE_MS));
+#elif !LONG_PERIOD_SCHEDULING_ENABLED
     err_code = app_timer_create(&m_timer, APP_TIMER_MODE_REPEATED, timer_handler);
     APP_ERROR_CHECK(err_code);
+#endif
+
+    err_code = hdc1080_heater_init(&m_nrf_twi_mngr, TASK_TIMER_ENABLED);
+    APP_ERROR_CHECK(err_code);
+
+    {
+        static sample_proc_config_t const proc_config =
+        {
+            .median    = MEDIAN_FILTER_ENABLED,
+            .ema       = AVERAGING_USE_EMA,
+            .heater_rh = HEATER_RH_THRESHOLD
+        };
+
+#if AVERAGING_USE_EMA
+        sample_proc_init(&m_proc, &proc_config, NULL);
+#else
+        sample_proc_init(&m_proc, &proc_config, &m_proc_ring);
+#endif
+    }
+#if SUMMARY_ENABLED
+    summary_init(&m_summary, SUMMARY_WINDOW_SAMPLES);
+#endif
+
+#if JITTER_TRACKING_ENABLED
+    jitter_init(&m_jitter, SAMPLING_PERIOD_MS * 1000);
+#endif
+#if DEADBAND_ENABLED
+    {
+        static deadband_config_t const deadband_config =
+        {
+            .temp_abs  = DEADBAND_TEMP_ABS,
+            .temp_rel  = DEADBAND_TEMP_REL,
+            .hum_abs   = DEADBAND_HUM_ABS,
+            .hum_rel   = DEADBAND_HUM_REL,
+            .heartbeat = DEADBAND_HEARTBEAT_MS / SAMPLING_PERIOD_MS
+        };
+
+        deadband_init(&m_deadband, &deadband_config);
+    }
+#endif
+#if HISTORY_ENABLED
+    // [with periods over a minute every sample is a "minute" of its own]
+    history_init(&m_history, SAMPLING_PERIOD_MS);
+#endif
 
-    err_code = app_timer_start(m_timer, APP_TIMER_TICKS(500), NULL);
+#if LONG_PERIOD_SCHEDULING_ENABLED
+    err_code = long_timer_start(SAMPLING_PERIOD_MS, timer_handler, NULL);
+#elif TASK_TIMER_ENABLED
+    err_code = task_timer_start(&m_timer, APP_TIMER_TICKS(SAMPLING_PERIOD_MS),
+                                APP_TIMER_TICKS(SAMPLING_PERIOD_MS), NULL);
+    APP_ERROR_CHECK(err_code);
+    err_code = task_timer_start(&m_report_timer, APP_TIMER_TICKS(TASK_TIMER_REPORT_MS),
+                                APP_TIMER_TICKS(TASK_TIMER_REPORT_MS), NULL);
+#else
+    err_code = app_timer_start(m_timer, APP_TIMER_TICKS(SAMPLING_PERIOD_MS), NULL);
+#endif
     APP_ERROR_CHECK(err_code);
 }
 
@@ -395,10 +995,69 @@ void read_t_and_hr(void)
     bsp_board_led_invert(READ_ALL_INDICATOR);
  
 }
+
+#if PSYCHRO_CYCLES_ENABLED
+// The float formula of tools/bench_psychro.c.
+static float dew_point_libm(float t, float rh)
+{
+    float g = logf(rh / 100.0f) + 17.62f * t / (243.12f + t);
+
+    return 243.12f * g / (17.62f - g);
+}
+
+static float abs_humidity_libm(float t, float rh)
+{
+    float e = rh / 100.0f * 611.2f * expf(17.62f * t / (243.12f + t));
+
+    return 2167.0f * e / (t + 273.15f);
+}
+
+static void psychro_cycles_log(void)
+{
+    volatile int32_t isink = 0;
+    volatile float   fsink = 0.0f;
+    uint32_t         table = 0;
+    uint32_t         libm  = 0;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT       = 0;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Spread over -40..125 C and 1..100 % RH, both inputs taken as the
+    // processing gets them.
+    for (uint32_t i = 0; i < PSYCHRO_CYCLES_POINTS; i++)
+    {
+        int16_t  t_centi  = (int16_t)(-4000 + (int32_t)(i * 16500 / PSYCHRO_CYCLES_POINTS));
+        uint16_t rh_centi = (uint16_t)(100 + (i * 37 % PSYCHRO_CYCLES_POINTS) * 9900 /
+                                             PSYCHRO_CYCLES_POINTS);
+        float    t        = t_centi / 100.0f;
+        float    rh       = rh_centi / 100.0f;
+        uint32_t start;
+
+        start  = DWT->CYCCNT;
+        isink += psychro_dew_point(t_centi, rh_centi) +
+                 (int32_t)psychro_abs_humidity(t_centi, rh_centi);
+        table += DWT->CYCCNT - start;
+
+        start  = DWT->CYCCNT;
+        fsink += dew_point_libm(t, rh) + abs_humidity_libm(t, rh);
+        libm  += DWT->CYCCNT - start;
+    }
+
+    NRF_LOG_INFO("psychro: table %u, logf/expf %u cycles per sample (%u points)",
+                 table / PSYCHRO_CYCLES_POINTS, libm / PSYCHRO_CYCLES_POINTS,
+                 PSYCHRO_CYCLES_POINTS);
+    UNUSED_VARIABLE(isink);
+    UNUSED_VARIABLE(fsink);
+}
+#endif
 int main(void)
 {
     ret_code_t err_code;
 
+#if FAST_BOOT_ENABLED
+    boot_timer_start(); // First thing - boot times are taken from here
+#endif
     log_init();
     bsp_board_init(BSP_INIT_LEDS);
 
@@ -416,6 +1075,13 @@ int main(void)
     NRF_LOG_FLUSH();
 
     twi_config();
+    hdc1080_config_shadow_reset();
+    acquisition_config();
+
+#if SAMPLE_STREAM_ENABLED
+    err_code = sample_stream_init(TX_PIN_NUMBER);
+    APP_ERROR_CHECK(err_code);
+#endif
 
 //    nrf_delay_ms(15); 
 //
@@ -426,21 +1092,59 @@ int main(void)
 //    NRF_LOG_RAW_INFO("\r\nResult Init Sensor: %d \r\n",result_mngr_perform);
 //    NRF_LOG_FLUSH();
 //    APP_ERROR_CHECK(result_mngr_perform);
+//    hdc1080_config_shadow_init_done();
 //
 //    nrf_delay_ms(20);
 
+#if SENSOR_POWER_GATING_ENABLED
+    nrf_gpio_cfg_output(SENSOR_POWER_PIN);
+    nrf_gpio_pin_set(SENSOR_POWER_PIN);
+#if !FAST_BOOT_ENABLED
+    nrf_delay_ms(HDC1080_STARTUP_MS);
+#endif
+#endif
+
+#if FAST_BOOT_ENABLED
+    boot_start(); // Sensor powered down after its sample is drained when gated
+#else
 // Read Temperature Register once
     read_t_and_hr();
+
+#if SENSOR_POWER_GATING_ENABLED
+    sampler_power_down();
+#endif
+#endif
     /////////////////////////////////////////
 
 
+#if BMP280_ENABLED
+    sampler_bmp280_init();
+#endif
+
     read_init(); // timer create and start
 
+#if PSYCHRO_CYCLES_ENABLED
+    psychro_cycles_log();
+#endif
+
     while (true)
     {
+        samples_drain();
+#if FAST_BOOT_ENABLED
+        boot_report();
+#endif
+
+#if LOG_FLUSH_BATCHED
+        log_flush();
+#endif
+
+        // [a record put after the queue was found empty still ends the
+        //  sleep - the interrupt sets the event register WFE waits for]
         nrf_pwr_mgmt_run();
 
+#if !LOG_FLUSH_BATCHED
         NRF_LOG_FLUSH();
+#endif
     }
 }
 
@@ -0,0 +1,64 @@
+#include <string.h>
+#include "median_filter.h"
+
+// First position in sorted[0..count) with a value not less than value.
+static uint8_t lower_bound(uint16_t const * p_sorted, uint8_t count, uint16_t value)
+{
+    uint8_t lo = 0;
+    uint8_t hi = count;
+
+    while (lo < hi)
+    {
+        uint8_t mid = (uint8_t)((lo + hi) / 2);
+
+        if (p_sorted[mid] < value)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void median_filter_init(median_filter_t * p_filter)
+{
+    memset(p_filter, 0, sizeof(*p_filter));
+}
+
+uint16_t median_filter_update(median_filter_t * p_filter, uint16_t value)
+{
+    uint16_t * p_sorted = p_filter->sorted;
+    uint8_t    count    = p_filter->count;
+    uint8_t    pos;
+
+    if (count == MEDIAN_FILTER_WINDOW)
+    {
+        // Drop the oldest value from the sorted window.
+        pos = lower_bound(p_sorted, count, p_filter->ring[p_filter->idx]);
+        count--;
+        for (uint8_t i = pos; i < count; i++)
+        {
+            p_sorted[i] = p_sorted[i + 1];
+        }
+    }
+
+    pos = lower_bound(p_sorted, count, value);
+    for (uint8_t i = count; i > pos; i--)
+    {
+        p_sorted[i] = p_sorted[i - 1];
+    }
+    p_sorted[pos] = value;
+    count++;
+
+    p_filter->ring[p_filter->idx] = value;
+    if (++p_filter->idx == MEDIAN_FILTER_WINDOW)
+    {
+        p_filter->idx = 0;
+    }
+    p_filter->count = count;
+
+    return p_sorted[count / 2];
+}
@@ -0,0 +1,42 @@
+#ifndef MEDIAN_FILTER_H__
+#define MEDIAN_FILTER_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Sliding window median over raw sensor codes.
+ *  The window is kept twice: in arrival order (to know which value leaves)
+ *  and sorted (to read the median). An update is two binary searches and two
+ *  element-by-element shift loops over at most MEDIAN_FILTER_WINDOW entries.
+ */
+#ifndef MEDIAN_FILTER_WINDOW
+#define MEDIAN_FILTER_WINDOW    5
+#endif
+
+#if (MEDIAN_FILTER_WINDOW < 3) || (MEDIAN_FILTER_WINDOW > 255) || \
+    ((MEDIAN_FILTER_WINDOW % 2) == 0)
+    #error MEDIAN_FILTER_WINDOW has to be odd and within 3..255.
+#endif
+
+typedef struct
+{
+    uint16_t ring[MEDIAN_FILTER_WINDOW];   // Arrival order
+    uint16_t sorted[MEDIAN_FILTER_WINDOW]; // Ascending
+    uint8_t  idx;                          // Oldest entry in ring
+    uint8_t  count;                        // Entries filled so far
+} median_filter_t;
+
+void median_filter_init(median_filter_t * p_filter);
+
+// Adds a value and returns the median of the window. Until the window is
+// full, the median of the values seen so far is returned.
+uint16_t median_filter_update(median_filter_t * p_filter, uint16_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEDIAN_FILTER_H__
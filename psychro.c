@@ -0,0 +1,207 @@
+#include <math.h>
+#include "psychro.h"
+
+#if PSYCHRO_TABLE_ENABLED
+#define TABLE_SIZE  (PSYCHRO_TEMP_MAX - PSYCHRO_TEMP_MIN + 1)
+
+// One entry per 1 C starting at PSYCHRO_TEMP_MIN.
+// Saturation vapour pressure over water in 0.01 Pa:
+//   es = 611.2 Pa * exp(17.62 T / (243.12 + T))
+static const uint32_t m_es_table[TABLE_SIZE] =
+{
+         1902,      2109,      2336,      2586,      2858,      3157,  // -40
+         3484,      3840,      4230,      4654,      5117,      5620,  // -34
+         6168,      6764,      7410,      8112,      8872,      9696,  // -28
+        10588,     11553,     12597,     13723,     14939,     16251,  // -22
+        17665,     19187,     20826,     22589,     24483,     26518,  // -16
+        28703,     31047,     33559,     36251,     39134,     42218,  // -10
+        45517,     49043,     52809,     56830,     61120,     65695,  // -4
+        70570,     75763,     81292,     87174,     93430,    100079,  // 2
+       107143,    114643,    122603,    131046,    139998,    149483,  // 8
+       159531,    170167,    181423,    193327,    205913,    219212,  // 14
+       233260,    248090,    263742,    280251,    297659,    316006,  // 20
+       335334,    355689,    377115,    399660,    423372,    448303,  // 26
+       474505,    502031,    530939,    561284,    593128,    626531,  // 32
+       661558,    698274,    736746,    777044,    819241,    863409,  // 38
+       909627,    957971,   1008523,   1061367,   1116588,   1174274,  // 44
+      1234516,   1297407,   1363042,   1431521,   1502945,   1577416,  // 50
+      1655043,   1735933,   1820201,   1907960,   1999329,   2094429,  // 56
+      2193384,   2296322,   2403374,   2514671,   2630353,   2750558,  // 62
+      2875431,   3005117,   3139768,   3279536,   3424580,   3575059,  // 68
+      3731139,   3892987,   4060774,   4234677,   4414874,   4601548,  // 74
+      4794885,   4995078,   5202319,   5416808,   5638748,   5868344,  // 80
+      6105808,   6351354,   6605202,   6867574,   7138699,   7418808,  // 86
+      7708137,   8006927,   8315422,   8633872,   8962532,   9301658,  // 92
+      9651514,  10012368,  10384492,  10768162,  11163660,  11571272,  // 98
+     11991289,  12424006,  12869725,  13328750,  13801392,  14287966,  // 104
+     14788791,  15304194,  15834503,  16380055,  16941188,  17518249,  // 110
+     18111587,  18721558,  19348521,  19992843,  20654895,  21335052,  // 116
+     22033696,  22751213,  23487994,  24244437,  // 122
+};
+
+// Saturation absolute humidity in 0.01 mg/m^3:
+//   2.167 g K / J * es / (T + 273.15)
+static const uint32_t m_ahs_table[TABLE_SIZE] =
+{
+        17679,     19520,     21531,     23726,     26119,     28727,  // -40
+        31566,     34653,     38009,     41651,     45603,     49886,  // -34
+        54525,     59544,     64972,     70836,     77168,     83998,  // -28
+        91360,     99291,    107828,    117010,    126880,    137480,  // -22
+       148859,    161063,    174145,    188159,    203160,    219208,  // -16
+       236366,    254697,    274272,    295160,    317436,    341180,  // -10
+       366472,    393398,    422046,    452510,    484888,    519279,  // -4
+       555789,    594528,    635610,    679154,    725284,    774127,  // 2
+       825819,    880496,    938304,    999391,   1063913,   1132031,  // 8
+      1203910,   1279724,   1359650,   1443875,   1532589,   1625990,  // 14
+      1724283,   1827680,   1936398,   2050664,   2170710,   2296778,  // 20
+      2429114,   2567975,   2713625,   2866334,   3026383,   3194060,  // 26
+      3369662,   3553494,   3745870,   3947113,   4157555,   4377538,  // 32
+      4607413,   4847538,   5098286,   5360034,   5633173,   5918102,  // 38
+      6215232,   6524982,   6847784,   7184078,   7534318,   7898965,  // 44
+      8278495,   8673393,   9084155,   9511289,   9955315,  10416764,  // 50
+     10896180,  11394117,  11911143,  12447836,  13004789,  13582605,  // 56
+     14181900,  14803304,  15447458,  16115017,  16806648,  17523032,  // 62
+     18264863,  19032846,  19827703,  20650166,  21500983,  22380914,  // 68
+     23290733,  24231229,  25203202,  26207468,  27244857,  28316211,  // 74
+     29422389,  30564263,  31742717,  32958651,  34212981,  35506635,  // 80
+     36840555,  38215699,  39633039,  41093562,  42598267,  44148172,  // 86
+     45744304,  47387710,  49079449,  50820593,  52612233,  54455471,  // 92
+     56351425,  58301228,  60306027,  62366983,  64485274,  66662092,  // 98
+     68898641,  71196142,  73555831,  75978958,  78466788,  81020598,  // 104
+     83641683,  86331350,  89090923,  91921738,  94825146,  97802514,  // 110
+    100855220, 103984660, 107192241, 110479387, 113847533, 117298130,  // 116
+    120832643, 124452550, 128159343, 131954529,  // 122
+};
+
+static uint32_t table_interp(uint32_t const * p_table, int32_t temp_centi)
+{
+    if (temp_centi <= PSYCHRO_TEMP_MIN * 100)
+    {
+        return p_table[0];
+    }
+    if (temp_centi >= PSYCHRO_TEMP_MAX * 100)
+    {
+        return p_table[TABLE_SIZE - 1];
+    }
+
+    uint32_t offset = (uint32_t)(temp_centi - PSYCHRO_TEMP_MIN * 100);
+    uint32_t idx    = offset / 100;
+    uint32_t frac   = offset % 100;
+
+    return p_table[idx] + ((p_table[idx + 1] - p_table[idx]) * frac + 50) / 100;
+}
+
+// Relative humidity as a 16-bit fraction (the HDC1080 raw code format).
+static uint32_t rh_q16(uint16_t rh_centi)
+{
+    if (rh_centi >= 10000)
+    {
+        return 65536;
+    }
+    // 65536 / 10000 = 53687 / 8192 (error < 2e-6)
+    return ((uint32_t)rh_centi * 53687u) >> 13;
+}
+
+int16_t psychro_dew_point(int16_t temp_centi, uint16_t rh_centi)
+{
+    // [64-bit multiply and shift only, no 64-bit division]
+    uint32_t e = (uint32_t)(((uint64_t)table_interp(m_es_table, temp_centi) *
+                             rh_q16(rh_centi)) >> 16);
+
+    if (e <= m_es_table[0])
+    {
+        return PSYCHRO_TEMP_MIN * 100;
+    }
+
+    // Last entry not above e - the dew point never exceeds the temperature.
+    uint32_t lo = 0;
+    uint32_t hi = TABLE_SIZE - 1;
+
+    if (temp_centi < PSYCHRO_TEMP_MAX * 100)
+    {
+        hi = (uint32_t)(temp_centi - PSYCHRO_TEMP_MIN * 100 + 99) / 100;
+    }
+
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi + 1) / 2;
+
+        if (m_es_table[mid] <= e)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+    if (lo == TABLE_SIZE - 1)
+    {
+        return PSYCHRO_TEMP_MAX * 100;
+    }
+
+    uint32_t span = m_es_table[lo + 1] - m_es_table[lo];
+    uint32_t frac = ((e - m_es_table[lo]) * 100 + span / 2) / span;
+
+    return (int16_t)((int32_t)(lo * 100 + frac) + PSYCHRO_TEMP_MIN * 100);
+}
+
+uint32_t psychro_abs_humidity(int16_t temp_centi, uint16_t rh_centi)
+{
+    uint64_t ah = (uint64_t)table_interp(m_ahs_table, temp_centi) * rh_q16(rh_centi);
+
+    // 0.01 mg/m^3 * 2^16 -> mg/m^3
+    return (uint32_t)((ah + (50u << 16)) >> 16) / 100;
+}
+
+#else // PSYCHRO_TABLE_ENABLED
+
+#define MAGNUS_B    17.62f
+#define MAGNUS_C    243.12f     // C
+
+static float temp_clamped(int16_t temp_centi)
+{
+    if (temp_centi <= PSYCHRO_TEMP_MIN * 100)
+    {
+        return PSYCHRO_TEMP_MIN;
+    }
+    if (temp_centi >= PSYCHRO_TEMP_MAX * 100)
+    {
+        return PSYCHRO_TEMP_MAX;
+    }
+    return temp_centi / 100.0f;
+}
+
+static float rh_fraction(uint16_t rh_centi)
+{
+    return (rh_centi >= 10000) ? 1.0f : rh_centi / 10000.0f;
+}
+
+int16_t psychro_dew_point(int16_t temp_centi, uint16_t rh_centi)
+{
+    if (rh_centi == 0)
+    {
+        return PSYCHRO_TEMP_MIN * 100;
+    }
+
+    float t  = temp_clamped(temp_centi);
+    float g  = logf(rh_fraction(rh_centi)) + MAGNUS_B * t / (MAGNUS_C + t);
+    float td = MAGNUS_C * g / (MAGNUS_B - g);
+
+    if (td <= PSYCHRO_TEMP_MIN)
+    {
+        return PSYCHRO_TEMP_MIN * 100;
+    }
+    return (int16_t)lroundf(td * 100.0f);
+}
+
+uint32_t psychro_abs_humidity(int16_t temp_centi, uint16_t rh_centi)
+{
+    float t = temp_clamped(temp_centi);
+    float e = rh_fraction(rh_centi) * 611.2f * expf(MAGNUS_B * t / (MAGNUS_C + t));
+
+    // 2.167 g K / J * e / T, in mg/m^3
+    return (uint32_t)lroundf(2167.0f * e / (t + 273.15f));
+}
+
+#endif // PSYCHRO_TABLE_ENABLED
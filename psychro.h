@@ -0,0 +1,43 @@
+#ifndef PSYCHRO_H__
+#define PSYCHRO_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Dew point and absolute humidity from the Magnus formula (b = 17.62,
+ *  c = 243.12 C), computed with logf()/expf() in single precision.
+ *  Temperatures are in 0.01 C, relative humidity in 0.01 %. Temperatures
+ *  are clamped to PSYCHRO_TEMP_MIN..PSYCHRO_TEMP_MAX.
+ *
+ *  With PSYCHRO_TABLE_ENABLED the saturation vapour pressure is tabled in
+ *  1 C steps instead and interpolated linearly, and the dew point is found
+ *  by a binary search in the same table. Only 32-bit divisions and 32x32->64
+ *  bit multiplies are used; the tables take 1328 bytes of flash. Error
+ *  against the double precision formula: < 0.03 C dew point, < 0.15 %
+ *  absolute humidity above 1 g/m^3 (see tools/bench_psychro.c).
+ *  [not the default - it has not been shown to be faster or smaller than
+ *   logf()/expf() on the target, PSYCHRO_CYCLES_ENABLED in main.c counts
+ *   the cycles of both]
+ */
+#ifndef PSYCHRO_TABLE_ENABLED
+#define PSYCHRO_TABLE_ENABLED   0
+#endif
+
+#define PSYCHRO_TEMP_MIN    (-40)
+#define PSYCHRO_TEMP_MAX    125
+
+// Dew point in 0.01 C. Clamped to PSYCHRO_TEMP_MIN when the dew point lies
+// below the table and for 0 % relative humidity.
+int16_t psychro_dew_point(int16_t temp_centi, uint16_t rh_centi);
+
+// Absolute humidity in mg/m^3.
+uint32_t psychro_abs_humidity(int16_t temp_centi, uint16_t rh_centi);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PSYCHRO_H__
@@ -0,0 +1,58 @@
+#ifndef SAMPLE_H__
+#define SAMPLE_H__
+
+#include <stdint.h>
+#include "window_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SAMPLE_FLAG_HEATER      0x01 // Heater was active during the conversion
+#define SAMPLE_FLAG_PRESSURE    0x02 // press_raw and ptemp_raw are valid
+#define SAMPLE_FLAG_ERROR       0x04 // The read failed, no codes
+#define SAMPLE_FLAG_NO_TIME     0x08 // t_trigger and t_done are not valid
+
+/** One HDC1080 reading as delivered by the acquisition, fused with the
+ *  BMP280 measurement taken in the same conversion window when
+ *  SAMPLE_FLAG_PRESSURE is set.
+ *  The raw register codes are kept; conversion to engineering units is left
+ *  to the consumers. Timestamps come from timestamp_get().
+ */
+typedef struct
+{
+    uint32_t t_trigger; // Conversion triggered
+    uint32_t t_done;    // Result read
+    uint16_t temp_raw;
+    uint16_t hum_raw;
+    uint32_t press_raw; // BMP280 20-bit ADC codes
+    uint32_t ptemp_raw;
+    uint8_t  flags;
+} sample_record_t;
+
+// BMP280 codes in the summaries - the 16 upper bits of the 20-bit ADC codes,
+// the fraction bits of the mean keep the resolution lost on the way.
+#define SAMPLE_SUMMARY_PRESS_SHIFT  4
+
+/** Statistics of the HDC1080 codes over a window of samples (see
+ *  window_stats.h). Samples taken with the heater on are not included,
+ *  only flagged. The BMP280 codes of the samples with SAMPLE_FLAG_PRESSURE
+ *  are kept alongside, heater samples included - the heater only warms the
+ *  HDC1080 die.
+ */
+typedef struct
+{
+    uint32_t       t_first; // t_trigger of the first and last sample
+    uint32_t       t_last;
+    window_stats_t temp;
+    window_stats_t hum;
+    window_stats_t press;   // >> SAMPLE_SUMMARY_PRESS_SHIFT, SAMPLE_FLAG_PRESSURE only
+    window_stats_t ptemp;
+    uint8_t        flags;   // SAMPLE_FLAG_HEATER, _PRESSURE, _NO_TIME if any sample had it
+} sample_summary_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAMPLE_H__
@@ -0,0 +1,99 @@
+#include <math.h>
+#include <string.h>
+#include "sample_proc.h"
+#include "hdc1080.h"
+#include "psychro.h"
+
+void sample_proc_init(sample_proc_t *              p_proc,
+                      sample_proc_config_t const * p_config,
+                      sample_proc_ring_t *         p_ring)
+{
+    memset(p_proc, 0, sizeof(*p_proc));
+    p_proc->config = *p_config;
+
+    median_filter_init(&p_proc->temp_median);
+    median_filter_init(&p_proc->hum_median);
+    if (p_proc->config.ema)
+    {
+        ema_filter_init(&p_proc->avg.ema.temp);
+        ema_filter_init(&p_proc->avg.ema.hum);
+    }
+    else
+    {
+        memset(p_ring, 0, sizeof(*p_ring));
+        p_proc->avg.mean.p_ring = p_ring;
+    }
+}
+
+bool sample_proc_update(sample_proc_t *         p_proc,
+                        sample_record_t const * p_record,
+                        sample_proc_result_t *  p_result)
+{
+    if (p_record->flags & SAMPLE_FLAG_ERROR)
+    {
+        return false;
+    }
+
+    // Samples taken with a warm die are reported but kept out of the average.
+    if (p_record->flags & SAMPLE_FLAG_HEATER)
+    {
+        p_proc->fresh = 0;
+        return false;
+    }
+    if (p_proc->fresh < SAMPLE_PROC_WINDOW)
+    {
+        p_proc->fresh++;
+    }
+
+    uint16_t temp_raw = p_record->temp_raw;
+    uint16_t hum_raw  = p_record->hum_raw;
+
+    if (p_proc->config.median)
+    {
+        temp_raw = median_filter_update(&p_proc->temp_median, temp_raw);
+        hum_raw  = median_filter_update(&p_proc->hum_median, hum_raw);
+    }
+
+    if (p_proc->config.ema)
+    {
+        p_result->temp = HDC1080_TEMP_FROM_RAW(ema_filter_update(&p_proc->avg.ema.temp, temp_raw));
+        p_result->hum  = HDC1080_HUM_FROM_RAW(ema_filter_update(&p_proc->avg.ema.hum, hum_raw));
+    }
+    else
+    {
+        sample_proc_ring_t * p_ring = p_proc->avg.mean.p_ring;
+        uint8_t              idx    = p_proc->avg.mean.idx;
+
+        p_proc->avg.mean.temp_sum  -= p_ring->temp[idx];
+        p_proc->avg.mean.hum_sum   -= p_ring->hum[idx];
+
+        p_ring->temp[idx]  = HDC1080_TEMP_FROM_RAW(temp_raw);
+        p_ring->hum[idx]   = HDC1080_HUM_FROM_RAW(hum_raw);
+
+        p_proc->avg.mean.temp_sum  += p_ring->temp[idx];
+        p_proc->avg.mean.hum_sum   += p_ring->hum[idx];
+
+        if (++p_proc->avg.mean.idx >= SAMPLE_PROC_WINDOW)
+        {
+            p_proc->avg.mean.idx = 0;
+        }
+
+        p_result->temp = p_proc->avg.mean.temp_sum / SAMPLE_PROC_WINDOW;
+        p_result->hum  = p_proc->avg.mean.hum_sum / SAMPLE_PROC_WINDOW;
+    }
+    p_result->temp_raw = temp_raw;
+    p_result->hum_raw  = hum_raw;
+
+    int16_t  temp_centi = (int16_t)lroundf(p_result->temp * 100.0f);
+    uint16_t rh_centi   = (uint16_t)lroundf(p_result->hum * 100.0f);
+
+    p_result->dew_point    = psychro_dew_point(temp_centi, rh_centi);
+    p_result->abs_humidity = psychro_abs_humidity(temp_centi, rh_centi);
+
+    // Condensation recovery - the die is heated when the sensor saturates.
+    // [not before the window holds fresh samples only - the average would
+    //  still be that of the saturated sensor ahead of the last cycle]
+    p_result->heater_due = (p_proc->fresh >= SAMPLE_PROC_WINDOW &&
+                            p_result->hum >= p_proc->config.heater_rh);
+    return true;
+}
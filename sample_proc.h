@@ -0,0 +1,94 @@
+#ifndef SAMPLE_PROC_H__
+#define SAMPLE_PROC_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sample.h"
+#include "median_filter.h"
+#include "ema_filter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Processing of the acquired samples, in the main loop: optional median
+ *  filter on the raw codes, averaging (window mean or EMA), dew point and
+ *  absolute humidity from the average (psychro.h), and the check of the
+ *  averaged humidity against the heater threshold.
+ *  Failed reads and samples taken with the heater on are not processed.
+ *  The heater check only calls for a cycle once SAMPLE_PROC_WINDOW samples
+ *  have been processed since the start, or since the last heater sample -
+ *  the average holds no values from before the last cycle then, and a
+ *  sensor that is still saturated is not heated again right away.
+ *  The sample ring of the window mean is provided by the caller, so a build
+ *  that averages with the EMA does not allocate it. The remaining state of
+ *  the two averages shares its memory, only the one picked by config.ema is
+ *  used.
+ */
+#ifndef SAMPLE_PROC_WINDOW
+#define SAMPLE_PROC_WINDOW  16  // Samples in the window mean
+#endif
+
+typedef struct
+{
+    bool  median;       // Median filter ahead of the averaging
+    bool  ema;          // EMA instead of the window mean
+    float heater_rh;    // Averaged humidity that calls for a heater cycle, %
+} sample_proc_config_t;
+
+typedef struct
+{
+    float    temp;          // Averaged, in °C
+    float    hum;           // Averaged, in %
+    int16_t  dew_point;     // in 0.01 °C
+    uint32_t abs_humidity;  // in mg/m^3
+    uint16_t temp_raw;      // Codes that went into the average
+    uint16_t hum_raw;
+    bool     heater_due;    // hum at or above heater_rh, average settled
+} sample_proc_result_t;
+
+typedef struct
+{
+    float temp[SAMPLE_PROC_WINDOW];
+    float hum[SAMPLE_PROC_WINDOW];
+} sample_proc_ring_t;
+
+typedef struct
+{
+    sample_proc_config_t config;
+    median_filter_t      temp_median;
+    median_filter_t      hum_median;
+    union
+    {
+        struct
+        {
+            sample_proc_ring_t * p_ring;
+            float                temp_sum;
+            float                hum_sum;
+            uint8_t              idx;
+        } mean;                     // config.ema false
+        struct
+        {
+            ema_filter_t temp;
+            ema_filter_t hum;
+        } ema;                      // config.ema true
+    } avg;
+    uint8_t              fresh;     // Processed since the last heater sample
+} sample_proc_t;
+
+// p_ring is only used with config.ema false and may be NULL otherwise.
+void sample_proc_init(sample_proc_t *              p_proc,
+                      sample_proc_config_t const * p_config,
+                      sample_proc_ring_t *         p_ring);
+
+// Returns false for records that are not processed (read error, heater),
+// p_result is left as it is then.
+bool sample_proc_update(sample_proc_t *         p_proc,
+                        sample_record_t const * p_record,
+                        sample_proc_result_t *  p_result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAMPLE_PROC_H__
@@ -0,0 +1,54 @@
+#include "sample_queue.h"
+#include "nrf.h"
+
+#define MASK    (SAMPLE_QUEUE_SIZE - 1)
+
+void sample_queue_init(sample_queue_t * p_queue)
+{
+    p_queue->head      = 0;
+    p_queue->tail      = 0;
+    p_queue->overflows = 0;
+}
+
+bool sample_queue_put(sample_queue_t * p_queue, sample_record_t const * p_record)
+{
+    uint32_t head = p_queue->head;
+
+    // [unsigned difference - correct across the wrap of the indices]
+    if (head - p_queue->tail >= SAMPLE_QUEUE_SIZE)
+    {
+        p_queue->overflows++;
+        return false;
+    }
+
+    p_queue->records[head & MASK] = *p_record;
+
+    // The record has to be complete before the consumer can see it.
+    __DMB();
+    p_queue->head = head + 1;
+    return true;
+}
+
+bool sample_queue_get(sample_queue_t * p_queue, sample_record_t * p_record)
+{
+    uint32_t tail = p_queue->tail;
+
+    if (p_queue->head == tail)
+    {
+        return false;
+    }
+
+    // Not ahead of head - the record read must not be older than the index.
+    __DMB();
+    *p_record = p_queue->records[tail & MASK];
+
+    // And taken before the slot is handed back to the producer.
+    __DMB();
+    p_queue->tail = tail + 1;
+    return true;
+}
+
+uint32_t sample_queue_overflows_get(sample_queue_t const * p_queue)
+{
+    return p_queue->overflows;
+}
@@ -0,0 +1,51 @@
+#ifndef SAMPLE_QUEUE_H__
+#define SAMPLE_QUEUE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sample.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Single producer, single consumer ring of complete sample records - from
+ *  the acquisition callbacks (interrupt context) to the main loop.
+ *  head is only written by the producer and tail only by the consumer, both
+ *  run freely and are masked on access, so neither side ever waits for the
+ *  other and interrupts are never disabled. A memory barrier orders the
+ *  record against the index that publishes or releases it.
+ *  A full queue drops the new record and counts it.
+ */
+#ifndef SAMPLE_QUEUE_SIZE
+#define SAMPLE_QUEUE_SIZE   8   // Records, a power of two
+#endif
+
+#if (SAMPLE_QUEUE_SIZE & (SAMPLE_QUEUE_SIZE - 1)) != 0
+    #error SAMPLE_QUEUE_SIZE has to be a power of two.
+#endif
+
+typedef struct
+{
+    sample_record_t   records[SAMPLE_QUEUE_SIZE];
+    volatile uint32_t head;         // Records put, producer only
+    volatile uint32_t tail;         // Records taken, consumer only
+    volatile uint32_t overflows;    // Records dropped, producer only
+} sample_queue_t;
+
+void sample_queue_init(sample_queue_t * p_queue);
+
+// Producer side. Returns false, and counts an overflow, if the queue is full.
+bool sample_queue_put(sample_queue_t * p_queue, sample_record_t const * p_record);
+
+// Consumer side. Returns false if the queue is empty.
+bool sample_queue_get(sample_queue_t * p_queue, sample_record_t * p_record);
+
+// Records dropped since sample_queue_init(), safe from either side.
+uint32_t sample_queue_overflows_get(sample_queue_t const * p_queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAMPLE_QUEUE_H__
@@ -0,0 +1,192 @@
+#include <string.h>
+#include "sample_stream.h"
+#include "cobs.h"
+#include "nrfx_uarte.h"
+#include "app_util_platform.h"
+#include "app_error.h"
+
+#define RECORD_MAX  SAMPLE_STREAM_SUMMARY_FUSED_SIZE
+#define FRAME_MAX   (COBS_ENCODED_MAX(RECORD_MAX) + 1)
+
+static nrfx_uarte_t const m_uarte = NRFX_UARTE_INSTANCE(0);
+
+// [EasyDMA reads straight from these - they must be in RAM]
+static uint8_t  m_tx_buffers[2][SAMPLE_STREAM_BUFFER_SIZE];
+static uint16_t m_fill[2];
+static uint8_t  m_active;   // Buffer collecting records
+static bool     m_tx_busy;  // The other buffer is being sent
+static uint16_t m_sequence;
+
+static sample_stream_stats_t m_stats;
+
+static uint8_t crc8(uint8_t const * p_data, size_t len)
+{
+    uint8_t crc = 0;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        crc ^= p_data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void put_u16(uint8_t * p_dst, uint16_t value)
+{
+    p_dst[0] = (uint8_t)value;
+    p_dst[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u24(uint8_t * p_dst, uint32_t value)
+{
+    put_u16(&p_dst[0], (uint16_t)value);
+    p_dst[2] = (uint8_t)(value >> 16);
+}
+
+static void put_u32(uint8_t * p_dst, uint32_t value)
+{
+    put_u16(&p_dst[0], (uint16_t)value);
+    put_u16(&p_dst[2], (uint16_t)(value >> 16));
+}
+
+// Must be called with interrupts masked.
+static void tx_start(void)
+{
+    uint8_t idx = m_active;
+
+    if (m_tx_busy || m_fill[idx] == 0)
+    {
+        return;
+    }
+
+    m_tx_busy         = true;
+    m_active          = idx ^ 1;
+    m_fill[m_active]  = 0;
+    m_stats.wire_bytes += m_fill[idx];
+
+    APP_ERROR_CHECK(nrfx_uarte_tx(&m_uarte, m_tx_buffers[idx], m_fill[idx]));
+}
+
+static void uarte_event_handler(nrfx_uarte_event_t const * p_event, void * p_context)
+{
+    switch (p_event->type)
+    {
+    case NRFX_UARTE_EVT_TX_DONE:
+    case NRFX_UARTE_EVT_ERROR:
+        CRITICAL_REGION_ENTER();
+        m_tx_busy = false;
+        tx_start();
+        CRITICAL_REGION_EXIT();
+        break;
+
+    default:
+        break;
+    }
+}
+
+ret_code_t sample_stream_init(uint32_t tx_pin)
+{
+    nrfx_uarte_config_t config = NRFX_UARTE_DEFAULT_CONFIG;
+
+    config.pseltxd = tx_pin;
+    config.pselrxd = NRF_UARTE_PSEL_DISCONNECTED;
+
+    return nrfx_uarte_init(&m_uarte, &config, uarte_event_handler);
+}
+
+// Adds the CRC, encodes and queues a record; the sequence number is taken
+// here so that records of all types share it.
+static void record_put(uint8_t * p_record, size_t record_len)
+{
+    uint8_t frame[FRAME_MAX];
+    size_t  frame_len;
+
+    put_u16(&p_record[1], m_sequence++);
+    p_record[record_len - 1] = crc8(p_record, record_len - 1);
+
+    frame_len          = cobs_encode(p_record, record_len, frame);
+    frame[frame_len++] = 0x00;
+
+    CRITICAL_REGION_ENTER();
+    uint8_t idx = m_active;
+
+    if (m_fill[idx] + frame_len <= SAMPLE_STREAM_BUFFER_SIZE)
+    {
+        memcpy(&m_tx_buffers[idx][m_fill[idx]], frame, frame_len);
+        m_fill[idx]           += frame_len;
+        m_stats.records       += 1;
+        m_stats.payload_bytes += record_len;
+        tx_start();
+    }
+    else
+    {
+        m_stats.dropped++;
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+void sample_stream_put(sample_record_t const * p_record)
+{
+    uint8_t record[SAMPLE_STREAM_FUSED_SIZE];
+    size_t  record_len;
+
+    record[0] = SAMPLE_STREAM_RECORD_SAMPLE;
+    put_u32(&record[3],  p_record->t_trigger);
+    put_u32(&record[7],  p_record->t_done);
+    put_u16(&record[11], p_record->temp_raw);
+    put_u16(&record[13], p_record->hum_raw);
+    record[15] = p_record->flags;
+    record_len = SAMPLE_STREAM_RECORD_SIZE;
+
+    if (p_record->flags & SAMPLE_FLAG_PRESSURE)
+    {
+        record[0] = SAMPLE_STREAM_RECORD_FUSED;
+        put_u24(&record[16], p_record->press_raw);
+        put_u24(&record[19], p_record->ptemp_raw);
+        record_len = SAMPLE_STREAM_FUSED_SIZE;
+    }
+    record_put(record, record_len);
+}
+
+static void stats_put(uint8_t * p_dst, window_stats_t const * p_stats)
+{
+    put_u16(&p_dst[0], p_stats->min);
+    put_u16(&p_dst[2], p_stats->max);
+    put_u24(&p_dst[4], window_stats_mean_get(p_stats));
+    put_u32(&p_dst[7], window_stats_variance_get(p_stats));
+}
+
+void sample_stream_summary_put(sample_summary_t const * p_summary)
+{
+    uint8_t record[SAMPLE_STREAM_SUMMARY_FUSED_SIZE];
+    size_t  record_len;
+
+    record[0] = SAMPLE_STREAM_RECORD_SUMMARY;
+    put_u32(&record[3],  p_summary->t_first);
+    put_u32(&record[7],  p_summary->t_last);
+    put_u16(&record[11], p_summary->temp.count);
+    stats_put(&record[13], &p_summary->temp);
+    stats_put(&record[24], &p_summary->hum);
+    record[35] = p_summary->flags;
+    record_len = SAMPLE_STREAM_SUMMARY_SIZE;
+
+    if (p_summary->flags & SAMPLE_FLAG_PRESSURE)
+    {
+        record[0] = SAMPLE_STREAM_RECORD_SUMMARY_FUSED;
+        put_u16(&record[36], p_summary->press.count);
+        stats_put(&record[38], &p_summary->press);
+        stats_put(&record[49], &p_summary->ptemp);
+        record_len = SAMPLE_STREAM_SUMMARY_FUSED_SIZE;
+    }
+    record_put(record, record_len);
+}
+
+void sample_stream_stats_get(sample_stream_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_stats;
+    CRITICAL_REGION_EXIT();
+}
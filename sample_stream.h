@@ -0,0 +1,95 @@
+#ifndef SAMPLE_STREAM_H__
+#define SAMPLE_STREAM_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "sample.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Binary sample streaming over UARTE.
+ *  Every record is COBS encoded and terminated by 0x00. Records are
+ *  collected in one of two buffers while the other one is sent by EasyDMA,
+ *  so the CPU only wakes up to swap buffers.
+ *
+ *  Record layout (little endian, before COBS):
+ *    0      type (SAMPLE_STREAM_RECORD_SAMPLE)
+ *    1..2   sequence number
+ *    3..6   t_trigger
+ *    7..10  t_done
+ *    11..12 raw temperature
+ *    13..14 raw humidity
+ *    15     flags
+ *    16     CRC-8 (poly 0x07) of bytes 0..15
+ *
+ *  Samples with SAMPLE_FLAG_PRESSURE go out as SAMPLE_STREAM_RECORD_FUSED,
+ *  which inserts the two BMP280 ADC codes (3 bytes each) after the flags:
+ *    16..18 raw pressure
+ *    19..21 raw temperature (BMP280)
+ *    22     CRC-8 of bytes 0..21
+ *
+ *  Window summaries (sample_stream_summary_put()) are
+ *  SAMPLE_STREAM_RECORD_SUMMARY:
+ *    0      type
+ *    1..2   sequence number
+ *    3..6   t_first
+ *    7..10  t_last
+ *    11..12 number of samples in the statistics
+ *    13..14 temperature min     24..25 humidity min
+ *    15..16 temperature max     26..27 humidity max
+ *    17..19 temperature mean    28..30 humidity mean (codes, 8 fraction bits)
+ *    20..23 temperature var     31..34 humidity var (codes^2)
+ *    35     flags
+ *    36     CRC-8 of bytes 0..35
+ *
+ *  Summaries with SAMPLE_FLAG_PRESSURE go out as
+ *  SAMPLE_STREAM_RECORD_SUMMARY_FUSED, which inserts the statistics of the
+ *  BMP280 codes (>> SAMPLE_SUMMARY_PRESS_SHIFT) after the flags:
+ *    36..37 number of samples with pressure
+ *    38..48 pressure min, max, mean, var (same layout as above)
+ *    49..59 temperature (BMP280) min, max, mean, var
+ *    60     CRC-8 of bytes 0..59
+ */
+#define SAMPLE_STREAM_RECORD_SAMPLE     0x01
+#define SAMPLE_STREAM_RECORD_SIZE       17
+
+#define SAMPLE_STREAM_RECORD_FUSED      0x02
+#define SAMPLE_STREAM_FUSED_SIZE        23
+
+#define SAMPLE_STREAM_RECORD_SUMMARY    0x03
+#define SAMPLE_STREAM_SUMMARY_SIZE      37
+
+#define SAMPLE_STREAM_RECORD_SUMMARY_FUSED  0x04
+#define SAMPLE_STREAM_SUMMARY_FUSED_SIZE    61
+
+// Size of each of the two transmit buffers.
+#ifndef SAMPLE_STREAM_BUFFER_SIZE
+#define SAMPLE_STREAM_BUFFER_SIZE       128
+#endif
+
+typedef struct
+{
+    uint32_t records;       // Records queued for transmission
+    uint32_t dropped;       // Records lost because both buffers were full
+    uint32_t payload_bytes; // Record bytes before encoding
+    uint32_t wire_bytes;    // Bytes handed to UARTE (COBS and delimiter included)
+} sample_stream_stats_t;
+
+ret_code_t sample_stream_init(uint32_t tx_pin);
+
+// May be called from interrupt context with a priority at or below the
+// UARTE interrupt priority.
+void sample_stream_put(sample_record_t const * p_record);
+
+// Same context rules as sample_stream_put().
+void sample_stream_summary_put(sample_summary_t const * p_summary);
+
+void sample_stream_stats_get(sample_stream_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAMPLE_STREAM_H__
@@ -0,0 +1,562 @@
+#include "sampler.h"
+#include "hdc1080.h"
+#include "hdc1080_heater.h"
+#include "app_timer.h"
+#include "app_error.h"
+#include "app_util_platform.h"
+#include "task_timer.h"
+#include "timestamp.h"
+#include "nrf_log.h"
+
+static sampler_config_t const * mp_config;
+
+APP_TIMER_DEF(m_conversion_timer);
+APP_TIMER_DEF(m_power_timer);
+static task_timer_t m_conversion_task;
+static task_timer_t m_power_task;
+
+// Sample being acquired - timestamps are taken when the conversion has been
+// triggered and when its result has been read. Only touched by the
+// acquisition callbacks.
+static sample_record_t m_record;
+static uint8_t         m_ready_polls; // Reads NACKed since the trigger
+static bool            m_powered = true;
+static volatile bool   m_busy;        // From the tick to the record
+
+// temperature and relative humidity, T: bytes 0 and 1; HR: bytes 2 and 3
+static uint8_t m_temp_and_hr_buffer[4];
+
+static nrf_twi_mngr_transfer_t const transfer_write_temp[] =
+{
+    HDC1080_WRITE_T_AND_HR(&hdc1080_temp_reg_addr)
+};
+
+static nrf_twi_mngr_transfer_t const transfer_read_temp[] =
+{
+    HDC1080_READ_T_AND_HR(&m_temp_and_hr_buffer)
+};
+
+static bool           m_bmp280_ready;
+static bool           m_bmp280_fresh;   // Normal mode read done since the trigger
+static uint8_t        m_bmp280_id;
+static uint8_t        m_bmp280_calib[BMP280_CALIB_SIZE]; // Read once at start-up
+static uint8_t        m_bmp280_data[BMP280_DATA_SIZE];
+static bmp280_calib_t m_bmp280_calib_params;             // Parsed once in bmp280_probe_cb
+
+// [HDC1080 trigger last - its pointer write is not followed by a STOP]
+static nrf_twi_mngr_transfer_t const transfer_write_fused[] =
+{
+    BMP280_WRITE_FORCED(),
+    HDC1080_WRITE_T_AND_HR(&hdc1080_temp_reg_addr)
+};
+
+static nrf_twi_mngr_transfer_t const transfer_read_fused[] =
+{
+    HDC1080_READ_T_AND_HR(&m_temp_and_hr_buffer),
+    BMP280_READ_PRESS_TEMP(m_bmp280_data)
+};
+
+static uint16_t               m_boot_polls;   // NACKed attempts
+static sampler_boot_handler_t m_boot_handler;
+static bool                   m_boot_retry;   // NACKs are passed on, not results
+static void                (* m_boot_step)(void); // NACKed, to be repeated
+
+static void timer_start_once(app_timer_id_t timer_id, task_timer_t * p_task, uint32_t ticks)
+{
+    if (mp_config->task_timer)
+    {
+        APP_ERROR_CHECK(task_timer_start(p_task, ticks, 0, NULL));
+    }
+    else
+    {
+        APP_ERROR_CHECK(app_timer_start(timer_id, ticks, NULL));
+    }
+}
+
+static uint32_t record_time(void)
+{
+    return mp_config->untimed ? 0 : timestamp_get();
+}
+
+static void schedule(nrf_twi_mngr_transaction_t const * p_transaction)
+{
+    APP_ERROR_CHECK(nrf_twi_mngr_schedule(mp_config->p_twi, p_transaction));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// BMP280 - pressure and temperature
+//
+static void bmp280_read_cb(ret_code_t result, void * p_user_data)
+{
+    if (result != NRF_SUCCESS)
+    {
+        NRF_LOG_WARNING("bmp280_read_cb - error: %d", (int)result);
+        return;
+    }
+    m_bmp280_fresh = true;
+}
+
+static void bmp280_init_cb(ret_code_t result, void * p_user_data)
+{
+    if (result != NRF_SUCCESS)
+    {
+        NRF_LOG_WARNING("bmp280_init_cb - error: %d", (int)result);
+        return;
+    }
+    m_bmp280_ready = true;
+}
+
+static void bmp280_probe_cb(ret_code_t result, void * p_user_data)
+{
+    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND init =
+    {
+        .callback            = bmp280_init_cb,
+        .p_user_data         = NULL,
+        .p_transfers         = bmp280_init_transfers,
+        .number_of_transfers = BMP280_INIT_TRANSFER_COUNT
+    };
+
+    // Nothing is written to a device that is not a BMP280.
+    if (result != NRF_SUCCESS || m_bmp280_id != BMP280_CHIP_ID)
+    {
+        NRF_LOG_WARNING("bmp280_probe_cb - error: %d, id: %x", (int)result, m_bmp280_id);
+        return;
+    }
+
+    // The trimming parameters never change, they are not read again.
+    bmp280_calib_parse(m_bmp280_calib, &m_bmp280_calib_params);
+    schedule(&init);
+}
+
+void sampler_bmp280_init(void)
+{
+    static nrf_twi_mngr_transfer_t const transfers[] =
+    {
+        BMP280_READ_ID(&m_bmp280_id),
+        BMP280_READ_CALIB(m_bmp280_calib)
+    };
+    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND probe =
+    {
+        .callback            = bmp280_probe_cb,
+        .p_user_data         = NULL,
+        .p_transfers         = transfers,
+        .number_of_transfers = sizeof(transfers) / sizeof(transfers[0])
+    };
+
+    // The configuration is written from bmp280_probe_cb(), once the ID has
+    // been checked.
+    schedule(&probe);
+}
+
+bmp280_calib_t const * sampler_bmp280_calib_get(void)
+{
+    return m_bmp280_ready ? &m_bmp280_calib_params : NULL;
+}
+
+// Normal mode - the last measurement, read alongside the HDC1080 sample.
+static void bmp280_read(void)
+{
+    static nrf_twi_mngr_transfer_t const transfers[] =
+    {
+        BMP280_READ_PRESS_TEMP(m_bmp280_data)
+    };
+    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND transaction =
+    {
+        .callback            = bmp280_read_cb,
+        .p_user_data         = NULL,
+        .p_transfers         = transfers,
+        .number_of_transfers = sizeof(transfers) / sizeof(transfers[0])
+    };
+
+    m_bmp280_fresh = false;
+    schedule(&transaction);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Power switching of the HDC1080
+//
+static void read_all(void);
+static void sample_complete(ret_code_t result);
+
+void sampler_power_down(void)
+{
+    mp_config->power_set(false);
+    m_powered = false;
+
+    // The configuration register is at its reset value after the next
+    // power-up.
+    hdc1080_config_shadow_reset();
+}
+
+void sampler_power_release(void)
+{
+    if (mp_config->power_set == NULL)
+    {
+        return;
+    }
+
+    CRITICAL_REGION_ENTER();
+    // A heater cycle keeps the sensor powered until it is over.
+    // [a tick since the record has started the next sample - the release
+    //  after its record powers down]
+    if (m_powered && !m_busy && !hdc1080_heater_is_active())
+    {
+        sampler_power_down();
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+static void sensor_init_cb(ret_code_t result, void * p_user_data)
+{
+    if (result != NRF_SUCCESS)
+    {
+        NRF_LOG_WARNING("sensor_init_cb - error: %d", (int)result);
+        sampler_power_down();
+
+        // [the tick still gets its record - the history stays aligned with
+        //  the time and the power can be released]
+        m_record.flags     = mp_config->untimed ? SAMPLE_FLAG_NO_TIME : 0;
+        m_record.t_trigger = record_time();
+        m_record.t_done    = m_record.t_trigger;
+        sample_complete(result);
+        return;
+    }
+
+    read_all();
+}
+
+static void power_timer_handler(void * p_context)
+{
+    // Start-up time is over, configure the sensor and sample.
+    APP_ERROR_CHECK(hdc1080_init(mp_config->p_twi, sensor_init_cb, NULL));
+}
+
+static void sensor_power_up(void)
+{
+    mp_config->power_set(true);
+    m_powered = true;
+
+    timer_start_once(m_power_timer, &m_power_task, APP_TIMER_TICKS(HDC1080_STARTUP_MS));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Acquisition - trigger, wait, read
+//
+
+// Finishes m_record and hands it on - once per tick, failed ones included.
+static void sample_complete(ret_code_t result)
+{
+    if (result != NRF_SUCCESS)
+    {
+        m_record.flags |= SAMPLE_FLAG_ERROR;
+    }
+    else
+    {
+        m_record.temp_raw = ((uint16_t)m_temp_and_hr_buffer[0] << 8) | m_temp_and_hr_buffer[1];
+        m_record.hum_raw  = ((uint16_t)m_temp_and_hr_buffer[2] << 8) | m_temp_and_hr_buffer[3];
+
+        if (m_bmp280_fresh)
+        {
+            m_record.flags |= SAMPLE_FLAG_PRESSURE;
+        }
+        if (m_record.flags & SAMPLE_FLAG_PRESSURE)
+        {
+            m_record.press_raw = (uint32_t)BMP280_GET_ADC_P(m_bmp280_data);
+            m_record.ptemp_raw = (uint32_t)BMP280_GET_ADC_T(m_bmp280_data);
+        }
+
+        // Samples taken with a warm die are reported but kept out of the average.
+        if (hdc1080_heater_is_active())
+        {
+            m_record.flags |= SAMPLE_FLAG_HEATER;
+        }
+    }
+    m_bmp280_fresh = false;
+    m_busy         = false;
+
+    mp_config->record_handler(&m_record);
+}
+
+static void read_all_cb(ret_code_t result, void * p_user_data)
+{
+    m_record.t_done = record_time();
+
+    // [the TWI manager reports the NACK as NRF_ERROR_INTERNAL]
+    if (result == NRF_ERROR_INTERNAL && mp_config->poll_interval_ticks != 0 &&
+        m_ready_polls < mp_config->poll_max)
+    {
+        m_ready_polls++;
+        timer_start_once(m_conversion_timer, &m_conversion_task,
+                         mp_config->poll_interval_ticks);
+        return;
+    }
+
+    if (result != NRF_SUCCESS)
+    {
+        NRF_LOG_WARNING("read_all_cb - error: %d", (int)result);
+    }
+    sample_complete(result);
+}
+
+static void conversion_timer_handler(void * p_context)
+{
+    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND transaction =
+    {
+        .callback            = read_all_cb,
+        .p_user_data         = NULL,
+        .p_transfers         = transfer_read_temp,
+        .number_of_transfers = sizeof(transfer_read_temp) / sizeof(transfer_read_temp[0])
+    };
+    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND fused_transaction =
+    {
+        .callback            = read_all_cb,
+        .p_user_data         = NULL,
+        .p_transfers         = transfer_read_fused,
+        .number_of_transfers = sizeof(transfer_read_fused) / sizeof(transfer_read_fused[0])
+    };
+
+    if (mp_config->fused && (m_record.flags & SAMPLE_FLAG_PRESSURE))
+    {
+        schedule(&fused_transaction);
+        return;
+    }
+    schedule(&transaction);
+}
+
+static void trigger_cb(ret_code_t result, void * p_user_data)
+{
+    m_record.t_trigger = record_time();
+
+    if (result != NRF_SUCCESS)
+    {
+        NRF_LOG_WARNING("trigger_cb - error: %d", (int)result);
+        m_record.t_done = m_record.t_trigger;
+        sample_complete(result);
+        return;
+    }
+
+    uint32_t delay = mp_config->read_delay_ticks;
+
+    // Both conversions run in parallel, a single wait covers the longer one.
+    // [the BMP280 does not NACK while measuring, its time is a hard minimum]
+    if ((m_record.flags & SAMPLE_FLAG_PRESSURE) &&
+        delay < APP_TIMER_TICKS(BMP280_DEFAULT_MEAS_TIME_MS))
+    {
+        delay = APP_TIMER_TICKS(BMP280_DEFAULT_MEAS_TIME_MS);
+    }
+    m_ready_polls = 0;
+
+    timer_start_once(m_conversion_timer, &m_conversion_task, delay);
+}
+
+static void read_all(void)
+{
+    // [these structures have to be "static" - they cannot be placed on stack
+    //  since the transaction is scheduled and these structures most likely
+    //  will be referred after this function returns]
+    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND transaction =
+    {
+        .callback            = trigger_cb,
+        .p_user_data         = NULL,
+        .p_transfers         = transfer_write_temp,
+        .number_of_transfers = sizeof(transfer_write_temp) / sizeof(transfer_write_temp[0])
+    };
+    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND fused_transaction =
+    {
+        .callback            = trigger_cb,
+        .p_user_data         = NULL,
+        .p_transfers         = transfer_write_fused,
+        .number_of_transfers = sizeof(transfer_write_fused) / sizeof(transfer_write_fused[0])
+    };
+
+    // Trigger the conversion, the result is read by conversion_timer_handler
+    // - nothing blocks here, so heater cycles can share the bus.
+    m_record.flags = hdc1080_heater_is_active() ? SAMPLE_FLAG_HEATER : 0;
+    if (mp_config->untimed)
+    {
+        m_record.flags |= SAMPLE_FLAG_NO_TIME;
+    }
+
+    // HDC1080 alone until the BMP280 has been found and its calibration read.
+    if (mp_config->fused && m_bmp280_ready)
+    {
+        m_record.flags |= SAMPLE_FLAG_PRESSURE;
+        schedule(&fused_transaction);
+        return;
+    }
+    schedule(&transaction);
+}
+
+void sampler_tick(void)
+{
+    m_busy = true;
+    if (!m_powered)
+    {
+        sensor_power_up(); // read_all() follows once the sensor is up
+    }
+    else
+    {
+        read_all();
+    }
+    if (!mp_config->fused && m_bmp280_ready)
+    {
+        bmp280_read();
+    }
+}
+
+ret_code_t sampler_init(sampler_config_t const * p_config)
+{
+    ret_code_t err_code;
+
+    mp_config      = p_config;
+    m_powered      = true;
+    m_busy         = false;
+    m_bmp280_ready = false;
+    m_bmp280_fresh = false;
+
+    if (p_config->task_timer)
+    {
+        task_timer_create(&m_conversion_task, conversion_timer_handler, 0);
+        task_timer_create(&m_power_task, power_timer_handler, 0);
+        return NRF_SUCCESS;
+    }
+
+    err_code = app_timer_create(&m_conversion_timer, APP_TIMER_MODE_SINGLE_SHOT,
+                                conversion_timer_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+    return app_timer_create(&m_power_timer, APP_TIMER_MODE_SINGLE_SHOT, power_timer_handler);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Boot sampling - configuration and first sample before app_timer runs
+//
+static void boot_config_cb(ret_code_t result, void * p_user_data);
+static void boot_read_cb(ret_code_t result, void * p_user_data);
+
+// [the sensor does not acknowledge its address during the start-up and
+//  while converting - the NACK is reported as NRF_ERROR_INTERNAL]
+static bool boot_nacked(ret_code_t result, void (* step)(void))
+{
+    if (result != NRF_ERROR_INTERNAL || !m_boot_retry)
+    {
+        return false;
+    }
+    m_boot_polls++;
+    m_boot_step = step;
+    m_boot_handler(SAMPLER_BOOT_NACKED, result);
+    return true;
+}
+
+static void boot_config(void)
+{
+    APP_ERROR_CHECK(hdc1080_init(mp_config->p_twi, boot_config_cb, NULL));
+}
+
+static void boot_read(void)
+{
+    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND transaction =
+    {
+        .callback            = boot_read_cb,
+        .p_user_data         = NULL,
+        .p_transfers         = transfer_read_temp,
+        .number_of_transfers = sizeof(transfer_read_temp) / sizeof(transfer_read_temp[0])
+    };
+
+    schedule(&transaction);
+}
+
+static void boot_read_cb(ret_code_t result, void * p_user_data)
+{
+    if (boot_nacked(result, boot_read))
+    {
+        return;
+    }
+
+    if (result != NRF_SUCCESS)
+    {
+        NRF_LOG_WARNING("boot_read_cb - error: %d", (int)result);
+    }
+    sample_complete(result);
+    m_boot_handler(SAMPLER_BOOT_SAMPLED, result);
+}
+
+static void boot_trigger_cb(ret_code_t result, void * p_user_data)
+{
+    if (result != NRF_SUCCESS)
+    {
+        NRF_LOG_WARNING("boot_trigger_cb - error: %d", (int)result);
+        m_boot_handler(SAMPLER_BOOT_SAMPLED, result);
+        return;
+    }
+    boot_read();
+}
+
+static void boot_config_cb(ret_code_t result, void * p_user_data)
+{
+    static nrf_twi_mngr_transaction_t NRF_TWI_MNGR_BUFFER_LOC_IND transaction =
+    {
+        .callback            = boot_trigger_cb,
+        .p_user_data         = NULL,
+        .p_transfers         = transfer_write_temp,
+        .number_of_transfers = sizeof(transfer_write_temp) / sizeof(transfer_write_temp[0])
+    };
+
+    if (boot_nacked(result, boot_config))
+    {
+        return;
+    }
+
+    m_boot_handler(SAMPLER_BOOT_CONFIGURED, result);
+    if (result != NRF_SUCCESS)
+    {
+        // Sampling starts with the first tick, on the reset configuration.
+        NRF_LOG_WARNING("boot_config_cb - error: %d", (int)result);
+        return;
+    }
+
+    // The timestamps run on the RTC, which does not count before the LFCLK.
+    m_record.flags     = SAMPLE_FLAG_NO_TIME;
+    m_record.t_trigger = 0;
+    m_record.t_done    = 0;
+    schedule(&transaction);
+}
+
+void sampler_boot_start(sampler_boot_handler_t handler)
+{
+    m_boot_handler = handler;
+    m_boot_polls   = 0;
+    m_boot_retry   = true;
+    m_busy         = true;
+    boot_config();
+}
+
+void sampler_boot_retry(void)
+{
+    m_boot_step();
+}
+
+void sampler_boot_give_up(void)
+{
+    // The NACK becomes the result of the step.
+    m_boot_retry = false;
+    if (m_boot_step == boot_config)
+    {
+        boot_config_cb(NRF_ERROR_INTERNAL, NULL);
+    }
+    else
+    {
+        boot_read_cb(NRF_ERROR_INTERNAL, NULL);
+    }
+}
+
+uint16_t sampler_boot_polls_get(void)
+{
+    return m_boot_polls;
+}
@@ -0,0 +1,101 @@
+#ifndef SAMPLER_H__
+#define SAMPLER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nrf_twi_mngr.h"
+#include "bmp280.h"
+#include "sample.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** HDC1080 (and BMP280) acquisition, one sample per sampler_tick().
+ *  The tick triggers the conversion, a single-shot timer waits for it and
+ *  the result is read - repeated while the sensor NACKs the read when ready
+ *  polling is configured. With the BMP280 found, it is either triggered and
+ *  read in the same transactions (fused) or read in normal mode alongside.
+ *  Nothing blocks, every step is a scheduled TWI transaction or a timer.
+ *  Completed records, failed reads included, are passed to the record
+ *  handler from the TWI callback, with the timestamps of the trigger and of
+ *  the read (timestamp.h) and SAMPLE_FLAG_HEATER while a heater cycle
+ *  (hdc1080_heater.h) is active. Configured untimed - when the app_timer
+ *  RTC does not run between samples - records carry SAMPLE_FLAG_NO_TIME
+ *  instead of the timestamps.
+ *
+ *  With a power switch configured the HDC1080 is powered up
+ *  HDC1080_STARTUP_MS ahead of each sample, configured and sampled. It is
+ *  powered down by sampler_power_release() once the record has been
+ *  processed - a heater cycle started on it needs the sensor powered.
+ */
+typedef void (* sampler_record_handler_t)(sample_record_t const * p_record);
+
+typedef struct
+{
+    nrf_twi_mngr_t const *   p_twi;
+    sampler_record_handler_t record_handler;
+    uint32_t                 read_delay_ticks;      // Trigger to the first read
+    uint32_t                 poll_interval_ticks;   // Between NACKed reads, 0 - no polling
+    uint8_t                  poll_max;              // NACKed reads before giving up
+    bool                     fused;                 // BMP280 in the HDC1080 transactions
+    bool                     task_timer;            // Delays on task_timer.h, else app_timer
+    bool                     untimed;               // No timestamps, SAMPLE_FLAG_NO_TIME
+    void                  (* power_set)(bool on);   // HDC1080 supply, NULL - always on
+} sampler_config_t;
+
+// Creates the timers, task_timer_init() has to be done for task_timer. The
+// configuration is referenced, not copied.
+ret_code_t sampler_init(sampler_config_t const * p_config);
+
+// Sampling instant - starts a sample, or the power-up ahead of it.
+void sampler_tick(void);
+
+// Looks for the BMP280 and reads its calibration. Samples include the
+// pressure once it has been found.
+void sampler_bmp280_init(void);
+
+// Calibration of the BMP280, NULL until it has been found.
+bmp280_calib_t const * sampler_bmp280_calib_get(void);
+
+// Powers the HDC1080 down (power switch configured only).
+void sampler_power_down(void);
+
+// After a record has been processed - powers the HDC1080 down unless a
+// heater cycle is active or the next sample has been started already. No
+// effect without a power switch.
+void sampler_power_release(void);
+
+typedef enum
+{
+    SAMPLER_BOOT_CONFIGURED,    // Configuration written (or given up on)
+    SAMPLER_BOOT_SAMPLED,       // First sample read (or given up on)
+    SAMPLER_BOOT_NACKED         // Sensor starting up or converting, see below
+} sampler_boot_evt_t;
+
+typedef void (* sampler_boot_handler_t)(sampler_boot_evt_t event, ret_code_t result);
+
+// Configures the HDC1080 and takes the first sample over the bus alone,
+// without app_timer - usable before the LFCLK runs. The sensor NACKs the
+// config write during its start-up and the result read while it converts:
+// the handler gets SAMPLER_BOOT_NACKED then and paces the attempts with a
+// timer of its own, calling sampler_boot_retry() for the next one or
+// sampler_boot_give_up() to end the step with the NACK as its result.
+// The record goes to the record handler with SAMPLE_FLAG_NO_TIME, and
+// sampler_power_release() applies to it as to any other. Not to be mixed
+// with sampler_tick().
+void sampler_boot_start(sampler_boot_handler_t handler);
+
+// After SAMPLER_BOOT_NACKED, from any context at or below the TWI priority.
+void sampler_boot_retry(void);
+
+void sampler_boot_give_up(void);
+
+// NACKed attempts of the boot sampling.
+uint16_t sampler_boot_polls_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAMPLER_H__
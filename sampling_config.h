@@ -0,0 +1,113 @@
+#ifndef SAMPLING_CONFIG_H__
+#define SAMPLING_CONFIG_H__
+
+#include "app_util.h"
+#include "hdc1080.h"
+
+/** Configuration of the sampling loop - the tick, the acquisition
+ *  (sampler.h) and the processing of the samples (sample_proc.h,
+ *  summary.h, deadband.h).
+ *  Shared by main.c and the emulator runs in tools/emu, so that the runs
+ *  sample, process and log the way the firmware does. Switches that only
+ *  concern the application (output, power switch, boot) are in main.c.
+ */
+
+// Period of the sampling tick.
+#define SAMPLING_PERIOD_MS          500
+
+// Sampling tick from long_timer.h (RTC2) instead of an app_timer, for
+// periods of minutes to days - the MCU wakes once per sample and not for RTC
+// overflows in between. The number of wake-ups is logged once a day.
+// [the app_timer RTC the timestamps run on stops between samples then -
+//  records carry SAMPLE_FLAG_NO_TIME instead]
+#define LONG_PERIOD_SCHEDULING_ENABLED 0
+
+// The sampling tick, the conversion and power-up delays, the heater cycle
+// steps and a periodic report share one app_timer (task_timer.h). Tasks due within the tolerance
+// of another wake-up run with it - the report rides along with a sampling
+// tick instead of waking the MCU on its own. Wake-ups, handlers run and
+// app_timer restarts are logged every TASK_TIMER_REPORT_MS.
+// [not with long periods: the app_timer RTC stops between samples and the
+//  deadlines are kept in timestamp_get() ticks]
+#define TASK_TIMER_ENABLED          (!LONG_PERIOD_SCHEDULING_ENABLED)
+#define TASK_TIMER_REPORT_MS        60000
+#define TASK_TIMER_REPORT_TOLERANCE_MS SAMPLING_PERIOD_MS
+
+// Time between triggering a T and RH conversion and reading the result.
+#define CONVERSION_TIME_MS          HDC1080_CONVERSION_MS
+
+// Ready detection - the result is read after the datasheet conversion time
+// and, while the HDC1080 NACKs the read, again every READY_POLL_INTERVAL_MS.
+// A NACKed read ends after the address byte, so every poll costs one byte
+// on the bus and the sample latency follows the actual conversion time.
+#define READY_POLLING_ENABLED       1
+#define READY_POLL_INTERVAL_MS      1
+#define READY_POLL_MAX              10
+
+// [rounded up - a first read ahead of the typical time is NACKed]
+#if READY_POLLING_ENABLED
+    #define READ_DELAY_MS           CEIL_DIV(HDC1080_CONVERSION_TYP_US, 1000)
+#else
+    #define READ_DELAY_MS           CONVERSION_TIME_MS
+#endif
+
+// BMP280 on the same TWI manager, running in normal mode (see bmp280.h).
+#define BMP280_ENABLED              1
+
+// BMP280 forced measurement triggered together with the HDC1080 conversion
+// and read in the same transaction as its result - one fused sample per
+// tick. The first trigger takes the BMP280 out of normal mode.
+#define FUSED_ACQUISITION_ENABLED   1
+
+#if FUSED_ACQUISITION_ENABLED && !BMP280_ENABLED
+    #error "Fused acquisition needs the BMP280"
+#endif
+
+// Averaging of the samples - either the mean of the last SAMPLE_PROC_WINDOW
+// samples or a fixed-point exponential moving average (a few bytes of state,
+// main.c does not allocate the sample ring then).
+#define AVERAGING_USE_EMA           0
+
+// Optional spike rejection on the raw codes ahead of the averaging.
+#define MEDIAN_FILTER_ENABLED       1
+
+// Heater cycle started when the averaged humidity reaches the threshold.
+#define HEATER_RH_THRESHOLD         95.0f
+#define HEATER_BURST_CONVERSIONS    50
+
+// Samples per window summary (summary.h) - a minute at the default period.
+#define SUMMARY_WINDOW_SAMPLES      120
+
+// Deadbands of the report on change (deadband.h) - absolute in codes,
+// relative in 1/65536 of the last reported code.
+#define DEADBAND_TEMP_ABS           40      // 0.1 C
+#define DEADBAND_TEMP_REL           0
+#define DEADBAND_HUM_ABS            164     // 0.25 %RH
+#define DEADBAND_HUM_REL            655     // 1 % of the reading
+#define DEADBAND_HEARTBEAT_MS       300000
+
+// Actual intervals between sampling ticks are recorded (jitter.h) and
+// summarized in the log every JITTER_REPORT_SAMPLES ticks.
+// [not with long periods: app_timer stops RTC1 between samples, so the
+//  timestamps do not move from one sample to the next]
+#define JITTER_TRACKING_ENABLED     (!LONG_PERIOD_SCHEDULING_ENABLED)
+#define JITTER_REPORT_SAMPLES       120
+
+// Deferred log output is written out in batches from the main loop instead
+// of after every wake-up - once LOG_FLUSH_WATERMARK samples have been
+// logged since the last flush (about half of NRF_LOG_BUFSIZE), or at the
+// first wake-up LOG_FLUSH_MAX_LATENCY_MS after it. Never from interrupt
+// handlers.
+// [not with long periods: timestamps stand still between samples, so every
+//  wake-up flushes]
+#define LOG_FLUSH_BATCHED           (!LONG_PERIOD_SCHEDULING_ENABLED)
+#define LOG_FLUSH_WATERMARK         4       // Samples, ~110 bytes of entries each
+#define LOG_FLUSH_MAX_LATENCY_MS    2000
+
+// Boot sampling (sampler_boot_start()) - a NACKed config write or result
+// read is repeated after FAST_BOOT_RETRY_US, until FAST_BOOT_TIMEOUT_US
+// after the start. [start-up and both conversions take ~30 ms]
+#define FAST_BOOT_RETRY_US          1000
+#define FAST_BOOT_TIMEOUT_US        100000
+
+#endif // SAMPLING_CONFIG_H__
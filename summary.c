@@ -0,0 +1,56 @@
+#include "summary.h"
+
+void summary_init(summary_t * p_summary, uint16_t window)
+{
+    p_summary->window  = window;
+    p_summary->samples = 0;
+}
+
+bool summary_add(summary_t * p_summary, sample_record_t const * p_record)
+{
+    sample_summary_t * p_current = &p_summary->summary;
+
+    if (p_record->flags & SAMPLE_FLAG_ERROR)
+    {
+        return false;
+    }
+
+    if (p_summary->samples == 0)
+    {
+        window_stats_reset(&p_current->temp);
+        window_stats_reset(&p_current->hum);
+        window_stats_reset(&p_current->press);
+        window_stats_reset(&p_current->ptemp);
+        p_current->t_first = p_record->t_trigger;
+        p_current->flags   = 0;
+    }
+    p_current->t_last = p_record->t_trigger;
+    p_current->flags |= p_record->flags & SAMPLE_FLAG_NO_TIME;
+
+    // Same rule as for the average - a warm die is flagged, not counted.
+    if (p_record->flags & SAMPLE_FLAG_HEATER)
+    {
+        p_current->flags |= SAMPLE_FLAG_HEATER;
+    }
+    else
+    {
+        window_stats_update(&p_current->temp, p_record->temp_raw);
+        window_stats_update(&p_current->hum, p_record->hum_raw);
+    }
+
+    if (p_record->flags & SAMPLE_FLAG_PRESSURE)
+    {
+        p_current->flags |= SAMPLE_FLAG_PRESSURE;
+        window_stats_update(&p_current->press,
+                            (uint16_t)(p_record->press_raw >> SAMPLE_SUMMARY_PRESS_SHIFT));
+        window_stats_update(&p_current->ptemp,
+                            (uint16_t)(p_record->ptemp_raw >> SAMPLE_SUMMARY_PRESS_SHIFT));
+    }
+
+    if (++p_summary->samples < p_summary->window)
+    {
+        return false;
+    }
+    p_summary->samples = 0;
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef SUMMARY_H__
+#define SUMMARY_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sample.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Window summaries of the samples (sample_summary_t) - statistics of the
+ *  codes over every window samples, heater samples only flagged and failed
+ *  reads left out. BMP280 codes are summarized as well when samples carry
+ *  them.
+ */
+typedef struct
+{
+    sample_summary_t summary;   // Complete when summary_add() returns true
+    uint16_t         window;    // Samples per summary
+    uint16_t         samples;   // In the running window
+} summary_t;
+
+void summary_init(summary_t * p_summary, uint16_t window);
+
+// Adds a sample. Returns true when it completed a window, the summary is
+// then valid until the next call.
+bool summary_add(summary_t * p_summary, sample_record_t const * p_record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SUMMARY_H__
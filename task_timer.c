@@ -0,0 +1,210 @@
+#include "task_timer.h"
+#include "app_timer.h"
+#include "app_error.h"
+#include "app_util_platform.h"
+#include "timestamp.h"
+
+#if TIMESTAMP_USE_TIMER
+    #error "task_timer.c counts in app_timer ticks"
+#endif
+
+APP_TIMER_DEF(m_timer);
+
+static uint32_t           m_wake;   // Time the app_timer is started for
+static bool               m_armed;
+static bool               m_running; // In timer_handler(), rearm() comes last
+static task_timer_stats_t m_stats;
+
+static uint32_t latest(nrf_sortlist_item_t const * p_item)
+{
+    task_timer_t const * p_task = (task_timer_t const *)p_item;
+
+    return p_task->deadline + p_task->tolerance;
+}
+
+static bool compare(nrf_sortlist_item_t * p_item0, nrf_sortlist_item_t * p_item1)
+{
+    return (int32_t)(latest(p_item0) - latest(p_item1)) <= 0;
+}
+
+NRF_SORTLIST_DEF(m_tasks, compare);
+
+// Starts the app_timer for the head of the list. Inside a critical region.
+static void rearm(void)
+{
+    nrf_sortlist_item_t const * p_head = nrf_sortlist_peek(&m_tasks);
+    uint32_t                    wake;
+    int32_t                     ticks;
+
+    if (m_running)
+    {
+        return;
+    }
+    if (p_head == NULL)
+    {
+        if (m_armed)
+        {
+            (void)app_timer_stop(m_timer);
+            m_armed = false;
+        }
+        return;
+    }
+
+    wake = latest(p_head);
+    if (m_armed && wake == m_wake)
+    {
+        return;
+    }
+
+    ticks = (int32_t)(wake - timestamp_get());
+    if (ticks < APP_TIMER_MIN_TIMEOUT_TICKS)
+    {
+        ticks = APP_TIMER_MIN_TIMEOUT_TICKS;
+    }
+
+    // [app_timer_start() leaves a running timer alone]
+    (void)app_timer_stop(m_timer);
+    APP_ERROR_CHECK(app_timer_start(m_timer, (uint32_t)ticks, NULL));
+    m_wake  = wake;
+    m_armed = true;
+    m_stats.rearms++;
+}
+
+// Takes the first task that is due out of the list.
+static task_timer_t * due_pop(uint32_t now)
+{
+    for (nrf_sortlist_item_t const * p_item = nrf_sortlist_peek(&m_tasks);
+         p_item != NULL;
+         p_item = nrf_sortlist_next(p_item))
+    {
+        task_timer_t * p_task = (task_timer_t *)p_item;
+
+        if ((int32_t)(p_task->deadline - now) <= 0)
+        {
+            (void)nrf_sortlist_remove(&m_tasks, &p_task->item);
+            return p_task;
+        }
+    }
+    return NULL;
+}
+
+static void timer_handler(void * p_context)
+{
+    uint32_t now = timestamp_get();
+
+    m_stats.wakes++;
+    m_armed   = false;
+    m_running = true;
+
+    for (;;)
+    {
+        task_timer_t *       p_task;
+        task_timer_handler_t handler;
+        void *               p_task_context;
+
+        CRITICAL_REGION_ENTER();
+        p_task = due_pop(now);
+        if (p_task != NULL)
+        {
+            handler        = p_task->handler;
+            p_task_context = p_task->p_context;
+
+            if (p_task->period != 0)
+            {
+                // From the deadline, not from now - the phase stays. Periods
+                // missed altogether are skipped.
+                do
+                {
+                    p_task->deadline += p_task->period;
+                } while ((int32_t)(p_task->deadline - now) <= 0);
+                nrf_sortlist_add(&m_tasks, &p_task->item);
+            }
+            else
+            {
+                p_task->active = false;
+            }
+        }
+        CRITICAL_REGION_EXIT();
+
+        if (p_task == NULL)
+        {
+            break;
+        }
+        m_stats.runs++;
+        handler(p_task_context);
+    }
+
+    CRITICAL_REGION_ENTER();
+    m_running = false;
+    rearm();
+    CRITICAL_REGION_EXIT();
+}
+
+ret_code_t task_timer_init(void)
+{
+    m_armed   = false;
+    m_running = false;
+    m_stats.wakes  = 0;
+    m_stats.runs   = 0;
+    m_stats.rearms = 0;
+    while (nrf_sortlist_pop(&m_tasks) != NULL)
+    {
+    }
+    return app_timer_create(&m_timer, APP_TIMER_MODE_SINGLE_SHOT, timer_handler);
+}
+
+void task_timer_create(task_timer_t * p_task, task_timer_handler_t handler,
+                       uint32_t tolerance_ticks)
+{
+    p_task->handler   = handler;
+    p_task->tolerance = tolerance_ticks;
+    p_task->period    = 0;
+    p_task->active    = false;
+}
+
+ret_code_t task_timer_start(task_timer_t * p_task, uint32_t timeout_ticks,
+                            uint32_t period_ticks, void * p_context)
+{
+    if (p_task->handler == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    // [deadlines are compared as signed differences]
+    if (timeout_ticks > INT32_MAX / 2 || period_ticks > INT32_MAX / 2 ||
+        p_task->tolerance > INT32_MAX / 2)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    CRITICAL_REGION_ENTER();
+    if (p_task->active)
+    {
+        (void)nrf_sortlist_remove(&m_tasks, &p_task->item);
+    }
+    p_task->deadline  = timestamp_get() + timeout_ticks;
+    p_task->period    = period_ticks;
+    p_task->p_context = p_context;
+    p_task->active    = true;
+    nrf_sortlist_add(&m_tasks, &p_task->item);
+    rearm();
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+void task_timer_stop(task_timer_t * p_task)
+{
+    CRITICAL_REGION_ENTER();
+    if (p_task->active)
+    {
+        (void)nrf_sortlist_remove(&m_tasks, &p_task->item);
+        p_task->active = false;
+        rearm();
+    }
+    CRITICAL_REGION_EXIT();
+}
+
+void task_timer_stats_get(task_timer_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
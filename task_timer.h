@@ -0,0 +1,66 @@
+#ifndef TASK_TIMER_H__
+#define TASK_TIMER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "nrf_sortlist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Single-shot and periodic tasks on one app_timer instance.
+ *  Every task has a deadline and a tolerance - how late it may run. The
+ *  tasks are kept in an nrf_sortlist by the latest time they may run and
+ *  the app_timer is only started for the head of the list. When it expires
+ *  every task whose deadline has been reached runs, so deadlines within the
+ *  tolerance of each other share a wake-up. A task with tolerance 0 runs on
+ *  time and takes along whatever else is due by then.
+ *  The app_timer is only moved when the head changes; a deadline closer
+ *  than APP_TIMER_MIN_TIMEOUT_TICKS to the last wake-up runs that late.
+ *
+ *  Times are in app_timer ticks (APP_TIMER_TICKS()) on the timestamp_get()
+ *  counter. Handlers run in the app_timer interrupt, like app_timer
+ *  handlers; a periodic task keeps its phase.
+ */
+typedef void (* task_timer_handler_t)(void * p_context);
+
+typedef struct
+{
+    nrf_sortlist_item_t  item;
+    uint32_t             deadline;  // timestamp_get() ticks
+    uint32_t             period;    // 0 for single shot
+    uint32_t             tolerance;
+    task_timer_handler_t handler;
+    void *               p_context;
+    bool                 active;
+} task_timer_t;
+
+typedef struct
+{
+    uint32_t wakes;     // app_timer expiries
+    uint32_t runs;      // Handlers run
+    uint32_t rearms;    // app_timer restarts
+} task_timer_stats_t;
+
+// Call after app_timer_init() and timestamp_init().
+ret_code_t task_timer_init(void);
+
+void task_timer_create(task_timer_t * p_task, task_timer_handler_t handler,
+                       uint32_t tolerance_ticks);
+
+// (Re)starts a task - due timeout_ticks from now and then every period_ticks
+// if that is not 0.
+ret_code_t task_timer_start(task_timer_t * p_task, uint32_t timeout_ticks,
+                            uint32_t period_ticks, void * p_context);
+
+void task_timer_stop(task_timer_t * p_task);
+
+void task_timer_stats_get(task_timer_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_TIMER_H__
@@ -0,0 +1,59 @@
+#include "timestamp.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+#include "nrf_drv_clock.h"
+#include "nrf_timer.h"
+
+#if !TIMESTAMP_USE_TIMER
+static uint32_t m_last_cnt;  // Last 24-bit RTC value seen
+static uint32_t m_high;      // Upper bits of the extended counter
+#endif
+
+ret_code_t timestamp_init(void)
+{
+#if TIMESTAMP_USE_TIMER
+    // Crystal accuracy for the microsecond timer.
+    nrf_drv_clock_hfclk_request(NULL);
+
+    nrf_timer_mode_set(TIMESTAMP_TIMER, NRF_TIMER_MODE_TIMER);
+    nrf_timer_bit_width_set(TIMESTAMP_TIMER, NRF_TIMER_BIT_WIDTH_32);
+    nrf_timer_frequency_set(TIMESTAMP_TIMER, NRF_TIMER_FREQ_1MHz);
+    nrf_timer_task_trigger(TIMESTAMP_TIMER, NRF_TIMER_TASK_CLEAR);
+    nrf_timer_task_trigger(TIMESTAMP_TIMER, NRF_TIMER_TASK_START);
+#else
+    m_last_cnt = app_timer_cnt_get();
+    m_high     = 0;
+#endif
+    return NRF_SUCCESS;
+}
+
+uint32_t timestamp_get(void)
+{
+    uint32_t ticks;
+
+#if TIMESTAMP_USE_TIMER
+    CRITICAL_REGION_ENTER();
+    nrf_timer_task_trigger(TIMESTAMP_TIMER, NRF_TIMER_TASK_CAPTURE0);
+    ticks = nrf_timer_cc_read(TIMESTAMP_TIMER, NRF_TIMER_CC_CHANNEL0);
+    CRITICAL_REGION_EXIT();
+#else
+    // [called from timer and TWI interrupt context]
+    CRITICAL_REGION_ENTER();
+    uint32_t cnt = app_timer_cnt_get();
+
+    if (cnt < m_last_cnt)
+    {
+        m_high += APP_TIMER_MAX_CNT_VAL + 1;
+    }
+    m_last_cnt = cnt;
+    ticks      = m_high | cnt;
+    CRITICAL_REGION_EXIT();
+#endif
+
+    return ticks;
+}
+
+uint32_t timestamp_diff_us(uint32_t to, uint32_t from)
+{
+    return (uint32_t)(((uint64_t)(to - from) * 1000000) / TIMESTAMP_FREQ_HZ);
+}
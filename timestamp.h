@@ -0,0 +1,45 @@
+#ifndef TIMESTAMP_H__
+#define TIMESTAMP_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "app_timer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 32-bit sample timestamps.
+ *  By default the app_timer RTC counter is used (61 us resolution) and
+ *  extended from 24 to 32 bits in software; timestamp_get() has to be
+ *  called at least once per RTC overflow period (1024 s at 16384 Hz).
+ *  The counter only runs while app_timer has an active timer
+ *  (APP_TIMER_KEEPS_RTC_ACTIVE is 0), so timestamps are only comparable
+ *  across periods in which some timer was kept running.
+ *  With TIMESTAMP_USE_TIMER a free running TIMER instance at 1 MHz is used
+ *  instead, at the cost of keeping the high frequency clock running.
+ */
+#ifndef TIMESTAMP_USE_TIMER
+#define TIMESTAMP_USE_TIMER     0
+#endif
+
+#if TIMESTAMP_USE_TIMER
+#define TIMESTAMP_TIMER         NRF_TIMER2
+#define TIMESTAMP_FREQ_HZ       1000000
+#else
+#define TIMESTAMP_FREQ_HZ       APP_TIMER_CLOCK_FREQ
+#endif
+
+// Call after app_timer_init() (RTC) or nrf_drv_clock_init() (TIMER).
+ret_code_t timestamp_init(void);
+
+uint32_t timestamp_get(void);
+
+// Difference of two timestamps in microseconds (wrap-around safe).
+uint32_t timestamp_diff_us(uint32_t to, uint32_t from);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIMESTAMP_H__
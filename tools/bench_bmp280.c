@@ -0,0 +1,142 @@
+/** Host benchmark - BMP280 integer compensation against double precision.
+ *
+ *    cc -O2 -I. -Itools/emu/include tools/bench_bmp280.c bmp280.c -lm \
+ *       -o /tmp/bench_bmp280 && /tmp/bench_bmp280
+ *
+ *  Uses the calibration example of the datasheet, parsed with
+ *  bmp280_calib_parse() from the raw 24-byte block. The floating point
+ *  reference is the double precision code of the datasheet (chapter 8.1).
+ */
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include "bmp280.h"
+
+static const uint8_t m_calib_raw[BMP280_CALIB_SIZE] =
+{
+    0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC, 0x7D, 0x8E, 0x43, 0xD6, 0xD0, 0x0B,
+    0x27, 0x0B, 0x8C, 0x00, 0xF9, 0xFF, 0x8C, 0x3C, 0xF8, 0xC6, 0x70, 0x17
+};
+
+static double compensate_t_double(bmp280_calib_t const * p_c, int32_t adc_t, double * p_t_fine)
+{
+    double var1 = (adc_t / 16384.0 - p_c->dig_T1 / 1024.0) * p_c->dig_T2;
+    double var2 = ((adc_t / 131072.0 - p_c->dig_T1 / 8192.0) *
+                   (adc_t / 131072.0 - p_c->dig_T1 / 8192.0)) * p_c->dig_T3;
+
+    *p_t_fine = var1 + var2;
+    return (var1 + var2) / 5120.0;
+}
+
+static double compensate_p_double(bmp280_calib_t const * p_c, int32_t adc_p, double t_fine)
+{
+    double var1 = t_fine / 2.0 - 64000.0;
+    double var2 = var1 * var1 * p_c->dig_P6 / 32768.0;
+    double p;
+
+    var2 = var2 + var1 * p_c->dig_P5 * 2.0;
+    var2 = (var2 / 4.0) + (p_c->dig_P4 * 65536.0);
+    var1 = (p_c->dig_P3 * var1 * var1 / 524288.0 + p_c->dig_P2 * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * p_c->dig_P1;
+    if (var1 == 0.0)
+    {
+        return 0.0;
+    }
+    p    = 1048576.0 - adc_p;
+    p    = (p - (var2 / 4096.0)) * 6250.0 / var1;
+    var1 = p_c->dig_P9 * p * p / 2147483648.0;
+    var2 = p * p_c->dig_P8 / 32768.0;
+    return p + (var1 + var2 + p_c->dig_P7) / 16.0;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(void)
+{
+    bmp280_calib_t calib;
+    int32_t        t_fine;
+    double         t_fine_d;
+
+    bmp280_calib_parse(m_calib_raw, &calib);
+
+    // Datasheet example: adc_T = 519888, adc_P = 415148.
+    int32_t t  = bmp280_compensate_t(&calib, 519888, &t_fine);
+    double  td = compensate_t_double(&calib, 519888, &t_fine_d);
+    printf("datasheet example: T %.2f C (double %.4f), P64 %.2f Pa, P32 %u Pa "
+           "(double %.2f)\n",
+           t / 100.0, td, bmp280_compensate_p(&calib, 415148, t_fine) / 256.0,
+           bmp280_compensate_p32(&calib, 415148, t_fine),
+           compensate_p_double(&calib, 415148, t_fine_d));
+
+    // Accuracy over -40..85 C and 300..1100 hPa worth of ADC codes.
+    double max_t = 0.0, max_p64 = 0.0, max_p32 = 0.0;
+    for (int32_t adc_t = 380000; adc_t <= 660000; adc_t += 997)
+    {
+        for (int32_t adc_p = 200000; adc_p <= 700000; adc_p += 1009)
+        {
+            double tr = compensate_t_double(&calib, adc_t, &t_fine_d);
+            double pr = compensate_p_double(&calib, adc_p, t_fine_d);
+
+            if (tr < -40.0 || tr > 85.0 || pr < 30000.0 || pr > 110000.0)
+            {
+                continue;
+            }
+
+            int32_t ti  = bmp280_compensate_t(&calib, adc_t, &t_fine);
+            double  p64 = bmp280_compensate_p(&calib, adc_p, t_fine) / 256.0;
+            double  p32 = bmp280_compensate_p32(&calib, adc_p, t_fine);
+
+            max_t   = fmax(max_t, fabs(ti / 100.0 - tr));
+            max_p64 = fmax(max_p64, fabs(p64 - pr));
+            max_p32 = fmax(max_p32, fabs(p32 - pr));
+        }
+    }
+    printf("max error vs double: T %.3f C, P(64-bit) %.3f Pa, P(32-bit) %.3f Pa\n",
+           max_t, max_p64, max_p32);
+
+    enum { RUNS = 5000000 };
+    volatile uint64_t isink = 0;
+    volatile double   dsink = 0.0;
+    uint32_t seed;
+    double   t0, t1, t2, t3;
+
+    seed = 1;
+    t0 = now_ns();
+    for (int i = 0; i < RUNS; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        isink += (uint64_t)bmp280_compensate_t(&calib, 450000 + (int32_t)(seed >> 15), &t_fine);
+        isink += bmp280_compensate_p(&calib, 350000 + (int32_t)(seed >> 14), t_fine);
+    }
+    seed = 1;
+    t1 = now_ns();
+    for (int i = 0; i < RUNS; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        isink += (uint64_t)bmp280_compensate_t(&calib, 450000 + (int32_t)(seed >> 15), &t_fine);
+        isink += bmp280_compensate_p32(&calib, 350000 + (int32_t)(seed >> 14), t_fine);
+    }
+    seed = 1;
+    t2 = now_ns();
+    for (int i = 0; i < RUNS; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        dsink += compensate_t_double(&calib, 450000 + (int32_t)(seed >> 15), &t_fine_d);
+        dsink += compensate_p_double(&calib, 350000 + (int32_t)(seed >> 14), t_fine_d);
+    }
+    t3 = now_ns();
+
+    printf("throughput (T + P per sample):\n");
+    printf("  integer 32/64-bit %6.2f ns\n", (t1 - t0) / RUNS);
+    printf("  integer 32-bit    %6.2f ns\n", (t2 - t1) / RUNS);
+    printf("  double            %6.2f ns\n", (t3 - t2) / RUNS);
+    (void)isink;
+    (void)dsink;
+    return 0;
+}
@@ -0,0 +1,138 @@
+/** Host benchmark - sliding median and EMA versus the plain windowed mean.
+ *
+ *  The window size is a compile-time setting, so build once per size:
+ *
+ *    for w in 5 9 15 31 63; do
+ *        cc -O2 -I. -DMEDIAN_FILTER_WINDOW=$w tools/bench_filters.c \
+ *           median_filter.c ema_filter.c -o /tmp/bench_filters && /tmp/bench_filters
+ *    done
+ *
+ *  The mean is the ring + running sum scheme of main.c, on raw codes.
+ *  Both stages see the same noisy input with occasional spikes; the median
+ *  result is checked against a sort of the window.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "median_filter.h"
+#include "ema_filter.h"
+
+#define SAMPLES     (1u << 22)
+#define CHECKED     20000u
+
+typedef struct
+{
+    uint16_t ring[MEDIAN_FILTER_WINDOW];
+    uint32_t sum;
+    uint8_t  idx;
+} mean_filter_t;
+
+static uint16_t mean_update(mean_filter_t * p_filter, uint16_t value)
+{
+    p_filter->sum -= p_filter->ring[p_filter->idx];
+    p_filter->sum += value;
+    p_filter->ring[p_filter->idx] = value;
+    if (++p_filter->idx == MEDIAN_FILTER_WINDOW)
+    {
+        p_filter->idx = 0;
+    }
+    return (uint16_t)(p_filter->sum / MEDIAN_FILTER_WINDOW);
+}
+
+static int cmp_u16(void const * a, void const * b)
+{
+    return (int)*(uint16_t const *)a - (int)*(uint16_t const *)b;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(void)
+{
+    static uint16_t input[SAMPLES];
+    uint32_t        seed = 12345;
+    median_filter_t median;
+    mean_filter_t   mean = { { 0 }, 0, 0 };
+    ema_filter_t    ema;
+    volatile uint32_t sink = 0;
+
+    for (uint32_t i = 0; i < SAMPLES; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        input[i] = (uint16_t)(0x6000 + ((seed >> 16) & 0x3F));
+        if ((seed & 0x3FF) == 0)
+        {
+            input[i] = (uint16_t)(seed >> 8); // Spike
+        }
+    }
+
+    // Correctness against a sorted copy of the window.
+    median_filter_init(&median);
+    for (uint32_t i = 0; i < CHECKED; i++)
+    {
+        uint16_t got = median_filter_update(&median, input[i]);
+        uint32_t n   = (i + 1 < MEDIAN_FILTER_WINDOW) ? i + 1 : MEDIAN_FILTER_WINDOW;
+        uint16_t window[MEDIAN_FILTER_WINDOW];
+
+        memcpy(window, &input[i + 1 - n], n * sizeof(window[0]));
+        qsort(window, n, sizeof(window[0]), cmp_u16);
+        if (window[n / 2] != got)
+        {
+            printf("median mismatch at %u: %u != %u\n", i, got, window[n / 2]);
+            return 1;
+        }
+    }
+
+    // EMA warm-up starts at the first input, a step settles to within 1 LSB.
+    ema_filter_init(&ema);
+    if (ema_filter_update(&ema, 1000) != 1000)
+    {
+        printf("ema warm-up mismatch\n");
+        return 1;
+    }
+    for (uint32_t i = 0; i < 64u << EMA_FILTER_SHIFT; i++)
+    {
+        sink = ema_filter_update(&ema, 50000);
+    }
+    if (sink < 49999)
+    {
+        printf("ema does not settle: %u\n", (unsigned)sink);
+        return 1;
+    }
+
+    median_filter_init(&median);
+    ema_filter_init(&ema);
+    double t0 = now_ns();
+    for (uint32_t i = 0; i < SAMPLES; i++)
+    {
+        sink += median_filter_update(&median, input[i]);
+    }
+    double t1 = now_ns();
+    for (uint32_t i = 0; i < SAMPLES; i++)
+    {
+        sink += mean_update(&mean, input[i]);
+    }
+    double t2 = now_ns();
+    for (uint32_t i = 0; i < SAMPLES; i++)
+    {
+        sink += ema_filter_update(&ema, input[i]);
+    }
+    double t3 = now_ns();
+
+    double median_ns = (t1 - t0) / SAMPLES;
+    double mean_ns   = (t2 - t1) / SAMPLES;
+    double ema_ns    = (t3 - t2) / SAMPLES;
+
+    printf("window %3d: median %6.2f ns/sample, mean %5.2f ns/sample (%u B), "
+           "ema %5.2f ns/sample (%u B)\n",
+           MEDIAN_FILTER_WINDOW, median_ns, mean_ns, (unsigned)sizeof(mean),
+           ema_ns, (unsigned)sizeof(ema));
+    (void)sink;
+    return 0;
+}
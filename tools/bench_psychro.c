@@ -0,0 +1,138 @@
+/** Host benchmark - table based dew point / absolute humidity against libm.
+ *
+ *    cc -O2 -I. -DPSYCHRO_TABLE_ENABLED=1 tools/bench_psychro.c psychro.c \
+ *        -lm -o /tmp/bench_psychro && /tmp/bench_psychro
+ *
+ *  Accuracy is checked over -40..125 C and 1..100 % RH against the double
+ *  precision Magnus formula. Built without PSYCHRO_TABLE_ENABLED the same
+ *  checks cover the default logf()/expf() version of psychro.c.
+ *  Speed is compared with the float formula the way it would run on every
+ *  sample - on the host only, where the libm version is the faster one. It
+ *  says nothing about the target, the cycles there are logged with
+ *  PSYCHRO_CYCLES_ENABLED in main.c.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include "psychro.h"
+
+#define MAGNUS_B    17.62
+#define MAGNUS_C    243.12
+
+static double dew_point_ref(double t, double rh)
+{
+    double g = log(rh / 100.0) + MAGNUS_B * t / (MAGNUS_C + t);
+
+    return MAGNUS_C * g / (MAGNUS_B - g);
+}
+
+static double abs_humidity_ref(double t, double rh)
+{
+    double e = rh / 100.0 * 611.2 * exp(MAGNUS_B * t / (MAGNUS_C + t));
+
+    return 2167.0 * e / (t + 273.15); // mg/m^3
+}
+
+static float dew_point_float(float t, float rh)
+{
+    float g = logf(rh / 100.0f) + 17.62f * t / (243.12f + t);
+
+    return 243.12f * g / (17.62f - g);
+}
+
+static float abs_humidity_float(float t, float rh)
+{
+    float e = rh / 100.0f * 611.2f * expf(17.62f * t / (243.12f + t));
+
+    return 2167.0f * e / (t + 273.15f);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(void)
+{
+    double max_dp_err = 0.0, max_ah_err = 0.0, max_ah_abs = 0.0;
+    double at_dp_t = 0.0, at_dp_rh = 0.0, at_ah_t = 0.0, at_ah_rh = 0.0;
+    unsigned points = 0;
+
+    for (int t = -4000; t <= 12500; t += 7)
+    {
+        for (int rh = 100; rh <= 10000; rh += 13)
+        {
+            double td_ref = dew_point_ref(t / 100.0, rh / 100.0);
+            double ah_ref = abs_humidity_ref(t / 100.0, rh / 100.0);
+
+            points++;
+            if (td_ref > PSYCHRO_TEMP_MIN)
+            {
+                double err = fabs(psychro_dew_point((int16_t)t, (uint16_t)rh) / 100.0 - td_ref);
+                if (err > max_dp_err)
+                {
+                    max_dp_err = err;
+                    at_dp_t    = t / 100.0;
+                    at_dp_rh   = rh / 100.0;
+                }
+            }
+
+            double abs_err = fabs(psychro_abs_humidity((int16_t)t, (uint16_t)rh) - ah_ref);
+            double rel     = abs_err / ah_ref;
+            if (abs_err > max_ah_abs)
+            {
+                max_ah_abs = abs_err;
+            }
+            // Below 1 g/m^3 the relative error is dominated by the 1 mg/m^3
+            // resolution of the result.
+            if (ah_ref >= 1000.0 && rel > max_ah_err)
+            {
+                max_ah_err = rel;
+                at_ah_t    = t / 100.0;
+                at_ah_rh   = rh / 100.0;
+            }
+        }
+    }
+
+    printf("accuracy over %u points:\n", points);
+    printf("  dew point         max error %.4f C   (at %.2f C, %.2f %%)\n",
+           max_dp_err, at_dp_t, at_dp_rh);
+    printf("  absolute humidity max error %.4f %%   (at %.2f C, %.2f %%), "
+           "%.2f mg/m^3 absolute\n",
+           max_ah_err * 100.0, at_ah_t, at_ah_rh, max_ah_abs);
+
+    enum { RUNS = 4000000 };
+    volatile float  fsink = 0.0f;
+    volatile int32_t isink = 0;
+    uint32_t seed = 1;
+
+    double t0 = now_ns();
+    for (int i = 0; i < RUNS; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        int16_t  t  = (int16_t)((seed >> 8) % 16500 - 4000);
+        uint16_t rh = (uint16_t)(100 + (seed >> 20) % 9900);
+        isink += psychro_dew_point(t, rh) + (int32_t)psychro_abs_humidity(t, rh);
+    }
+    double t1 = now_ns();
+    seed = 1;
+    for (int i = 0; i < RUNS; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        float t  = (float)((seed >> 8) % 16500 - 4000) / 100.0f;
+        float rh = (float)(100 + (seed >> 20) % 9900) / 100.0f;
+        fsink += dew_point_float(t, rh) + abs_humidity_float(t, rh);
+    }
+    double t2 = now_ns();
+
+    printf("speed (dew point + absolute humidity):\n");
+    printf("  %-7s %6.2f ns/sample\n", PSYCHRO_TABLE_ENABLED ? "table" : "psychro",
+           (t1 - t0) / RUNS);
+    printf("  %-7s %6.2f ns/sample\n", "libm", (t2 - t1) / RUNS);
+    (void)fsink;
+    (void)isink;
+    return 0;
+}
@@ -0,0 +1,231 @@
+/** Host benchmark - sample_queue.c between two threads.
+ *
+ *    cc -O2 -pthread -I. -Itools/emu/include tools/bench_sample_queue.c \
+ *       sample_queue.c -o /tmp/bench_sample_queue && /tmp/bench_sample_queue
+ *
+ *  Waits yield the CPU, so the numbers stay meaningful on a single core.
+ *  A producer thread stands in for the acquisition callback, the consumer
+ *  thread for the main loop. Every record carries its sequence number and
+ *  fields derived from it, so the consumer detects torn records (a slot
+ *  read while it was being written) and lost ones. Runs:
+ *    spin      producer retries while the queue is full - raw throughput
+ *    drop      producer never waits, as in the firmware, and puts bursts
+ *              of DROP_BURST records against a slow consumer - the gaps
+ *              seen by the consumer have to match the overflow count
+ *    mutex     the same transfer through a pthread mutex for comparison
+ *  and the cost of a put and a get in one thread, without any contention -
+ *  what an interrupt and the main loop pay per sample on the MCU.
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "sample_queue.h"
+
+#define RECORDS         5000000u
+#define DROP_RECORDS    2000000u
+#define DROP_BURST      12      // Records put in a row in the drop run
+#define SLOW_SPINS      200     // Consumer work per record in the drop run
+
+typedef struct
+{
+    uint32_t received;
+    uint32_t torn;
+    uint32_t lost;
+    uint32_t reordered;
+} result_t;
+
+static sample_queue_t  m_queue;
+static volatile bool   m_done;
+static bool            m_drop;
+
+static pthread_mutex_t m_mutex = PTHREAD_MUTEX_INITIALIZER;
+static sample_record_t m_locked[SAMPLE_QUEUE_SIZE];
+static uint32_t        m_locked_head;
+static uint32_t        m_locked_tail;
+
+static double now_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void record_make(sample_record_t * p_record, uint32_t seq)
+{
+    memset(p_record, 0, sizeof(*p_record));
+    p_record->t_trigger = seq;
+    p_record->t_done    = seq * 2654435761u;
+    p_record->temp_raw  = (uint16_t)seq;
+    p_record->hum_raw   = (uint16_t)~seq;
+    p_record->press_raw = seq ^ 0x5A5A5A5Au;
+    p_record->ptemp_raw = ~seq;
+    p_record->flags     = (uint8_t)(seq >> 24);
+}
+
+static bool record_check(sample_record_t const * p_record)
+{
+    sample_record_t expected;
+
+    record_make(&expected, p_record->t_trigger);
+    return memcmp(&expected, p_record, sizeof(expected)) == 0;
+}
+
+static bool locked_put(sample_record_t const * p_record)
+{
+    bool ok;
+
+    pthread_mutex_lock(&m_mutex);
+    ok = (m_locked_head - m_locked_tail) < SAMPLE_QUEUE_SIZE;
+    if (ok)
+    {
+        m_locked[m_locked_head++ % SAMPLE_QUEUE_SIZE] = *p_record;
+    }
+    pthread_mutex_unlock(&m_mutex);
+    return ok;
+}
+
+static bool locked_get(sample_record_t * p_record)
+{
+    bool ok;
+
+    pthread_mutex_lock(&m_mutex);
+    ok = m_locked_head != m_locked_tail;
+    if (ok)
+    {
+        *p_record = m_locked[m_locked_tail++ % SAMPLE_QUEUE_SIZE];
+    }
+    pthread_mutex_unlock(&m_mutex);
+    return ok;
+}
+
+static void * producer(void * p_arg)
+{
+    bool            locked = (p_arg != NULL);
+    uint32_t        count  = m_drop ? DROP_RECORDS : RECORDS;
+    sample_record_t record;
+
+    for (uint32_t seq = 1; seq <= count; seq++)
+    {
+        record_make(&record, seq);
+        if (locked)
+        {
+            while (!locked_put(&record))
+            {
+                sched_yield();
+            }
+        }
+        else if (m_drop)
+        {
+            (void)sample_queue_put(&m_queue, &record);
+            if (seq % DROP_BURST == 0)
+            {
+                sched_yield();
+            }
+        }
+        else
+        {
+            while (!sample_queue_put(&m_queue, &record))
+            {
+                sched_yield();
+            }
+        }
+    }
+    m_done = true;
+    return NULL;
+}
+
+static void consume(result_t * p_res, bool locked, uint32_t count)
+{
+    sample_record_t record;
+    uint32_t        last = 0;
+
+    memset(p_res, 0, sizeof(*p_res));
+    for (;;)
+    {
+        bool ok = locked ? locked_get(&record) : sample_queue_get(&m_queue, &record);
+
+        if (!ok)
+        {
+            if (m_done && (locked ? m_locked_head == m_locked_tail
+                                  : m_queue.head == m_queue.tail))
+            {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        p_res->received++;
+        if (!record_check(&record))
+        {
+            p_res->torn++;
+            continue;
+        }
+        if (record.t_trigger <= last)
+        {
+            p_res->reordered++;
+        }
+        else
+        {
+            p_res->lost += record.t_trigger - last - 1;
+        }
+        last = record.t_trigger;
+
+        for (volatile uint32_t i = 0; m_drop && i < SLOW_SPINS; i++)
+        {
+        }
+    }
+    p_res->lost += count - last;
+}
+
+static void run(char const * p_label, bool drop, bool locked)
+{
+    pthread_t thread;
+    result_t  res;
+    double    t;
+
+    sample_queue_init(&m_queue);
+    m_locked_head = 0;
+    m_locked_tail = 0;
+    m_done        = false;
+    m_drop        = drop;
+
+    t = now_s();
+    pthread_create(&thread, NULL, producer, locked ? (void *)1 : NULL);
+    consume(&res, locked, drop ? DROP_RECORDS : RECORDS);
+    pthread_join(thread, NULL);
+    t = now_s() - t;
+
+    printf("  %-6s %9u %8.1f %8u %9u %8u %6u\n", p_label, res.received,
+           res.received / t / 1e6, res.torn, res.lost,
+           sample_queue_overflows_get(&m_queue), res.reordered);
+}
+
+int main(void)
+{
+    printf("%d record queue, %zu byte records\n", SAMPLE_QUEUE_SIZE, sizeof(sample_record_t));
+    printf("  %-6s %9s %8s %8s %9s %8s %6s\n", "", "received", "M rec/s",
+           "torn", "lost", "overflow", "order");
+    run("spin",  false, false);
+    run("drop",  true,  false);
+    run("mutex", false, true);
+
+    sample_record_t record;
+    uint32_t        sink = 0;
+    double          t    = now_s();
+
+    sample_queue_init(&m_queue);
+    record_make(&record, 1);
+    for (uint32_t i = 0; i < RECORDS; i++)
+    {
+        record.t_trigger = i;
+        (void)sample_queue_put(&m_queue, &record);
+        (void)sample_queue_get(&m_queue, &record);
+        sink += record.t_trigger;
+    }
+    t = now_s() - t;
+    printf("  put + get in one thread: %.1f ns (%u)\n", t * 1e9 / RECORDS, sink & 1);
+    return 0;
+}
@@ -0,0 +1,122 @@
+/** Host benchmark - integer Welford window statistics against double
+ *  precision two-pass results.
+ *
+ *    cc -O2 -I. tools/bench_window_stats.c window_stats.c -lm \
+ *       -o /tmp/bench_window_stats && /tmp/bench_window_stats
+ *
+ *  Windows of WINDOW samples of 14-bit codes (noise of a few LSB on a slow
+ *  ramp, occasional spikes) are summarized with window_stats.c. The mean
+ *  and variance are compared with a two-pass double computation, and the
+ *  update time with the plain sum / sum of squares scheme.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "window_stats.h"
+
+#define WINDOW      120
+#define WINDOWS     20000
+
+static uint32_t m_lcg = 1;
+
+static uint32_t lcg(void)
+{
+    m_lcg = m_lcg * 1664525u + 1013904223u;
+    return m_lcg >> 8;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void window_fill(uint16_t * p_codes, uint32_t w)
+{
+    uint32_t base = 20000 + (w % 4000) * 8;
+
+    for (uint32_t i = 0; i < WINDOW; i++)
+    {
+        int32_t code = (int32_t)base + (int32_t)i + (int32_t)(lcg() % 24) - 12;
+
+        if (lcg() % 500 == 0)
+        {
+            code += 6000;
+        }
+        p_codes[i] = (uint16_t)(code & 0xFFFC);
+    }
+}
+
+int main(void)
+{
+    static uint16_t codes[WINDOWS][WINDOW];
+    double          mean_err_max = 0.0;
+    double          var_err_max  = 0.0;
+    uint32_t        sink         = 0;
+
+    for (uint32_t w = 0; w < WINDOWS; w++)
+    {
+        window_fill(codes[w], w);
+    }
+
+    for (uint32_t w = 0; w < WINDOWS; w++)
+    {
+        window_stats_t stats;
+        double         mean = 0.0;
+        double         var  = 0.0;
+
+        window_stats_reset(&stats);
+        for (uint32_t i = 0; i < WINDOW; i++)
+        {
+            window_stats_update(&stats, codes[w][i]);
+            mean += codes[w][i];
+        }
+        mean /= WINDOW;
+        for (uint32_t i = 0; i < WINDOW; i++)
+        {
+            var += (codes[w][i] - mean) * (codes[w][i] - mean);
+        }
+        var /= WINDOW - 1;
+
+        mean_err_max = fmax(mean_err_max,
+                            fabs(window_stats_mean_get(&stats) / 256.0 - mean));
+        var_err_max  = fmax(var_err_max,
+                            fabs(window_stats_variance_get(&stats) - var) / var);
+    }
+
+    double t0 = now_ns();
+    for (uint32_t w = 0; w < WINDOWS; w++)
+    {
+        window_stats_t stats;
+
+        window_stats_reset(&stats);
+        for (uint32_t i = 0; i < WINDOW; i++)
+        {
+            window_stats_update(&stats, codes[w][i]);
+        }
+        sink += window_stats_variance_get(&stats);
+    }
+    double t1 = now_ns();
+    for (uint32_t w = 0; w < WINDOWS; w++)
+    {
+        uint32_t sum   = 0;
+        uint64_t sumsq = 0;
+
+        for (uint32_t i = 0; i < WINDOW; i++)
+        {
+            sum   += codes[w][i];
+            sumsq += (uint32_t)codes[w][i] * codes[w][i];
+        }
+        sink += (uint32_t)((sumsq * WINDOW - (uint64_t)sum * sum) / (WINDOW * (WINDOW - 1)));
+    }
+    double t2 = now_ns();
+
+    printf("window %d: mean error max %.4f LSB, variance error max %.4f %%\n",
+           WINDOW, mean_err_max, var_err_max * 100.0);
+    printf("  welford %.2f ns/sample, sum/sumsq %.2f ns/sample (%u)\n",
+           (t1 - t0) / (WINDOWS * WINDOW), (t2 - t1) / (WINDOWS * WINDOW), sink & 1);
+    return 0;
+}
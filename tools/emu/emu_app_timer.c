@@ -0,0 +1,171 @@
+#include <string.h>
+#include "emu_app_timer.h"
+#include "emu_clock.h"
+#include "emu_twi.h"
+
+static app_timer_t *          mp_timers;
+static emu_app_timer_stats_t  m_stats;
+static void                (* m_idle_handler)(void);
+
+static uint64_t us_to_ticks(uint64_t us)
+{
+    return (us * APP_TIMER_CLOCK_FREQ) / 1000000;
+}
+
+// First microsecond at which the RTC shows the given tick.
+static uint64_t ticks_to_us(uint64_t ticks)
+{
+    return (ticks * 1000000 + APP_TIMER_CLOCK_FREQ - 1) / APP_TIMER_CLOCK_FREQ;
+}
+
+uint64_t emu_app_timer_ticks(void)
+{
+    return us_to_ticks(emu_clock_now_us());
+}
+
+ret_code_t app_timer_init(void)
+{
+    mp_timers = NULL;
+    memset(&m_stats, 0, sizeof(m_stats));
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_create(app_timer_id_t const *      p_timer_id,
+                            app_timer_mode_t            mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    app_timer_t * p_timer = *p_timer_id;
+
+    if (timeout_handler == NULL)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_timer->handler = timeout_handler;
+    p_timer->mode    = mode;
+    p_timer->active  = false;
+
+    for (app_timer_t * p = mp_timers; p != NULL; p = p->p_next)
+    {
+        if (p == p_timer)
+        {
+            return NRF_SUCCESS;
+        }
+    }
+    p_timer->p_next = mp_timers;
+    mp_timers       = p_timer;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context)
+{
+    if (timeout_ticks < APP_TIMER_MIN_TIMEOUT_TICKS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (timer_id->handler == NULL)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    timer_id->p_context    = p_context;
+    timer_id->expiry_ticks = emu_app_timer_ticks() + timeout_ticks;
+    timer_id->period_ticks = timeout_ticks;
+    timer_id->active       = true;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id)
+{
+    timer_id->active = false;
+    return NRF_SUCCESS;
+}
+
+uint32_t app_timer_cnt_get(void)
+{
+    return (uint32_t)(emu_app_timer_ticks() & APP_TIMER_MAX_CNT_VAL);
+}
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from)
+{
+    return (ticks_to - ticks_from) & APP_TIMER_MAX_CNT_VAL;
+}
+
+// Earliest active timer, ties go to the one created first.
+static app_timer_t * next_timer(void)
+{
+    app_timer_t * p_next = NULL;
+
+    for (app_timer_t * p = mp_timers; p != NULL; p = p->p_next)
+    {
+        if (p->active && (p_next == NULL || p->expiry_ticks <= p_next->expiry_ticks))
+        {
+            p_next = p;
+        }
+    }
+    return p_next;
+}
+
+void emu_app_timer_run_until(uint64_t time_us)
+{
+    for (;;)
+    {
+        if (emu_twi_process())
+        {
+            if (m_idle_handler != NULL)
+            {
+                m_idle_handler();
+            }
+            continue;
+        }
+
+        app_timer_t * p_timer = next_timer();
+
+        if (p_timer == NULL || ticks_to_us(p_timer->expiry_ticks) > time_us)
+        {
+            break;
+        }
+
+        uint64_t due_us = ticks_to_us(p_timer->expiry_ticks);
+
+        if (due_us > emu_clock_now_us())
+        {
+            emu_clock_advance_us(due_us - emu_clock_now_us());
+        }
+        else if (emu_app_timer_ticks() > p_timer->expiry_ticks)
+        {
+            m_stats.late++;
+        }
+
+        if (p_timer->mode == APP_TIMER_MODE_REPEATED)
+        {
+            p_timer->expiry_ticks += p_timer->period_ticks;
+        }
+        else
+        {
+            p_timer->active = false;
+        }
+
+        m_stats.expiries++;
+        p_timer->handler(p_timer->p_context);
+        if (m_idle_handler != NULL)
+        {
+            m_idle_handler();
+        }
+    }
+
+    if (time_us > emu_clock_now_us())
+    {
+        emu_clock_advance_us(time_us - emu_clock_now_us());
+    }
+}
+
+void emu_app_timer_stats_get(emu_app_timer_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
+
+void emu_app_timer_idle_handler_set(void (* handler)(void))
+{
+    m_idle_handler = handler;
+}
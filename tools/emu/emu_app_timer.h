@@ -0,0 +1,42 @@
+#ifndef EMU_APP_TIMER_H__
+#define EMU_APP_TIMER_H__
+
+#include <stdint.h>
+#include "app_timer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Event loop behind the app_timer stand-in.
+ *  Expired timers are run in order of expiry, scheduled TWI transactions in
+ *  between. A handler that takes time (nrf_delay_ms(), a blocking transfer)
+ *  advances the virtual clock, so later timers fire late just as they would
+ *  behind a busy interrupt on the target. Repeated timers are rearmed from
+ *  their nominal expiry like the SDK does, so late handlers do not add up.
+ */
+
+// Runs everything that is due up to the given time and leaves the clock
+// there.
+void emu_app_timer_run_until(uint64_t time_us);
+
+// Virtual RTC ticks since reset (not wrapped).
+uint64_t emu_app_timer_ticks(void);
+
+typedef struct
+{
+    uint32_t expiries;   // Handlers run
+    uint32_t late;       // Handlers run after the tick they were due in
+} emu_app_timer_stats_t;
+
+void emu_app_timer_stats_get(emu_app_timer_stats_t * p_stats);
+
+// Called after every timer handler and every TWI transaction, like a pass
+// of the main loop after each interrupt. NULL - none.
+void emu_app_timer_idle_handler_set(void (* handler)(void));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_APP_TIMER_H__
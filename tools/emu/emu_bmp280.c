@@ -0,0 +1,209 @@
+#include <string.h>
+#include "emu_bmp280.h"
+#include "emu_clock.h"
+#include "bmp280.h"
+
+// Standby times of the normal mode in microseconds.
+static const uint32_t m_t_sb_us[8] =
+{
+    500, 62500, 125000, 250000, 500000, 1000000, 2000000, 4000000
+};
+
+// Datasheet example trimming parameters (dig_T1..dig_P9).
+static const int32_t m_trimming[12] =
+{
+    27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000
+};
+
+static emu_i2c_device_t   m_device;
+static emu_bmp280_stats_t m_stats;
+
+static uint8_t  m_regs[256];
+static uint8_t  m_pointer;
+static uint64_t m_meas_start_us;   // Start of the current/last measurement
+static uint64_t m_meas_end_us;
+static bool     m_measuring;
+static int32_t  m_adc_t = 519888;
+static int32_t  m_adc_p = 415148;
+
+static uint32_t meas_time_us(void)
+{
+    uint8_t ctrl = m_regs[BMP280_REG_CTRL_MEAS];
+
+    return BMP280_MEAS_TIME_MAX_US(ctrl >> 5, (ctrl >> 2) & 0x07);
+}
+
+static void data_latch(void)
+{
+    uint8_t ctrl   = m_regs[BMP280_REG_CTRL_MEAS];
+    int32_t adc_t  = ((ctrl >> 5) == 0) ? 0x80000 : m_adc_t;
+    int32_t adc_p  = (((ctrl >> 2) & 0x07) == 0) ? 0x80000 : m_adc_p;
+    uint8_t * p_data = &m_regs[BMP280_REG_PRESS];
+
+    p_data[0] = (uint8_t)(adc_p >> 12);
+    p_data[1] = (uint8_t)(adc_p >> 4);
+    p_data[2] = (uint8_t)((adc_p & 0x0F) << 4);
+    p_data[3] = (uint8_t)(adc_t >> 12);
+    p_data[4] = (uint8_t)(adc_t >> 4);
+    p_data[5] = (uint8_t)((adc_t & 0x0F) << 4);
+
+    m_stats.measurements++;
+}
+
+// Brings the model up to the current virtual time.
+static void update(void)
+{
+    uint64_t now  = emu_clock_now_us();
+    uint8_t  mode = m_regs[BMP280_REG_CTRL_MEAS] & BMP280_MODE_MASK;
+
+    if (m_measuring && now >= m_meas_end_us)
+    {
+        data_latch();
+        m_measuring = false;
+
+        if (mode == BMP280_MODE_FORCED)
+        {
+            m_regs[BMP280_REG_CTRL_MEAS] &= (uint8_t)~BMP280_MODE_MASK;
+        }
+    }
+
+    if (mode == BMP280_MODE_NORMAL)
+    {
+        uint64_t period = meas_time_us() + m_t_sb_us[m_regs[BMP280_REG_CONFIG] >> 5];
+
+        // Cycles started since the last update; the one still running is
+        // latched by the completion check above on a later update.
+        while (m_meas_start_us + period <= now)
+        {
+            m_meas_start_us += period;
+            m_meas_end_us    = m_meas_start_us + meas_time_us();
+            if (m_meas_end_us <= now)
+            {
+                data_latch();
+            }
+        }
+        m_measuring = now < m_meas_end_us;
+    }
+
+    m_regs[BMP280_REG_STATUS] = m_measuring ? BMP280_STATUS_MEASURING : 0;
+}
+
+static void measurement_start(void)
+{
+    m_meas_start_us = emu_clock_now_us();
+    m_meas_end_us   = m_meas_start_us + meas_time_us();
+    m_measuring     = true;
+}
+
+static void reset(void)
+{
+    memset(m_regs, 0, sizeof(m_regs));
+
+    for (int i = 0; i < 12; i++)
+    {
+        m_regs[BMP280_REG_CALIB + 2 * i]     = (uint8_t)(m_trimming[i] & 0xFF);
+        m_regs[BMP280_REG_CALIB + 2 * i + 1] = (uint8_t)((m_trimming[i] >> 8) & 0xFF);
+    }
+    m_regs[BMP280_REG_ID] = BMP280_CHIP_ID;
+    m_regs[BMP280_REG_PRESS + 0] = 0x80;
+    m_regs[BMP280_REG_PRESS + 3] = 0x80;
+    m_measuring = false;
+}
+
+static bool bmp280_write(emu_i2c_device_t * p_device, uint8_t const * p_data, uint8_t length)
+{
+    update();
+
+    if (length >= 1)
+    {
+        m_pointer = p_data[0];
+    }
+
+    // Register/value pairs.
+    for (uint8_t i = 0; i + 1 < length; i += 2)
+    {
+        uint8_t reg   = p_data[i];
+        uint8_t value = p_data[i + 1];
+
+        m_stats.register_writes++;
+
+        switch (reg)
+        {
+        case BMP280_REG_RESET:
+            if (value == BMP280_RESET_VALUE)
+            {
+                reset();
+            }
+            break;
+
+        case BMP280_REG_CTRL_MEAS:
+            m_regs[reg] = value;
+            if ((value & BMP280_MODE_MASK) == BMP280_MODE_FORCED ||
+                (value & BMP280_MODE_MASK) == BMP280_MODE_NORMAL)
+            {
+                measurement_start();
+            }
+            else
+            {
+                m_measuring = false;
+            }
+            break;
+
+        case BMP280_REG_CONFIG:
+            m_regs[reg] = value;
+            break;
+
+        default:
+            break; // Read only
+        }
+    }
+
+    update();
+    return true;
+}
+
+static bool bmp280_read(emu_i2c_device_t * p_device, uint8_t * p_data, uint8_t length)
+{
+    update();
+
+    // Auto-increment, data registers are shadowed for the whole burst.
+    for (uint8_t i = 0; i < length; i++)
+    {
+        p_data[i] = m_regs[(uint8_t)(m_pointer + i)];
+    }
+    return true;
+}
+
+emu_i2c_device_t * emu_bmp280_init(void)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+    reset();
+
+    m_device.address = BMP280_ADDR;
+    m_device.write   = bmp280_write;
+    m_device.read    = bmp280_read;
+    return &m_device;
+}
+
+void emu_bmp280_adc_set(int32_t adc_t, int32_t adc_p)
+{
+    m_adc_t = adc_t;
+    m_adc_p = adc_p;
+}
+
+void emu_bmp280_calib_get(uint8_t p_calib[24])
+{
+    memcpy(p_calib, &m_regs[BMP280_REG_CALIB], BMP280_CALIB_SIZE);
+}
+
+uint8_t emu_bmp280_mode_get(void)
+{
+    update();
+    return m_regs[BMP280_REG_CTRL_MEAS] & BMP280_MODE_MASK;
+}
+
+void emu_bmp280_stats_get(emu_bmp280_stats_t * p_stats)
+{
+    update();
+    *p_stats = m_stats;
+}
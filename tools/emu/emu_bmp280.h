@@ -0,0 +1,39 @@
+#ifndef EMU_BMP280_H__
+#define EMU_BMP280_H__
+
+#include "emu_twi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** BMP280 register model.
+ *  Calibration block and default ADC values are the example of the Bosch
+ *  datasheet (adc_T = 519888, adc_P = 415148 -> 25.08 C, 100653 Pa).
+ *  Forced and normal mode follow the datasheet timing: the data registers
+ *  are updated at the end of each measurement (BMP280_MEAS_TIME_MAX_US) and
+ *  status.measuring is set while one is running.
+ */
+typedef struct
+{
+    uint32_t measurements;
+    uint32_t register_writes;
+} emu_bmp280_stats_t;
+
+emu_i2c_device_t * emu_bmp280_init(void);
+
+// Raw 20-bit values delivered by the next measurements.
+void emu_bmp280_adc_set(int32_t adc_t, int32_t adc_p);
+
+// Calibration block as stored at 0x88..0x9F.
+void emu_bmp280_calib_get(uint8_t p_calib[24]);
+
+uint8_t emu_bmp280_mode_get(void);
+
+void emu_bmp280_stats_get(emu_bmp280_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_BMP280_H__
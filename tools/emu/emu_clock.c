@@ -0,0 +1,18 @@
+#include "emu_clock.h"
+
+static uint64_t m_now_us;
+
+uint64_t emu_clock_now_us(void)
+{
+    return m_now_us;
+}
+
+void emu_clock_advance_us(uint64_t us)
+{
+    m_now_us += us;
+}
+
+void emu_clock_reset(void)
+{
+    m_now_us = 0;
+}
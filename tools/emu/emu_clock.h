@@ -0,0 +1,23 @@
+#ifndef EMU_CLOCK_H__
+#define EMU_CLOCK_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Virtual time of the emulator in microseconds. It only moves when the
+ *  emulated bus or the scenario advances it, so runs are deterministic.
+ */
+uint64_t emu_clock_now_us(void);
+
+void emu_clock_advance_us(uint64_t us);
+
+void emu_clock_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_CLOCK_H__
@@ -0,0 +1,172 @@
+#include <math.h>
+#include <string.h>
+#include "emu_env.h"
+#include "emu_clock.h"
+#include "emu_hdc1080.h"
+#include "emu_rand.h"
+#include "emu_twi.h"
+
+#define DAY_S   86400.0
+#define PI      3.14159265358979
+
+static emu_env_config_t const m_scenarios[] =
+{
+    {
+        .p_name = "office",     .seed = 1,
+        .temp_mean_c = 22.0,    .temp_diurnal_c = 1.5,
+        .rh_mean = 45.0,        .rh_diurnal = 5.0,      .peak_hour = 15.0,
+        .hvac_period_s = 1800,  .hvac_temp_c = -2.0,    .hvac_rh = -4.0,
+        .hvac_tau_s = 600,
+        .spikes_per_day = 2,    .spike_rh = 8.0,        .spike_tau_s = 900,
+        .noise_scale = 1.0,     .bus_fault_rate = 1e-4
+    },
+    {
+        .p_name = "greenhouse", .seed = 2,
+        .temp_mean_c = 24.0,    .temp_diurnal_c = 8.0,
+        .rh_mean = 70.0,        .rh_diurnal = 20.0,     .peak_hour = 14.0,
+        .spikes_per_day = 4,    .spike_rh = 15.0,       .spike_tau_s = 1800,
+        .noise_scale = 1.0,     .bus_fault_rate = 1e-3
+    },
+    {
+        .p_name = "cellar",     .seed = 3,
+        .temp_mean_c = 12.0,    .temp_diurnal_c = 0.3,
+        .rh_mean = 85.0,        .rh_diurnal = 2.0,      .peak_hour = 18.0,
+        .noise_scale = 1.0
+    },
+    {
+        .p_name = "bathroom",   .seed = 4,
+        .temp_mean_c = 21.0,    .temp_diurnal_c = 1.0,
+        .rh_mean = 55.0,        .rh_diurnal = 5.0,      .peak_hour = 16.0,
+        .spikes_per_day = 3,    .spike_rh = 35.0,       .spike_tau_s = 1200,
+        .noise_scale = 1.0,     .bus_fault_rate = 1e-4
+    },
+};
+
+static emu_env_config_t m_config;
+static emu_env_stats_t  m_stats;
+static emu_rand_t       m_hvac_rand;
+static emu_rand_t       m_spike_rand;
+static double           m_start_s;
+static double           m_now_s;        // Time the state below is at
+static bool             m_hvac_on;
+static double           m_hvac_next_s;
+static double           m_hvac_temp;    // Current HVAC offsets
+static double           m_hvac_rh;
+static double           m_spike_next_s;
+static double           m_spike;        // Current spike offset
+static double           m_temp_c;
+static double           m_rh_percent;
+
+emu_env_config_t const * emu_env_scenario_get(char const * p_name)
+{
+    for (uint32_t i = 0; i < sizeof(m_scenarios) / sizeof(m_scenarios[0]); i++)
+    {
+        if (strcmp(m_scenarios[i].p_name, p_name) == 0)
+        {
+            return &m_scenarios[i];
+        }
+    }
+    return NULL;
+}
+
+emu_env_config_t const * emu_env_scenario_at(uint32_t index)
+{
+    return (index < sizeof(m_scenarios) / sizeof(m_scenarios[0])) ? &m_scenarios[index] : NULL;
+}
+
+static double next_event_s(emu_rand_t * p_rand, double mean_s)
+{
+    return (mean_s > 0.0) ? m_now_s + emu_rand_exp(p_rand, mean_s) : INFINITY;
+}
+
+// First order response and decay over dt.
+static void relax(double dt_s)
+{
+    if (m_config.hvac_tau_s > 0.0)
+    {
+        double k = 1.0 - exp(-dt_s / m_config.hvac_tau_s);
+
+        m_hvac_temp += ((m_hvac_on ? m_config.hvac_temp_c : 0.0) - m_hvac_temp) * k;
+        m_hvac_rh   += ((m_hvac_on ? m_config.hvac_rh : 0.0) - m_hvac_rh) * k;
+    }
+    if (m_config.spike_tau_s > 0.0)
+    {
+        m_spike *= exp(-dt_s / m_config.spike_tau_s);
+    }
+    m_now_s += dt_s;
+}
+
+void emu_env_init(emu_env_config_t const * p_config)
+{
+    m_config = *p_config;
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    // [one generator per source, see emu_env.h]
+    emu_rand_seed(&m_hvac_rand, m_config.seed * 4 + 0);
+    emu_rand_seed(&m_spike_rand, m_config.seed * 4 + 1);
+    emu_hdc1080_noise_set(m_config.noise_scale, m_config.seed * 4 + 2);
+    emu_twi_fault_set(m_config.bus_fault_rate, m_config.seed * 4 + 3);
+
+    m_start_s      = emu_clock_now_us() / 1e6;
+    m_now_s        = m_start_s;
+    m_hvac_on      = false;
+    m_hvac_temp    = 0.0;
+    m_hvac_rh      = 0.0;
+    m_spike        = 0.0;
+    m_hvac_next_s  = next_event_s(&m_hvac_rand, m_config.hvac_period_s);
+    m_spike_next_s = next_event_s(&m_spike_rand,
+                                  (m_config.spikes_per_day > 0.0)
+                                  ? DAY_S / m_config.spikes_per_day : 0.0);
+    emu_env_update();
+}
+
+void emu_env_update(void)
+{
+    double now_s = emu_clock_now_us() / 1e6;
+
+    // Events in between, in order.
+    for (;;)
+    {
+        double next_s = fmin(m_hvac_next_s, m_spike_next_s);
+
+        if (next_s > now_s)
+        {
+            break;
+        }
+        relax(next_s - m_now_s);
+
+        if (next_s == m_hvac_next_s)
+        {
+            m_hvac_on     = !m_hvac_on;
+            m_hvac_next_s = next_event_s(&m_hvac_rand, m_config.hvac_period_s);
+            m_stats.hvac_switches++;
+        }
+        else
+        {
+            m_spike       += m_config.spike_rh * (0.5 + emu_rand_unit(&m_spike_rand));
+            m_spike_next_s = next_event_s(&m_spike_rand, DAY_S / m_config.spikes_per_day);
+            m_stats.spikes++;
+        }
+    }
+    relax(now_s - m_now_s);
+
+    double phase = 2.0 * PI * ((now_s - m_start_s) / DAY_S - m_config.peak_hour / 24.0);
+    double cycle = cos(phase);   // 1 at the peak hour
+
+    m_temp_c     = m_config.temp_mean_c + m_config.temp_diurnal_c * cycle + m_hvac_temp;
+    m_rh_percent = m_config.rh_mean - m_config.rh_diurnal * cycle + m_hvac_rh + m_spike;
+    m_rh_percent = fmin(fmax(m_rh_percent, 0.0), 100.0);
+
+    emu_hdc1080_env_set(m_temp_c, m_rh_percent);
+}
+
+void emu_env_get(double * p_temp_c, double * p_rh_percent)
+{
+    *p_temp_c     = m_temp_c;
+    *p_rh_percent = m_rh_percent;
+}
+
+void emu_env_stats_get(emu_env_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
@@ -0,0 +1,70 @@
+#ifndef EMU_ENV_H__
+#define EMU_ENV_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Synthetic indoor/outdoor environment for the HDC1080 model.
+ *  Temperature and humidity are the sum of
+ *    - a daily cycle, humidity in anti-phase with temperature
+ *    - HVAC switching on and off at random intervals, the room following
+ *      each step with a first order time constant
+ *    - humidity spikes (shower, breath, irrigation) decaying exponentially
+ *  plus sensor noise for the configured resolution (emu_hdc1080_noise_set())
+ *  and transient bus faults (emu_twi_fault_set()). Every random source has
+ *  its own generator derived from the seed, so the same seed gives the same
+ *  environment whatever the firmware under test does with the bus.
+ */
+typedef struct
+{
+    char const * p_name;
+    uint64_t     seed;
+    double       temp_mean_c;
+    double       temp_diurnal_c;    // Amplitude of the daily cycle
+    double       rh_mean;
+    double       rh_diurnal;
+    double       peak_hour;         // Time of day of the temperature maximum
+    double       hvac_period_s;     // Mean time between switching, 0: no HVAC
+    double       hvac_temp_c;       // Offset while running
+    double       hvac_rh;
+    double       hvac_tau_s;
+    double       spikes_per_day;
+    double       spike_rh;          // Mean height of a spike
+    double       spike_tau_s;
+    double       noise_scale;       // See emu_hdc1080_noise_set()
+    double       bus_fault_rate;    // Probability per transfer
+} emu_env_config_t;
+
+// Built-in scenarios, NULL for an unknown name.
+emu_env_config_t const * emu_env_scenario_get(char const * p_name);
+
+// Scenario by index, NULL past the last.
+emu_env_config_t const * emu_env_scenario_at(uint32_t index);
+
+// Starts the environment at the current virtual time (midnight) and sets
+// up noise and bus faults.
+void emu_env_init(emu_env_config_t const * p_config);
+
+// Moves the environment to the virtual clock and hands it to the HDC1080
+// model. Call ahead of every conversion.
+void emu_env_update(void);
+
+// Values handed to the model by the last emu_env_update().
+void emu_env_get(double * p_temp_c, double * p_rh_percent);
+
+typedef struct
+{
+    uint32_t hvac_switches;
+    uint32_t spikes;
+} emu_env_stats_t;
+
+void emu_env_stats_get(emu_env_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_ENV_H__
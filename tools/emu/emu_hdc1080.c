@@ -0,0 +1,281 @@
+#include <string.h>
+#include "emu_hdc1080.h"
+#include "emu_clock.h"
+#include "emu_rand.h"
+#include "hdc1080.h"
+
+static emu_i2c_device_t    m_device;
+static emu_hdc1080_stats_t m_stats;
+
+static uint8_t  m_pointer;
+static uint16_t m_config = HDC1080_CONFIG_RESET_VALUE;
+static uint64_t m_ready_at_us;   // End of the running conversion
+static bool     m_temp_pending;  // Conversion includes T
+static bool     m_hum_pending;   // Conversion includes RH
+static uint16_t m_temp_raw;
+static uint16_t m_hum_raw;
+static double   m_temp_c     = 25.0;
+static double   m_rh_percent = 50.0;
+static double   m_conversion_scale = 1.0;
+static bool     m_powered = true;
+static uint64_t m_started_at_us; // End of the start-up time
+static double   m_noise_scale;   // 0: noise free
+static emu_rand_t m_noise_rand;
+
+static uint16_t quantize(double fraction, unsigned bits)
+{
+    if (fraction < 0.0)
+    {
+        fraction = 0.0;
+    }
+    if (fraction > 65535.0 / 65536.0)
+    {
+        fraction = 65535.0 / 65536.0;
+    }
+    uint16_t code = (uint16_t)(fraction * 65536.0);
+
+    return (uint16_t)(code & (0xFFFFu << (16 - bits)));
+}
+
+static unsigned temp_bits(void)
+{
+    return (m_config & HDC1080_CONFIG_TRES_MASK) ? 11 : 14;
+}
+
+static unsigned hum_bits(void)
+{
+    switch (m_config & HDC1080_CONFIG_HRES_MASK)
+    {
+    case HDC1080_CONFIG_HRES_11BIT: return 11;
+    case HDC1080_CONFIG_HRES_8BIT:  return 8;
+    default:                        return 14;
+    }
+}
+
+// Noise (1 sigma) per resolution - not in the datasheet, assumed from the
+// 0.1 C / 0.1 %RH repeatability with coarser steps being noisier.
+static double temp_noise_c(void)
+{
+    return (temp_bits() == 14) ? 0.01 : 0.04;
+}
+
+static double hum_noise_percent(void)
+{
+    switch (hum_bits())
+    {
+    case 14: return 0.02;
+    case 11: return 0.05;
+    default: return 0.2;
+    }
+}
+
+static uint32_t temp_conversion_us(void)
+{
+    return (temp_bits() == 14) ? 6350 : 3650;
+}
+
+static uint32_t hum_conversion_us(void)
+{
+    switch (hum_bits())
+    {
+    case 14: return 6500;
+    case 11: return 3850;
+    default: return 2500;
+    }
+}
+
+static void conversion_start(void)
+{
+    bool both = (m_config & HDC1080_CONFIG_MODE) != 0;
+
+    m_temp_pending = both || m_pointer == HDC1080_REG_TEMP;
+    m_hum_pending  = both || m_pointer == HDC1080_REG_HUM;
+    m_ready_at_us  = emu_clock_now_us() +
+                     (uint64_t)(m_conversion_scale *
+                                ((m_temp_pending ? temp_conversion_us() : 0) +
+                                 (m_hum_pending ? hum_conversion_us() : 0)));
+
+    m_stats.conversions++;
+    if (m_config & HDC1080_CONFIG_HEAT)
+    {
+        m_stats.heater_conversions++;
+    }
+
+    if (m_temp_pending)
+    {
+        double temp_c = m_temp_c;
+
+        if (m_noise_scale > 0.0)
+        {
+            temp_c += m_noise_scale * temp_noise_c() * emu_rand_gauss(&m_noise_rand);
+        }
+        m_temp_raw = quantize((temp_c + 40.0) / 165.0, temp_bits());
+    }
+    if (m_hum_pending)
+    {
+        double rh_percent = m_rh_percent;
+
+        if (m_noise_scale > 0.0)
+        {
+            rh_percent += m_noise_scale * hum_noise_percent() * emu_rand_gauss(&m_noise_rand);
+        }
+        m_hum_raw = quantize(rh_percent / 100.0, hum_bits());
+    }
+}
+
+static bool responding(void)
+{
+    if (!m_powered || emu_clock_now_us() < m_started_at_us)
+    {
+        m_stats.nacks++;
+        return false;
+    }
+    return true;
+}
+
+static bool hdc1080_write(emu_i2c_device_t * p_device, uint8_t const * p_data, uint8_t length)
+{
+    if (!responding())
+    {
+        return false;
+    }
+    if (length == 0)
+    {
+        return true;
+    }
+
+    m_pointer = p_data[0];
+
+    if (length == 1)
+    {
+        if (m_pointer == HDC1080_REG_TEMP || m_pointer == HDC1080_REG_HUM)
+        {
+            conversion_start();
+        }
+    }
+    else if (length >= 3 && m_pointer == HDC1080_REG_CONFIG)
+    {
+        uint16_t value = ((uint16_t)p_data[1] << 8) | p_data[2];
+
+        m_stats.config_writes++;
+        m_config = (value & HDC1080_CONFIG_RST)
+                 ? HDC1080_CONFIG_RESET_VALUE
+                 : (uint16_t)(value & ~HDC1080_CONFIG_BTST);
+    }
+    return true;
+}
+
+static bool hdc1080_read(emu_i2c_device_t * p_device, uint8_t * p_data, uint8_t length)
+{
+    uint8_t  bytes[4];
+    uint8_t  count = 2;
+    uint16_t value;
+
+    if (!responding())
+    {
+        return false;
+    }
+
+    switch (m_pointer)
+    {
+    case HDC1080_REG_TEMP:
+    case HDC1080_REG_HUM:
+        if (emu_clock_now_us() < m_ready_at_us)
+        {
+            m_stats.nacks++;
+            return false;
+        }
+        if (m_pointer == HDC1080_REG_TEMP && m_temp_pending && m_hum_pending)
+        {
+            bytes[0] = (uint8_t)(m_temp_raw >> 8);
+            bytes[1] = (uint8_t)m_temp_raw;
+            bytes[2] = (uint8_t)(m_hum_raw >> 8);
+            bytes[3] = (uint8_t)m_hum_raw;
+            count    = 4;
+        }
+        else
+        {
+            value    = (m_pointer == HDC1080_REG_TEMP) ? m_temp_raw : m_hum_raw;
+            bytes[0] = (uint8_t)(value >> 8);
+            bytes[1] = (uint8_t)value;
+        }
+        break;
+
+    default:
+        switch (m_pointer)
+        {
+        case HDC1080_REG_CONFIG: value = m_config;                break;
+        case HDC1080_REG_MAN_ID: value = HDC1080_MANUFACTURER_ID; break;
+        case HDC1080_REG_DEV_ID: value = HDC1080_DEVICE_ID;       break;
+        default:                 value = 0xFFFF;                  break;
+        }
+        bytes[0] = (uint8_t)(value >> 8);
+        bytes[1] = (uint8_t)value;
+        break;
+    }
+
+    // Past the end of the register the bus reads back 0xFF.
+    memset(p_data, 0xFF, length);
+    memcpy(p_data, bytes, (length < count) ? length : count);
+    return true;
+}
+
+emu_i2c_device_t * emu_hdc1080_init(void)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_pointer       = 0;
+    m_config        = HDC1080_CONFIG_RESET_VALUE;
+    m_ready_at_us   = 0;
+    m_powered       = true;
+    m_started_at_us = 0;
+
+    m_device.address = HDC1080_ADDR;
+    m_device.write   = hdc1080_write;
+    m_device.read    = hdc1080_read;
+    return &m_device;
+}
+
+void emu_hdc1080_env_set(double temp_c, double rh_percent)
+{
+    m_temp_c     = temp_c;
+    m_rh_percent = rh_percent;
+}
+
+uint16_t emu_hdc1080_config_get(void)
+{
+    return m_config;
+}
+
+uint32_t emu_hdc1080_conversion_us(void)
+{
+    return (uint32_t)(m_conversion_scale * (temp_conversion_us() + hum_conversion_us()));
+}
+
+void emu_hdc1080_power_set(bool on)
+{
+    if (on && !m_powered)
+    {
+        m_pointer       = 0;
+        m_config        = HDC1080_CONFIG_RESET_VALUE;
+        m_ready_at_us   = 0;
+        m_started_at_us = emu_clock_now_us() + HDC1080_STARTUP_MS * 1000u;
+        m_stats.power_ups++;
+    }
+    m_powered = on;
+}
+
+void emu_hdc1080_conversion_scale_set(double scale)
+{
+    m_conversion_scale = scale;
+}
+
+void emu_hdc1080_noise_set(double scale, uint64_t seed)
+{
+    m_noise_scale = scale;
+    emu_rand_seed(&m_noise_rand, seed);
+}
+
+void emu_hdc1080_stats_get(emu_hdc1080_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
@@ -0,0 +1,53 @@
+#ifndef EMU_HDC1080_H__
+#define EMU_HDC1080_H__
+
+#include "emu_twi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** HDC1080 register model.
+ *  Writing the pointer register with 0x00 (0x01 with MODE = 0) starts a
+ *  conversion; reads of the measurement registers are NACKed until it has
+ *  completed (6.35/3.65 ms for T, 6.5/3.85/2.5 ms for RH depending on the
+ *  resolution). Codes are truncated to the configured resolution.
+ */
+typedef struct
+{
+    uint32_t conversions;
+    uint32_t heater_conversions; // Conversions run with HEAT set
+    uint32_t nacks;              // Reads refused while converting
+    uint32_t config_writes;
+    uint32_t power_ups;
+} emu_hdc1080_stats_t;
+
+emu_i2c_device_t * emu_hdc1080_init(void);
+
+// Environment seen by the next conversion.
+void emu_hdc1080_env_set(double temp_c, double rh_percent);
+
+uint16_t emu_hdc1080_config_get(void);
+
+// Conversion time in microseconds for the current configuration.
+uint32_t emu_hdc1080_conversion_us(void);
+
+// Supply switch. Without supply, and for HDC1080_STARTUP_MS after power-up,
+// the sensor NACKs everything; power-up starts from the reset state.
+void emu_hdc1080_power_set(bool on);
+
+// Scales the datasheet conversion times (part spread, supply, temperature).
+void emu_hdc1080_conversion_scale_set(double scale);
+
+// Gaussian noise on the environment ahead of the quantization, as a multiple
+// of the default for the configured resolution (0 turns it off, the
+// default).
+void emu_hdc1080_noise_set(double scale, uint64_t seed);
+
+void emu_hdc1080_stats_get(emu_hdc1080_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_HDC1080_H__
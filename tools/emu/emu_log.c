@@ -0,0 +1,31 @@
+#include <stddef.h>
+#include "emu_log.h"
+
+static emu_log_handler_t m_handler;
+static uint32_t          m_entries;
+
+void emu_log_entry(char const * p_format, ...)
+{
+    (void)p_format;
+
+    m_entries++;
+    if (m_handler != NULL)
+    {
+        m_handler();
+    }
+}
+
+void emu_log_handler_set(emu_log_handler_t handler)
+{
+    m_handler = handler;
+}
+
+uint32_t emu_log_entries(void)
+{
+    return m_entries;
+}
+
+void emu_log_reset(void)
+{
+    m_entries = 0;
+}
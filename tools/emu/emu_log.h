@@ -0,0 +1,30 @@
+#ifndef EMU_LOG_H__
+#define EMU_LOG_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Log entries of the modules under test, written through the NRF_LOG_*
+ *  stand-in (include/nrf_log.h). A run can follow them with a handler, e.g.
+ *  to model the deferred log buffer.
+ */
+typedef void (* emu_log_handler_t)(void);
+
+void emu_log_entry(char const * p_format, ...);
+
+// Called for every entry, NULL - counted only.
+void emu_log_handler_set(emu_log_handler_t handler);
+
+// Entries since the last emu_log_reset().
+uint32_t emu_log_entries(void);
+
+void emu_log_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_LOG_H__
@@ -0,0 +1,37 @@
+#include <math.h>
+#include "emu_rand.h"
+
+void emu_rand_seed(emu_rand_t * p_rand, uint64_t seed)
+{
+    p_rand->state = seed;
+}
+
+uint64_t emu_rand_next(emu_rand_t * p_rand)
+{
+    uint64_t z = (p_rand->state += 0x9E3779B97F4A7C15ull);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+double emu_rand_unit(emu_rand_t * p_rand)
+{
+    return (emu_rand_next(p_rand) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double emu_rand_gauss(emu_rand_t * p_rand)
+{
+    double sum = 0.0;
+
+    for (int i = 0; i < 12; i++)
+    {
+        sum += emu_rand_unit(p_rand);
+    }
+    return sum - 6.0;
+}
+
+double emu_rand_exp(emu_rand_t * p_rand, double mean)
+{
+    return -mean * log(1.0 - emu_rand_unit(p_rand));
+}
@@ -0,0 +1,39 @@
+#ifndef EMU_RAND_H__
+#define EMU_RAND_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Seeded pseudo random numbers (splitmix64) for the emulator models.
+ *  Every model keeps its own generator, so a model drawing more or fewer
+ *  numbers - another sampling period, another algorithm under test - does
+ *  not change what the others produce.
+ */
+typedef struct
+{
+    uint64_t state;
+} emu_rand_t;
+
+void emu_rand_seed(emu_rand_t * p_rand, uint64_t seed);
+
+uint64_t emu_rand_next(emu_rand_t * p_rand);
+
+// Uniform in [0, 1).
+double emu_rand_unit(emu_rand_t * p_rand);
+
+// Approximately standard normal - sum of 12 uniforms, so only additions
+// are involved and the values do not depend on the host libm.
+double emu_rand_gauss(emu_rand_t * p_rand);
+
+// Exponentially distributed with the given mean (intervals of a Poisson
+// process).
+double emu_rand_exp(emu_rand_t * p_rand, double mean);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_RAND_H__
@@ -0,0 +1,139 @@
+#include <string.h>
+#include "emu_rtc.h"
+#include "emu_app_timer.h"
+#include "emu_clock.h"
+
+#define RTC_CLOCK_HZ    32768
+#define COUNTER_RANGE   (1ull << 24)
+
+NRF_RTC_Type           emu_rtc2;
+static emu_rtc_stats_t m_stats;
+
+// Runs that do not use RTC2 link without a handler.
+__attribute__((weak)) void RTC2_IRQHandler(void)
+{
+}
+
+static uint64_t divider_us(NRF_RTC_Type const * p_reg)
+{
+    return (uint64_t)(p_reg->prescaler + 1) * 1000000;
+}
+
+// Unwrapped counter value.
+static uint64_t counter(NRF_RTC_Type const * p_reg)
+{
+    if (!p_reg->running)
+    {
+        return p_reg->base;
+    }
+    return p_reg->base +
+           ((emu_clock_now_us() - p_reg->start_us) * RTC_CLOCK_HZ) / divider_us(p_reg);
+}
+
+// First microsecond at which the counter shows the given (unwrapped) value.
+static uint64_t counter_to_us(NRF_RTC_Type const * p_reg, uint64_t value)
+{
+    return p_reg->start_us +
+           ((value - p_reg->base) * divider_us(p_reg) + RTC_CLOCK_HZ - 1) / RTC_CLOCK_HZ;
+}
+
+void nrf_rtc_prescaler_set(NRF_RTC_Type * p_reg, uint32_t val)
+{
+    p_reg->prescaler = val & 0xFFF;
+}
+
+void nrf_rtc_task_trigger(NRF_RTC_Type * p_reg, nrf_rtc_task_t task)
+{
+    uint64_t now = counter(p_reg);
+
+    switch (task)
+    {
+        case NRF_RTC_TASK_START:
+            p_reg->running = true;
+            break;
+        case NRF_RTC_TASK_STOP:
+            p_reg->running = false;
+            break;
+        case NRF_RTC_TASK_CLEAR:
+            now = 0;
+            break;
+    }
+    p_reg->base     = now;
+    p_reg->start_us = emu_clock_now_us();
+}
+
+void nrf_rtc_cc_set(NRF_RTC_Type * p_reg, uint32_t ch, uint32_t cc_val)
+{
+    p_reg->cc[ch] = cc_val & RTC_COUNTER_COUNTER_Msk;
+}
+
+uint32_t nrf_rtc_counter_get(NRF_RTC_Type const * p_reg)
+{
+    return (uint32_t)(counter(p_reg) & RTC_COUNTER_COUNTER_Msk);
+}
+
+void nrf_rtc_event_clear(NRF_RTC_Type * p_reg, nrf_rtc_event_t event)
+{
+    p_reg->event_compare[event] = false;
+}
+
+bool nrf_rtc_event_pending(NRF_RTC_Type const * p_reg, nrf_rtc_event_t event)
+{
+    return p_reg->event_compare[event];
+}
+
+void nrf_rtc_int_enable(NRF_RTC_Type * p_reg, uint32_t mask)
+{
+    p_reg->intenset |= mask;
+}
+
+void nrf_rtc_int_disable(NRF_RTC_Type * p_reg, uint32_t mask)
+{
+    p_reg->intenset &= ~mask;
+}
+
+void emu_rtc_reset(void)
+{
+    memset(&emu_rtc2, 0, sizeof(emu_rtc2));
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+void emu_rtc_run_until(uint64_t time_us)
+{
+    NRF_RTC_Type * p_reg = NRF_RTC2;
+
+    while (p_reg->running)
+    {
+        // Next time the counter matches CC[0] - a match with the current
+        // value has already been taken.
+        uint64_t now_cnt = counter(p_reg);
+        uint64_t delta   = (p_reg->cc[0] - now_cnt) & (COUNTER_RANGE - 1);
+        uint64_t due_cnt = now_cnt + (delta != 0 ? delta : COUNTER_RANGE);
+        uint64_t due_us  = counter_to_us(p_reg, due_cnt);
+
+        if (due_us > time_us)
+        {
+            break;
+        }
+
+        emu_app_timer_run_until(due_us);
+        if (emu_clock_now_us() > due_us)
+        {
+            m_stats.late++;
+        }
+
+        p_reg->event_compare[0] = true;
+        if (p_reg->intenset & NRF_RTC_INT_COMPARE0_MASK)
+        {
+            m_stats.interrupts++;
+            RTC2_IRQHandler();
+        }
+    }
+
+    emu_app_timer_run_until(time_us);
+}
+
+void emu_rtc_stats_get(emu_rtc_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
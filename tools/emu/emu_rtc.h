@@ -0,0 +1,33 @@
+#ifndef EMU_RTC_H__
+#define EMU_RTC_H__
+
+#include <stdint.h>
+#include "nrf_rtc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Event loop for RTC2 on top of emu_app_timer_run_until().
+ *  When the counter reaches CC[0] the COMPARE0 event is set and, with the
+ *  interrupt enabled, RTC2_IRQHandler() runs. App timers and TWI
+ *  transactions due in between are run first, a compare that comes due
+ *  while one of them blocks is taken late.
+ */
+void emu_rtc_run_until(uint64_t time_us);
+
+typedef struct
+{
+    uint32_t interrupts;    // RTC2_IRQHandler() calls
+    uint32_t late;          // Interrupts taken after the compare tick
+} emu_rtc_stats_t;
+
+void emu_rtc_stats_get(emu_rtc_stats_t * p_stats);
+
+void emu_rtc_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_RTC_H__
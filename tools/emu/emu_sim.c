@@ -0,0 +1,45 @@
+#include <time.h>
+#include "emu_sim.h"
+#include "emu_app_timer.h"
+#include "emu_clock.h"
+#include "emu_log.h"
+#include "emu_rtc.h"
+#include "emu_twi.h"
+
+#define FNV_OFFSET  0xCBF29CE484222325ull
+#define FNV_PRIME   0x00000100000001B3ull
+
+static uint64_t m_digest = FNV_OFFSET;
+
+void emu_sim_reset(void)
+{
+    emu_clock_reset();
+    emu_rtc_reset();
+    emu_twi_stats_reset();
+    emu_log_reset();
+    (void)app_timer_init();
+    m_digest = FNV_OFFSET;
+}
+
+void emu_sim_digest_add(void const * p_data, size_t length)
+{
+    uint8_t const * p_byte = p_data;
+
+    while (length-- > 0)
+    {
+        m_digest = (m_digest ^ *p_byte++) * FNV_PRIME;
+    }
+}
+
+uint64_t emu_sim_digest_get(void)
+{
+    return m_digest;
+}
+
+double emu_sim_wall_s(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,34 @@
+#ifndef EMU_SIM_H__
+#define EMU_SIM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Helpers for long (soak) runs.
+ *  The emulator is a discrete-event simulation: the virtual clock jumps
+ *  straight to the next timer expiry, RTC compare or bus transfer, so idle
+ *  time costs nothing and weeks of operation run in seconds. Nothing in it
+ *  reads the host clock or seeds from it, so the same run gives the same
+ *  results bit for bit - the digest below makes that checkable. Wall time
+ *  is only read for the speed report.
+ */
+
+// Virtual clock, app_timer, RTC, bus statistics and log count back to zero.
+void emu_sim_reset(void);
+
+// FNV-1a (64 bit) over everything a run produces.
+void     emu_sim_digest_add(void const * p_data, size_t length);
+uint64_t emu_sim_digest_get(void);
+
+// Host monotonic time in seconds, for simulated time per wall time.
+double emu_sim_wall_s(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_SIM_H__
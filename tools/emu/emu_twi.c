@@ -0,0 +1,188 @@
+#include <string.h>
+#include "emu_twi.h"
+#include "emu_clock.h"
+#include "emu_rand.h"
+
+#define QUEUE_SIZE  32
+
+static emu_i2c_device_t * mp_devices;
+static uint32_t           m_frequency_hz = 100000;
+static emu_twi_stats_t    m_stats;
+static double             m_fault_probability;
+static emu_rand_t         m_fault_rand;
+
+static nrf_twi_mngr_transaction_t const * m_queue[QUEUE_SIZE];
+static uint32_t m_queue_head;
+static uint32_t m_queue_count;
+static bool     m_busy;
+
+static uint64_t clocks_to_us(uint64_t clocks)
+{
+    return (clocks * 1000000 + m_frequency_hz - 1) / m_frequency_hz;
+}
+
+static emu_i2c_device_t * device_find(uint8_t address)
+{
+    for (emu_i2c_device_t * p_device = mp_devices; p_device != NULL; p_device = p_device->p_next)
+    {
+        if (p_device->address == address)
+        {
+            return p_device;
+        }
+    }
+    return NULL;
+}
+
+static ret_code_t transfers_run(nrf_twi_mngr_transfer_t const * p_transfers,
+                                uint8_t number_of_transfers)
+{
+    for (uint8_t i = 0; i < number_of_transfers; i++)
+    {
+        nrf_twi_mngr_transfer_t const * p_transfer = &p_transfers[i];
+        emu_i2c_device_t * p_device = device_find(NRF_TWI_MNGR_OP_ADDRESS(p_transfer->operation));
+        bool ack;
+
+        m_stats.transfers++;
+
+        // The address byte is on the bus before the device answers.
+        if (p_device == NULL)
+        {
+            ack = false;
+        }
+        else if (m_fault_probability > 0.0 &&
+                 emu_rand_unit(&m_fault_rand) < m_fault_probability)
+        {
+            ack = false;
+            m_stats.faults++;
+        }
+        else if (NRF_TWI_MNGR_IS_READ_OP(p_transfer->operation))
+        {
+            ack = p_device->read(p_device, p_transfer->p_data, p_transfer->length);
+        }
+        else
+        {
+            ack = p_device->write(p_device, p_transfer->p_data, p_transfer->length);
+        }
+
+        uint64_t bytes  = 1 + (ack ? p_transfer->length : 0);
+        uint64_t clocks = 9 * bytes +
+                          ((!ack || !(p_transfer->flags & NRF_TWI_MNGR_NO_STOP)) ? 2 : 1);
+        uint64_t us     = clocks_to_us(clocks);
+
+        m_stats.bytes   += (uint32_t)bytes;
+        m_stats.busy_us += us;
+        emu_clock_advance_us(us);
+
+        if (!ack)
+        {
+            m_stats.nacks++;
+            return NRF_ERROR_INTERNAL;
+        }
+    }
+    return NRF_SUCCESS;
+}
+
+void emu_twi_attach(emu_i2c_device_t * p_device)
+{
+    p_device->p_next = mp_devices;
+    mp_devices       = p_device;
+}
+
+void emu_twi_frequency_set(uint32_t frequency_hz)
+{
+    m_frequency_hz = frequency_hz;
+}
+
+uint32_t emu_twi_bus_time_us(nrf_twi_mngr_transfer_t const * p_transfers,
+                             uint8_t number_of_transfers)
+{
+    uint64_t clocks = 0;
+
+    for (uint8_t i = 0; i < number_of_transfers; i++)
+    {
+        clocks += 9 * (1 + (uint64_t)p_transfers[i].length) +
+                  ((p_transfers[i].flags & NRF_TWI_MNGR_NO_STOP) ? 1 : 2);
+    }
+    return (uint32_t)clocks_to_us(clocks);
+}
+
+bool emu_twi_process(void)
+{
+    if (m_queue_count == 0)
+    {
+        return false;
+    }
+
+    nrf_twi_mngr_transaction_t const * p_transaction = m_queue[m_queue_head];
+
+    m_queue_head = (m_queue_head + 1) % QUEUE_SIZE;
+    m_queue_count--;
+
+    m_busy = true;
+    m_stats.transactions++;
+    ret_code_t result = transfers_run(p_transaction->p_transfers,
+                                      p_transaction->number_of_transfers);
+    m_busy = false;
+
+    if (p_transaction->callback != NULL)
+    {
+        p_transaction->callback(result, p_transaction->p_user_data);
+    }
+    return true;
+}
+
+void emu_twi_fault_set(double probability, uint64_t seed)
+{
+    m_fault_probability = probability;
+    emu_rand_seed(&m_fault_rand, seed);
+}
+
+void emu_twi_stats_get(emu_twi_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
+
+void emu_twi_stats_reset(void)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+ret_code_t nrf_twi_mngr_init(nrf_twi_mngr_t const *       p_nrf_twi_mngr,
+                             nrf_drv_twi_config_t const * p_default_twi_config)
+{
+    m_frequency_hz = p_default_twi_config->frequency;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_twi_mngr_schedule(nrf_twi_mngr_t const *             p_nrf_twi_mngr,
+                                 nrf_twi_mngr_transaction_t const * p_transaction)
+{
+    if (m_queue_count >= p_nrf_twi_mngr->queue_size || m_queue_count >= QUEUE_SIZE)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    m_queue[(m_queue_head + m_queue_count) % QUEUE_SIZE] = p_transaction;
+    m_queue_count++;
+    return NRF_SUCCESS;
+}
+
+ret_code_t nrf_twi_mngr_perform(nrf_twi_mngr_t const *          p_nrf_twi_mngr,
+                                nrf_drv_twi_config_t const *    p_config,
+                                nrf_twi_mngr_transfer_t const * p_transfers,
+                                uint8_t                         number_of_transfers,
+                                void                            (* user_function)(void))
+{
+    if (m_busy || m_queue_count != 0)
+    {
+        return NRF_ERROR_BUSY;
+    }
+
+    m_stats.transactions++;
+    return transfers_run(p_transfers, number_of_transfers);
+}
+
+bool nrf_twi_mngr_is_idle(nrf_twi_mngr_t const * p_nrf_twi_mngr)
+{
+    return !m_busy && m_queue_count == 0;
+}
@@ -0,0 +1,61 @@
+#ifndef EMU_TWI_H__
+#define EMU_TWI_H__
+
+#include "nrf_twi_mngr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Emulated TWI bus behind the nrf_twi_mngr stand-in.
+ *  Every transfer advances the virtual clock by its bus time (9 clocks per
+ *  byte plus START/STOP). A device that does not acknowledge its address
+ *  fails the transaction with NRF_ERROR_INTERNAL, like the SDK manager does
+ *  for any driver error, and the remaining transfers are skipped.
+ */
+typedef struct emu_i2c_device_s emu_i2c_device_t;
+
+struct emu_i2c_device_s
+{
+    uint8_t address;
+    // Return false to NACK the address.
+    bool (* write)(emu_i2c_device_t * p_device, uint8_t const * p_data, uint8_t length);
+    bool (* read)(emu_i2c_device_t * p_device, uint8_t * p_data, uint8_t length);
+    emu_i2c_device_t * p_next;
+};
+
+typedef struct
+{
+    uint32_t transactions;
+    uint32_t transfers;
+    uint32_t bytes;     // Address bytes included
+    uint32_t nacks;
+    uint32_t faults;    // Injected, included in nacks
+    uint64_t busy_us;
+} emu_twi_stats_t;
+
+void emu_twi_attach(emu_i2c_device_t * p_device);
+
+void emu_twi_frequency_set(uint32_t frequency_hz);
+
+// Runs the oldest scheduled transaction and calls its callback.
+// Returns false if the queue was empty.
+bool emu_twi_process(void);
+
+// Bus time of a transfer list in microseconds, assuming every address is
+// acknowledged.
+uint32_t emu_twi_bus_time_us(nrf_twi_mngr_transfer_t const * p_transfers,
+                             uint8_t number_of_transfers);
+
+// Bus faults - each transfer fails with the given probability as if the
+// address had not been acknowledged, without reaching the device.
+void emu_twi_fault_set(double probability, uint64_t seed);
+
+void emu_twi_stats_get(emu_twi_stats_t * p_stats);
+void emu_twi_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_TWI_H__
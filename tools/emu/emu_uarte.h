@@ -0,0 +1,33 @@
+#ifndef EMU_UARTE_H__
+#define EMU_UARTE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "nrfx_uarte.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** UARTE transmitter behind the nrfx_uarte stand-in.
+ *  A transfer is handed to the sink and completes at once (TX_DONE from
+ *  within nrfx_uarte_tx()), i.e. the line is infinitely fast and takes no
+ *  virtual time.
+ */
+typedef void (* emu_uarte_sink_t)(uint8_t const * p_data, size_t length);
+
+void emu_uarte_sink_set(emu_uarte_sink_t sink);
+
+typedef struct
+{
+    uint32_t transfers;
+    uint32_t bytes;
+} emu_uarte_stats_t;
+
+void emu_uarte_stats_get(emu_uarte_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMU_UARTE_H__
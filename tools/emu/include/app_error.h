@@ -0,0 +1,21 @@
+// Host stand-in for the nRF5 SDK header of the same name.
+#ifndef APP_ERROR_H__
+#define APP_ERROR_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sdk_errors.h"
+
+#define APP_ERROR_CHECK(err_code)                                           \
+    do                                                                      \
+    {                                                                       \
+        ret_code_t const local_err_code = (err_code);                       \
+        if (local_err_code != NRF_SUCCESS)                                  \
+        {                                                                   \
+            fprintf(stderr, "%s:%d: error %u\n", __FILE__, __LINE__,        \
+                    (unsigned)local_err_code);                              \
+            abort();                                                        \
+        }                                                                   \
+    } while (0)
+
+#endif // APP_ERROR_H__
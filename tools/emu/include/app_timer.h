@@ -0,0 +1,55 @@
+// Host stand-in for the nRF5 SDK app_timer, running on the virtual clock of
+// the emulator (see emu_app_timer.h). The RTC is modelled at
+// APP_TIMER_CONFIG_RTC_FREQUENCY = 1, i.e. 16384 Hz with a 24-bit counter.
+#ifndef APP_TIMER_H__
+#define APP_TIMER_H__
+
+#include "sdk_errors.h"
+
+#define APP_TIMER_CLOCK_FREQ        16384
+#define APP_TIMER_MAX_CNT_VAL       0x00FFFFFF
+#define APP_TIMER_MIN_TIMEOUT_TICKS 5
+
+#define APP_TIMER_TICKS(MS) \
+    ((uint32_t)(((uint64_t)(MS) * APP_TIMER_CLOCK_FREQ + 500) / 1000))
+
+typedef void (* app_timer_timeout_handler_t)(void * p_context);
+
+typedef enum
+{
+    APP_TIMER_MODE_SINGLE_SHOT,
+    APP_TIMER_MODE_REPEATED
+} app_timer_mode_t;
+
+typedef struct app_timer_s
+{
+    app_timer_timeout_handler_t handler;
+    app_timer_mode_t            mode;
+    void *                      p_context;
+    uint64_t                    expiry_ticks;  // Virtual RTC, not wrapped
+    uint32_t                    period_ticks;
+    bool                        active;
+    struct app_timer_s *        p_next;
+} app_timer_t;
+
+typedef app_timer_t * app_timer_id_t;
+
+#define APP_TIMER_DEF(timer_id)                                 \
+    static app_timer_t timer_id##_data;                         \
+    static app_timer_id_t const timer_id = &timer_id##_data
+
+ret_code_t app_timer_init(void);
+
+ret_code_t app_timer_create(app_timer_id_t const *      p_timer_id,
+                            app_timer_mode_t            mode,
+                            app_timer_timeout_handler_t timeout_handler);
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void * p_context);
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id);
+
+uint32_t app_timer_cnt_get(void);
+
+uint32_t app_timer_cnt_diff_compute(uint32_t ticks_to, uint32_t ticks_from);
+
+#endif // APP_TIMER_H__
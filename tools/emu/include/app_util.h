@@ -0,0 +1,20 @@
+// Host stand-in for the nRF5 SDK header of the same name - the few macros
+// the firmware modules use.
+#ifndef APP_UTIL_H__
+#define APP_UTIL_H__
+
+#include <stdint.h>
+
+#define STATIC_ASSERT(cond, msg)    _Static_assert(cond, msg)
+
+#define ROUNDED_DIV(A, B)   (((A) + ((B) / 2)) / (B))
+#define CEIL_DIV(A, B)      (((A) + (B) - 1) / (B))
+
+#ifndef MIN
+#define MIN(a, b)           ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b)           ((a) > (b) ? (a) : (b))
+#endif
+
+#endif // APP_UTIL_H__
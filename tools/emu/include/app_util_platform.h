@@ -0,0 +1,14 @@
+// Host stand-in for the nRF5 SDK header of the same name. The emulator is
+// single threaded, critical regions are empty.
+#ifndef APP_UTIL_PLATFORM_H__
+#define APP_UTIL_PLATFORM_H__
+
+#include "sdk_errors.h"
+
+#define APP_IRQ_PRIORITY_LOWEST     7
+#define APP_IRQ_PRIORITY_LOW        6
+
+#define CRITICAL_REGION_ENTER()     {
+#define CRITICAL_REGION_EXIT()      }
+
+#endif // APP_UTIL_PLATFORM_H__
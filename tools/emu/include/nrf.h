@@ -0,0 +1,28 @@
+// Host stand-in for the nRF5 SDK header of the same name - only what the
+// RTC stand-in and sample_queue.c need. The NVIC is not emulated,
+// interrupts are run by the emulator's event loops (emu_rtc.h). The
+// barrier is a full fence, so the firmware code also holds up between
+// host threads.
+#ifndef NRF_H__
+#define NRF_H__
+
+#include <stdint.h>
+
+typedef enum
+{
+    RTC2_IRQn = 36
+} IRQn_Type;
+
+static inline void NVIC_SetPriority(IRQn_Type irqn, uint32_t priority) { }
+static inline void NVIC_ClearPendingIRQ(IRQn_Type irqn) { }
+static inline void NVIC_EnableIRQ(IRQn_Type irqn) { }
+static inline void NVIC_DisableIRQ(IRQn_Type irqn) { }
+
+static inline void __DMB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void RTC2_IRQHandler(void);
+
+#endif // NRF_H__
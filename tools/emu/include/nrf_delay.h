@@ -0,0 +1,18 @@
+// Host stand-in for the nRF5 SDK header of the same name. Busy waiting
+// moves the virtual clock, nothing else runs in the meantime.
+#ifndef NRF_DELAY_H__
+#define NRF_DELAY_H__
+
+#include "emu_clock.h"
+
+static inline void nrf_delay_us(uint32_t us)
+{
+    emu_clock_advance_us(us);
+}
+
+static inline void nrf_delay_ms(uint32_t ms)
+{
+    emu_clock_advance_us((uint64_t)ms * 1000);
+}
+
+#endif // NRF_DELAY_H__
@@ -0,0 +1,16 @@
+// Host stand-in for the nRF5 SDK header of the same name. The clocks are
+// not emulated; requests are no-ops.
+#ifndef NRF_DRV_CLOCK_H__
+#define NRF_DRV_CLOCK_H__
+
+#include "sdk_errors.h"
+
+static inline ret_code_t nrf_drv_clock_init(void)
+{
+    return NRF_SUCCESS;
+}
+
+static inline void nrf_drv_clock_lfclk_request(void * p_handler_item) { }
+static inline void nrf_drv_clock_hfclk_request(void * p_handler_item) { }
+
+#endif // NRF_DRV_CLOCK_H__
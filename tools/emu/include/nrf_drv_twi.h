@@ -0,0 +1,24 @@
+// Host stand-in for the nRF5 SDK header of the same name.
+#ifndef NRF_DRV_TWI_H__
+#define NRF_DRV_TWI_H__
+
+#include "sdk_errors.h"
+
+typedef enum
+{
+    NRF_DRV_TWI_FREQ_100K = 100000,
+    NRF_DRV_TWI_FREQ_250K = 250000,
+    NRF_DRV_TWI_FREQ_400K = 400000
+} nrf_drv_twi_frequency_t;
+
+typedef struct
+{
+    uint32_t                scl;
+    uint32_t                sda;
+    nrf_drv_twi_frequency_t frequency;
+    uint8_t                 interrupt_priority;
+    bool                    clear_bus_init;
+    bool                    hold_bus_uninit;
+} nrf_drv_twi_config_t;
+
+#endif // NRF_DRV_TWI_H__
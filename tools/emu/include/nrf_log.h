@@ -0,0 +1,17 @@
+// Host stand-in for the nRF5 SDK header of the same name. Entries are
+// counted by emu_log.c, not formatted; the arguments are still evaluated.
+#ifndef NRF_LOG_H__
+#define NRF_LOG_H__
+
+#include "emu_log.h"
+
+#define NRF_LOG_ERROR(...)      emu_log_entry(__VA_ARGS__)
+#define NRF_LOG_WARNING(...)    emu_log_entry(__VA_ARGS__)
+#define NRF_LOG_INFO(...)       emu_log_entry(__VA_ARGS__)
+#define NRF_LOG_DEBUG(...)      emu_log_entry(__VA_ARGS__)
+#define NRF_LOG_RAW_INFO(...)   emu_log_entry(__VA_ARGS__)
+
+#define NRF_LOG_FLOAT_MARKER    "%s%d.%02d"
+#define NRF_LOG_FLOAT(val)      "", (int)(val), 0
+
+#endif // NRF_LOG_H__
@@ -0,0 +1,53 @@
+// Host stand-in for the nRF5 SDK HAL header of the same name. The counter
+// is derived from the virtual clock (32768 Hz / (PRESCALER + 1)), compare
+// events are raised by emu_rtc_run_until().
+#ifndef NRF_RTC_H__
+#define NRF_RTC_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nrf.h"
+
+typedef struct
+{
+    uint32_t prescaler;
+    bool     running;
+    uint64_t start_us;      // Virtual time the counter was last at base
+    uint64_t base;          // Unwrapped counter value at start_us
+    uint32_t cc[4];
+    uint32_t intenset;
+    bool     event_compare[4];
+} NRF_RTC_Type;
+
+extern NRF_RTC_Type emu_rtc2;
+#define NRF_RTC2 (&emu_rtc2)
+
+typedef enum
+{
+    NRF_RTC_TASK_START,
+    NRF_RTC_TASK_STOP,
+    NRF_RTC_TASK_CLEAR
+} nrf_rtc_task_t;
+
+typedef enum
+{
+    NRF_RTC_EVENT_COMPARE_0,
+    NRF_RTC_EVENT_COMPARE_1,
+    NRF_RTC_EVENT_COMPARE_2,
+    NRF_RTC_EVENT_COMPARE_3
+} nrf_rtc_event_t;
+
+#define NRF_RTC_INT_COMPARE0_MASK   (1u << 16)
+
+#define RTC_COUNTER_COUNTER_Msk     0x00FFFFFFu
+
+void     nrf_rtc_prescaler_set(NRF_RTC_Type * p_reg, uint32_t val);
+void     nrf_rtc_task_trigger(NRF_RTC_Type * p_reg, nrf_rtc_task_t task);
+void     nrf_rtc_cc_set(NRF_RTC_Type * p_reg, uint32_t ch, uint32_t cc_val);
+uint32_t nrf_rtc_counter_get(NRF_RTC_Type const * p_reg);
+void     nrf_rtc_event_clear(NRF_RTC_Type * p_reg, nrf_rtc_event_t event);
+bool     nrf_rtc_event_pending(NRF_RTC_Type const * p_reg, nrf_rtc_event_t event);
+void     nrf_rtc_int_enable(NRF_RTC_Type * p_reg, uint32_t mask);
+void     nrf_rtc_int_disable(NRF_RTC_Type * p_reg, uint32_t mask);
+
+#endif // NRF_RTC_H__
@@ -0,0 +1,89 @@
+// Host stand-in for the nRF5 SDK header of the same name, with the list
+// operations of nrf_sortlist.c inline. An item goes behind every item the
+// compare function puts before it, so equal items keep their order.
+#ifndef NRF_SORTLIST_H__
+#define NRF_SORTLIST_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct nrf_sortlist_item_s nrf_sortlist_item_t;
+
+struct nrf_sortlist_item_s
+{
+    nrf_sortlist_item_t * p_next;
+};
+
+// True if p_item0 is to be placed before p_item1.
+typedef bool (* nrf_sortlist_compare_func_t)(nrf_sortlist_item_t * p_item0,
+                                             nrf_sortlist_item_t * p_item1);
+
+typedef struct
+{
+    nrf_sortlist_item_t * p_head;
+} nrf_sortlist_cb_t;
+
+typedef struct
+{
+    nrf_sortlist_cb_t *         p_cb;
+    nrf_sortlist_compare_func_t compare_func;
+} nrf_sortlist_t;
+
+#define NRF_SORTLIST_DEF(_name, _compare_func)          \
+    static nrf_sortlist_cb_t _name##_sortlist_cb;       \
+    static nrf_sortlist_t const _name =                 \
+    {                                                   \
+        .p_cb         = &_name##_sortlist_cb,           \
+        .compare_func = _compare_func                   \
+    }
+
+static inline void nrf_sortlist_add(nrf_sortlist_t const * p_list, nrf_sortlist_item_t * p_item)
+{
+    nrf_sortlist_item_t ** pp_curr = &p_list->p_cb->p_head;
+
+    while (*pp_curr != NULL && p_list->compare_func(*pp_curr, p_item))
+    {
+        pp_curr = &(*pp_curr)->p_next;
+    }
+    p_item->p_next = *pp_curr;
+    *pp_curr       = p_item;
+}
+
+static inline nrf_sortlist_item_t * nrf_sortlist_pop(nrf_sortlist_t const * p_list)
+{
+    nrf_sortlist_item_t * p_item = p_list->p_cb->p_head;
+
+    if (p_item != NULL)
+    {
+        p_list->p_cb->p_head = p_item->p_next;
+    }
+    return p_item;
+}
+
+static inline nrf_sortlist_item_t const * nrf_sortlist_peek(nrf_sortlist_t const * p_list)
+{
+    return p_list->p_cb->p_head;
+}
+
+static inline nrf_sortlist_item_t const * nrf_sortlist_next(nrf_sortlist_item_t const * p_item)
+{
+    return p_item->p_next;
+}
+
+static inline bool nrf_sortlist_remove(nrf_sortlist_t const * p_list, nrf_sortlist_item_t * p_item)
+{
+    nrf_sortlist_item_t ** pp_curr = &p_list->p_cb->p_head;
+
+    while (*pp_curr != NULL)
+    {
+        if (*pp_curr == p_item)
+        {
+            *pp_curr = p_item->p_next;
+            return true;
+        }
+        pp_curr = &(*pp_curr)->p_next;
+    }
+    return false;
+}
+
+#endif // NRF_SORTLIST_H__
@@ -0,0 +1,7 @@
+// Host stand-in for the nRF5 SDK HAL header of the same name. Empty - the
+// emulator builds timestamp.c with TIMESTAMP_USE_TIMER 0 (app_timer
+// counter).
+#ifndef NRF_TIMER_H__
+#define NRF_TIMER_H__
+
+#endif // NRF_TIMER_H__
@@ -0,0 +1,75 @@
+// Host stand-in for the nRF5 SDK TWI transaction manager, backed by the
+// emulated bus in emu_twi.c. Transfers keep the SDK layout so that the
+// sensor drivers and their transfer macros compile unchanged.
+#ifndef NRF_TWI_MNGR_H__
+#define NRF_TWI_MNGR_H__
+
+#include "sdk_errors.h"
+#include "app_util_platform.h"
+#include "nrf_drv_twi.h"
+
+#define NRF_TWI_MNGR_BUFFER_LOC_IND
+
+#define NRF_TWI_MNGR_NO_STOP            0x01
+
+#define NRF_TWI_MNGR_WRITE_OP(address)  (((address) << 1) | 0)
+#define NRF_TWI_MNGR_READ_OP(address)   (((address) << 1) | 1)
+#define NRF_TWI_MNGR_IS_READ_OP(op)     ((op) & 1)
+#define NRF_TWI_MNGR_OP_ADDRESS(op)     ((op) >> 1)
+
+typedef void (* nrf_twi_mngr_callback_t)(ret_code_t result, void * p_user_data);
+
+typedef struct
+{
+    uint8_t * p_data;
+    uint8_t   length;
+    uint8_t   operation;
+    uint8_t   flags;
+} nrf_twi_mngr_transfer_t;
+
+typedef struct
+{
+    nrf_twi_mngr_callback_t         callback;
+    void *                          p_user_data;
+    nrf_twi_mngr_transfer_t const * p_transfers;
+    uint8_t                         number_of_transfers;
+    nrf_drv_twi_config_t const *    p_required_twi_cfg;
+} nrf_twi_mngr_transaction_t;
+
+typedef struct
+{
+    uint8_t queue_size;
+} nrf_twi_mngr_t;
+
+#define NRF_TWI_MNGR_TRANSFER(_operation, _p_data, _length, _flags) \
+{                                                                   \
+    .p_data    = (uint8_t *)(_p_data),                              \
+    .length    = _length,                                           \
+    .operation = _operation,                                        \
+    .flags     = _flags                                             \
+}
+
+#define NRF_TWI_MNGR_WRITE(address, p_data, length, flags) \
+    NRF_TWI_MNGR_TRANSFER(NRF_TWI_MNGR_WRITE_OP(address), p_data, length, flags)
+
+#define NRF_TWI_MNGR_READ(address, p_data, length, flags) \
+    NRF_TWI_MNGR_TRANSFER(NRF_TWI_MNGR_READ_OP(address), p_data, length, flags)
+
+#define NRF_TWI_MNGR_DEF(_nrf_twi_mngr_name, _queue_size, _twi_idx) \
+    static nrf_twi_mngr_t const _nrf_twi_mngr_name = { .queue_size = _queue_size }
+
+ret_code_t nrf_twi_mngr_init(nrf_twi_mngr_t const *       p_nrf_twi_mngr,
+                             nrf_drv_twi_config_t const * p_default_twi_config);
+
+ret_code_t nrf_twi_mngr_schedule(nrf_twi_mngr_t const *             p_nrf_twi_mngr,
+                                 nrf_twi_mngr_transaction_t const * p_transaction);
+
+ret_code_t nrf_twi_mngr_perform(nrf_twi_mngr_t const *          p_nrf_twi_mngr,
+                                nrf_drv_twi_config_t const *    p_config,
+                                nrf_twi_mngr_transfer_t const * p_transfers,
+                                uint8_t                         number_of_transfers,
+                                void                            (* user_function)(void));
+
+bool nrf_twi_mngr_is_idle(nrf_twi_mngr_t const * p_nrf_twi_mngr);
+
+#endif // NRF_TWI_MNGR_H__
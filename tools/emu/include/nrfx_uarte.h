@@ -0,0 +1,56 @@
+// Host stand-in for the nrfx driver header of the same name - TX only, see
+// emu_uarte.h.
+#ifndef NRFX_UARTE_H__
+#define NRFX_UARTE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+typedef struct
+{
+    uint8_t drv_inst_idx;
+} nrfx_uarte_t;
+
+#define NRFX_UARTE_INSTANCE(id)     { .drv_inst_idx = (id) }
+
+#define NRF_UARTE_PSEL_DISCONNECTED 0xFFFFFFFF
+
+typedef struct
+{
+    uint32_t pseltxd;
+    uint32_t pselrxd;
+    void *   p_context;
+} nrfx_uarte_config_t;
+
+#define NRFX_UARTE_DEFAULT_CONFIG                   \
+{                                                   \
+    .pseltxd   = NRF_UARTE_PSEL_DISCONNECTED,       \
+    .pselrxd   = NRF_UARTE_PSEL_DISCONNECTED,       \
+    .p_context = NULL                               \
+}
+
+typedef enum
+{
+    NRFX_UARTE_EVT_TX_DONE,
+    NRFX_UARTE_EVT_RX_DONE,
+    NRFX_UARTE_EVT_ERROR
+} nrfx_uarte_evt_type_t;
+
+typedef struct
+{
+    nrfx_uarte_evt_type_t type;
+} nrfx_uarte_event_t;
+
+typedef void (* nrfx_uarte_event_handler_t)(nrfx_uarte_event_t const * p_event,
+                                            void *                     p_context);
+
+ret_code_t nrfx_uarte_init(nrfx_uarte_t const *        p_instance,
+                           nrfx_uarte_config_t const * p_config,
+                           nrfx_uarte_event_handler_t  event_handler);
+
+ret_code_t nrfx_uarte_tx(nrfx_uarte_t const * p_instance,
+                         uint8_t const *      p_data,
+                         size_t               length);
+
+#endif // NRFX_UARTE_H__
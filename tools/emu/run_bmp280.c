@@ -0,0 +1,116 @@
+/** Emulator run - BMP280 and HDC1080 on one TWI manager.
+ *
+ *    cc -I. -Itools/emu -Itools/emu/include tools/emu/emu_*.c \
+ *       tools/emu/run_bmp280.c bmp280.c hdc1080.c -lm -o /tmp/run_bmp280 \
+ *        && /tmp/run_bmp280
+ *
+ *  Uses the transfers and macros of bmp280.h/hdc1080.h as they are built
+ *  for the target: ID and calibration read, forced and normal mode with the
+ *  6-byte burst read from 0xF7, interleaved with HDC1080 conversions.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "app_error.h"
+#include "emu_clock.h"
+#include "emu_twi.h"
+#include "emu_hdc1080.h"
+#include "emu_bmp280.h"
+#include "bmp280.h"
+#include "hdc1080.h"
+
+NRF_TWI_MNGR_DEF(m_nrf_twi_mngr, 8, 0);
+
+static uint8_t m_bmp280_id;
+static uint8_t m_bmp280_calib[BMP280_CALIB_SIZE];
+static uint8_t m_bmp280_data[BMP280_DATA_SIZE];
+static uint8_t m_bmp280_status;
+static uint8_t m_hdc1080_data[4];
+
+static nrf_twi_mngr_transfer_t const m_bmp280_probe[] =
+{
+    BMP280_READ_ID(&m_bmp280_id),
+    BMP280_READ_CALIB(m_bmp280_calib)
+};
+
+static nrf_twi_mngr_transfer_t const m_bmp280_read[] =
+{
+    BMP280_READ_PRESS_TEMP(m_bmp280_data)
+};
+
+static nrf_twi_mngr_transfer_t const m_bmp280_status_read[] =
+{
+    BMP280_READ_STATUS(&m_bmp280_status)
+};
+
+static nrf_twi_mngr_transfer_t const m_hdc1080_trigger[] =
+{
+    HDC1080_WRITE_T_AND_HR(&hdc1080_temp_reg_addr)
+};
+
+static nrf_twi_mngr_transfer_t const m_hdc1080_read[] =
+{
+    HDC1080_READ_T_AND_HR(m_hdc1080_data)
+};
+
+#define COUNT(a) ((uint8_t)(sizeof(a) / sizeof((a)[0])))
+
+static ret_code_t perform(nrf_twi_mngr_transfer_t const * p_transfers, uint8_t count)
+{
+    return nrf_twi_mngr_perform(&m_nrf_twi_mngr, NULL, p_transfers, count, NULL);
+}
+
+static void print_bmp280(char const * p_label)
+{
+    printf("  %-28s t=%8.3f ms  adc_P=%6d adc_T=%6d\n", p_label,
+           emu_clock_now_us() / 1000.0,
+           BMP280_GET_ADC_P(m_bmp280_data), BMP280_GET_ADC_T(m_bmp280_data));
+}
+
+int main(void)
+{
+    emu_twi_stats_t stats;
+    uint8_t         calib[BMP280_CALIB_SIZE];
+
+    emu_twi_attach(emu_hdc1080_init());
+    emu_twi_attach(emu_bmp280_init());
+
+    // Start-up: chip ID and calibration block, read once.
+    APP_ERROR_CHECK(perform(m_bmp280_probe, COUNT(m_bmp280_probe)));
+    emu_bmp280_calib_get(calib);
+    printf("BMP280 id 0x%02x, calibration %s\n", m_bmp280_id,
+           memcmp(calib, m_bmp280_calib, sizeof(calib)) == 0 ? "ok" : "MISMATCH");
+
+    // Forced mode: trigger, status while measuring, burst read when done.
+    printf("forced mode (measurement %u us):\n", (unsigned)BMP280_DEFAULT_MEAS_TIME_US);
+    APP_ERROR_CHECK(perform(bmp280_forced_transfers, BMP280_FORCED_TRANSFER_COUNT));
+    APP_ERROR_CHECK(perform(m_bmp280_status_read, COUNT(m_bmp280_status_read)));
+    printf("  status right after trigger   0x%02x\n", m_bmp280_status);
+
+    // HDC1080 conversion overlapping the BMP280 measurement.
+    APP_ERROR_CHECK(perform(m_hdc1080_trigger, COUNT(m_hdc1080_trigger)));
+    emu_clock_advance_us(BMP280_DEFAULT_MEAS_TIME_US);
+    APP_ERROR_CHECK(perform(m_bmp280_read, COUNT(m_bmp280_read)));
+    print_bmp280("burst read");
+    printf("  mode after measurement       %u (sleep)\n", emu_bmp280_mode_get());
+
+    emu_clock_advance_us(emu_hdc1080_conversion_us());
+    APP_ERROR_CHECK(perform(m_hdc1080_read, COUNT(m_hdc1080_read)));
+    printf("  HDC1080 T/RH                 %02x%02x %02x%02x\n",
+           m_hdc1080_data[0], m_hdc1080_data[1], m_hdc1080_data[2], m_hdc1080_data[3]);
+
+    // Normal mode: continuous measurements every t_sb, just read.
+    emu_twi_stats_reset();
+    APP_ERROR_CHECK(perform(bmp280_init_transfers, BMP280_INIT_TRANSFER_COUNT));
+    printf("normal mode:\n");
+    for (int i = 0; i < 3; i++)
+    {
+        emu_clock_advance_us(500000);
+        APP_ERROR_CHECK(perform(m_bmp280_read, COUNT(m_bmp280_read)));
+        print_bmp280("burst read");
+    }
+
+    emu_twi_stats_get(&stats);
+    printf("bus: %u transactions, %u bytes, %llu us busy\n",
+           stats.transactions, stats.bytes, (unsigned long long)stats.busy_us);
+    return 0;
+}
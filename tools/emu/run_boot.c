@@ -0,0 +1,221 @@
+/** Emulator run - time from main() to the first valid sample, blocking boot
+ *  against the fast boot of main.c (FAST_BOOT_ENABLED).
+ *
+ *    cc -I. -Itools/emu -Itools/emu/include tools/emu/emu_*.c \
+ *       tools/emu/run_boot.c sampler.c hdc1080.c hdc1080_heater.c bmp280.c \
+ *       task_timer.c timestamp.c -lm -o /tmp/run_boot && /tmp/run_boot
+ *
+ *  main() is entered at time 0. "cold" powers the HDC1080 up at that moment
+ *  (power-on, brown-out) so it NACKs for HDC1080_STARTUP_MS, "warm" has it
+ *  running already (pin reset, watchdog). app_timer only counts once the
+ *  LFCLK has started - after LFXO_START_US with the crystal of sdk_config.h,
+ *  LFRC_START_US with the RC oscillator.
+ *    blocking   trigger, nrf_delay_ms(20), read (read_t_and_hr(), the
+ *               result is only logged), then the timer; the first sample
+ *               comes from the first tick
+ *    fast       sampler_boot_start() of sampler.c - config write repeated
+ *               until ACKed, trigger, read repeated until ACKed, each
+ *               NACKed attempt FAST_BOOT_RETRY_US after the last one (the
+ *               BOOT_TIMER compare of main.c); the timer is started right
+ *               away
+ *  The ticks sample with sampler.c as configured in sampling_config.h.
+ */
+#include <stdio.h>
+#include "app_error.h"
+#include "app_timer.h"
+#include "nrf_delay.h"
+#include "emu_app_timer.h"
+#include "emu_clock.h"
+#include "emu_hdc1080.h"
+#include "emu_twi.h"
+#include "hdc1080.h"
+#include "sampler.h"
+#include "sampling_config.h"
+#include "timestamp.h"
+
+#define LFXO_START_US           250000  // nRF52840 typical
+#define LFRC_START_US           600
+
+#define US_TO_TICKS(US) ((uint32_t)(((uint64_t)(US) * APP_TIMER_CLOCK_FREQ + 500000) / 1000000))
+
+NRF_TWI_MNGR_DEF(m_nrf_twi_mngr, 8, 0);
+APP_TIMER_DEF(m_timer);
+// [stands in for the BOOT_TIMER compare - the emulated app_timer counts
+//  before the LFCLK has started]
+APP_TIMER_DEF(m_retry_timer);
+
+// read_t_and_hr() of main.c, for the blocking boot.
+static uint8_t m_data[4];
+
+static nrf_twi_mngr_transfer_t const m_trigger[] =
+{
+    HDC1080_WRITE_T_AND_HR(&hdc1080_temp_reg_addr)
+};
+
+static nrf_twi_mngr_transfer_t const m_read[] =
+{
+    HDC1080_READ_T_AND_HR(m_data)
+};
+
+#define COUNT(a) ((uint8_t)(sizeof(a) / sizeof((a)[0])))
+
+static uint64_t m_main_us;      // Time of main(), the rest is relative to it
+static uint64_t m_boot_start_us;
+static uint64_t m_lfclk_us;
+static uint64_t m_config_us;
+static uint64_t m_first_us;     // First valid sample, 0 until then
+static uint64_t m_tick_us;      // First sample from the timer
+static bool     m_blocking_failed;
+
+static void record_handler(sample_record_t const * p_record)
+{
+    uint64_t now = emu_clock_now_us() - m_main_us;
+
+    if (p_record->flags & SAMPLE_FLAG_ERROR)
+    {
+        return;
+    }
+    if (m_first_us == 0)
+    {
+        m_first_us = now;
+    }
+    // [the boot record is the one without timestamps]
+    if (!(p_record->flags & SAMPLE_FLAG_NO_TIME) && m_tick_us == 0)
+    {
+        m_tick_us = now;
+    }
+}
+
+static void retry_timer_handler(void * p_context)
+{
+    sampler_boot_retry();
+}
+
+static void boot_handler(sampler_boot_evt_t event, ret_code_t result)
+{
+    if (event == SAMPLER_BOOT_NACKED)
+    {
+        // boot_retry_schedule() of main.c
+        if (emu_clock_now_us() - m_boot_start_us >= FAST_BOOT_TIMEOUT_US)
+        {
+            sampler_boot_give_up();
+            return;
+        }
+        APP_ERROR_CHECK(app_timer_start(m_retry_timer, US_TO_TICKS(FAST_BOOT_RETRY_US), NULL));
+        return;
+    }
+
+    APP_ERROR_CHECK(result);
+    if (event == SAMPLER_BOOT_CONFIGURED)
+    {
+        m_config_us = emu_clock_now_us() - m_main_us;
+    }
+}
+
+static void timer_handler(void * p_context)
+{
+    sampler_tick();
+}
+
+static sampler_config_t const m_sampler_config =
+{
+    .p_twi               = &m_nrf_twi_mngr,
+    .record_handler      = record_handler,
+    .read_delay_ticks    = APP_TIMER_TICKS(READ_DELAY_MS),
+#if READY_POLLING_ENABLED
+    .poll_interval_ticks = APP_TIMER_TICKS(READY_POLL_INTERVAL_MS),
+    .poll_max            = READY_POLL_MAX,
+#endif
+};
+
+static void run(char const * p_label, bool fast, bool cold, uint32_t lfclk_us)
+{
+    emu_twi_stats_t twi;
+
+    emu_hdc1080_power_set(false);
+    emu_clock_reset();
+    APP_ERROR_CHECK(app_timer_init());
+    APP_ERROR_CHECK(timestamp_init());
+    APP_ERROR_CHECK(sampler_init(&m_sampler_config));
+    APP_ERROR_CHECK(app_timer_create(&m_timer, APP_TIMER_MODE_REPEATED, timer_handler));
+    APP_ERROR_CHECK(app_timer_create(&m_retry_timer, APP_TIMER_MODE_SINGLE_SHOT,
+                                     retry_timer_handler));
+    emu_hdc1080_power_set(true);
+    if (!cold)
+    {
+        // Running long before the reset.
+        emu_clock_advance_us(2 * HDC1080_STARTUP_MS * 1000);
+    }
+    emu_twi_stats_reset();
+    hdc1080_config_shadow_reset();
+
+    m_main_us         = emu_clock_now_us();
+    m_lfclk_us        = m_main_us + lfclk_us;
+    m_config_us       = 0;
+    m_first_us        = 0;
+    m_tick_us         = 0;
+    m_blocking_failed = false;
+
+    if (fast)
+    {
+        m_boot_start_us = emu_clock_now_us();
+        sampler_boot_start(boot_handler);
+    }
+    else
+    {
+        // read_t_and_hr() - APP_ERROR_CHECK() resets the chip on a NACK.
+        if (nrf_twi_mngr_perform(&m_nrf_twi_mngr, NULL, m_trigger, COUNT(m_trigger),
+                                 NULL) != NRF_SUCCESS)
+        {
+            m_blocking_failed = true;
+        }
+        nrf_delay_ms(20);
+        if (nrf_twi_mngr_perform(&m_nrf_twi_mngr, NULL, m_read, COUNT(m_read),
+                                 NULL) != NRF_SUCCESS)
+        {
+            m_blocking_failed = true;
+        }
+    }
+
+    // The RTC starts counting with the LFCLK - read_init() ahead of that
+    // comes down to starting the timer then.
+    emu_app_timer_run_until(m_lfclk_us > emu_clock_now_us() ? m_lfclk_us : emu_clock_now_us());
+    APP_ERROR_CHECK(app_timer_start(m_timer, APP_TIMER_TICKS(SAMPLING_PERIOD_MS), NULL));
+    emu_app_timer_run_until(m_lfclk_us + 2 * SAMPLING_PERIOD_MS * 1000);
+    APP_ERROR_CHECK(app_timer_stop(m_timer));
+    emu_twi_stats_get(&twi);
+
+    if (m_blocking_failed)
+    {
+        printf("  %-20s  read_t_and_hr() NACKed - APP_ERROR_CHECK() resets\n", p_label);
+        return;
+    }
+    if (fast)
+    {
+        printf("  %-20s %9.1f", p_label, m_config_us / 1000.0);
+    }
+    else
+    {
+        printf("  %-20s %9s", p_label, "-"); // Never written
+    }
+    printf(" %9.1f %9.1f %7u %8.2f\n", m_first_us / 1000.0, m_tick_us / 1000.0,
+           twi.nacks, twi.busy_us / 1000.0);
+}
+
+int main(void)
+{
+    static nrf_drv_twi_config_t const config = { .frequency = NRF_DRV_TWI_FREQ_100K };
+
+    APP_ERROR_CHECK(nrf_twi_mngr_init(&m_nrf_twi_mngr, &config));
+    emu_twi_attach(emu_hdc1080_init());
+
+    printf("ms since main(), %d ms period\n", SAMPLING_PERIOD_MS);
+    printf("  %-20s %9s %9s %9s %7s %8s\n", "", "config", "1st valid", "1st tick",
+           "NACKs", "bus ms");
+    run("blocking warm LFXO", false, false, LFXO_START_US);
+    run("blocking cold LFXO", false, true,  LFXO_START_US);
+    run("fast warm LFXO",     true,  false, LFXO_START_US);
+    run("fast cold LFXO",     true,  true,  LFXO_START_US);
+    run("fast cold LFRC",     true,  true,  LFRC_START_US);
+    return 0;
+}
@@ -0,0 +1,250 @@
+/** Emulator run - averaging variants side by side on the synthetic
+ *  environments of emu_env.c.
+ *
+ *    cc -O2 -I. -Itools/emu -Itools/emu/include tools/emu/emu_*.c \
+ *       tools/emu/run_env.c sampler.c sample_proc.c hdc1080.c \
+ *       hdc1080_heater.c bmp280.c task_timer.c timestamp.c median_filter.c \
+ *       ema_filter.c psychro.c -lm \
+ *       -o /tmp/run_env && /tmp/run_env [-d days] [-t trace] [scenario ...]
+ *
+ *  The firmware acquisition (sampler.c, sampling_config.h) runs against
+ *  each scenario, noise and bus faults included. Every sample goes through
+ *  all variants of the processing (sample_proc.c), and their output is
+ *  compared with the environment the conversion saw:
+ *    raw       the code as read
+ *    mean16    SAMPLE_PROC_WINDOW moving mean (AVERAGING_USE_EMA 0)
+ *    med+mean  median filter ahead of the moving mean (main.c default)
+ *    ema       ema_filter.c (AVERAGING_USE_EMA 1)
+ *  The mean starts from an empty window, so the errors are taken from
+ *  sample SAMPLE_PROC_WINDOW on. The digest of the codes read shows that a
+ *  scenario is reproducible.
+ *  With -t the codes of the (single) scenario are written as a trace for
+ *  run_replay.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "app_error.h"
+#include "app_timer.h"
+#include "emu_app_timer.h"
+#include "emu_clock.h"
+#include "emu_env.h"
+#include "emu_hdc1080.h"
+#include "emu_sim.h"
+#include "emu_twi.h"
+#include "hdc1080.h"
+#include "sample_proc.h"
+#include "sampler.h"
+#include "sampling_config.h"
+#include "timestamp.h"
+
+#define DEFAULT_DAYS            7
+
+NRF_TWI_MNGR_DEF(m_nrf_twi_mngr, 8, 0);
+APP_TIMER_DEF(m_timer);
+typedef enum
+{
+    VARIANT_RAW,
+    VARIANT_MEAN,
+    VARIANT_MEDIAN_MEAN,
+    VARIANT_EMA,
+    VARIANT_COUNT
+} variant_t;
+
+static char const * const m_variant_names[VARIANT_COUNT] =
+{
+    "raw", "mean16", "med+mean", "ema"
+};
+
+typedef struct
+{
+    double sq_sum;
+    double max;
+} error_t;
+
+// Processing variants, VARIANT_RAW excluded.
+static sample_proc_config_t const m_variant_configs[VARIANT_COUNT] =
+{
+    [VARIANT_MEAN]        = { .median = false, .ema = false, .heater_rh = HEATER_RH_THRESHOLD },
+    [VARIANT_MEDIAN_MEAN] = { .median = true,  .ema = false, .heater_rh = HEATER_RH_THRESHOLD },
+    [VARIANT_EMA]         = { .median = false, .ema = true,  .heater_rh = HEATER_RH_THRESHOLD }
+};
+
+static sample_proc_t      m_proc[VARIANT_COUNT];
+static sample_proc_ring_t m_proc_ring[VARIANT_COUNT];
+static error_t            m_error[VARIANT_COUNT][2];
+static double             m_true[2];        // Environment at the trigger
+static uint32_t           m_ticks;
+static uint32_t           m_samples;
+static FILE *             mp_trace;
+
+static void error_add(variant_t variant, int channel, double value)
+{
+    double e = fabs(value - m_true[channel]);
+
+    m_error[variant][channel].sq_sum += e * e;
+    m_error[variant][channel].max     = fmax(m_error[variant][channel].max, e);
+}
+
+static void record_handler(sample_record_t const * p_record)
+{
+    if (p_record->flags & SAMPLE_FLAG_ERROR)
+    {
+        return;
+    }
+
+    emu_sim_digest_add(&p_record->temp_raw, sizeof(p_record->temp_raw));
+    emu_sim_digest_add(&p_record->hum_raw, sizeof(p_record->hum_raw));
+    if (mp_trace != NULL)
+    {
+        fprintf(mp_trace, "%04x%04x\n", p_record->temp_raw, p_record->hum_raw);
+    }
+
+    bool warm = (++m_samples >= SAMPLE_PROC_WINDOW);
+
+    if (warm)
+    {
+        error_add(VARIANT_RAW, 0, HDC1080_TEMP_FROM_RAW(p_record->temp_raw));
+        error_add(VARIANT_RAW, 1, HDC1080_HUM_FROM_RAW(p_record->hum_raw));
+    }
+    for (int v = VARIANT_RAW + 1; v < VARIANT_COUNT; v++)
+    {
+        sample_proc_result_t result;
+
+        if (sample_proc_update(&m_proc[v], p_record, &result) && warm)
+        {
+            error_add(v, 0, result.temp);
+            error_add(v, 1, result.hum);
+        }
+    }
+}
+
+static void timer_handler(void * p_context)
+{
+    m_ticks++;
+    emu_env_update();
+    emu_env_get(&m_true[0], &m_true[1]);
+    sampler_tick();
+}
+
+static sampler_config_t const m_sampler_config =
+{
+    .p_twi               = &m_nrf_twi_mngr,
+    .record_handler      = record_handler,
+    .read_delay_ticks    = APP_TIMER_TICKS(READ_DELAY_MS),
+#if READY_POLLING_ENABLED
+    .poll_interval_ticks = APP_TIMER_TICKS(READY_POLL_INTERVAL_MS),
+    .poll_max            = READY_POLL_MAX,
+#endif
+};
+
+static void run(emu_env_config_t const * p_config, uint32_t days)
+{
+    emu_env_stats_t env;
+    emu_twi_stats_t twi;
+
+    emu_sim_reset();
+    emu_twi_attach(emu_hdc1080_init());
+    memset(m_error, 0, sizeof(m_error));
+    m_ticks   = 0;
+    m_samples = 0;
+    for (int v = VARIANT_RAW + 1; v < VARIANT_COUNT; v++)
+    {
+        sample_proc_init(&m_proc[v], &m_variant_configs[v], &m_proc_ring[v]);
+    }
+
+    emu_env_init(p_config);
+    APP_ERROR_CHECK(timestamp_init());
+    APP_ERROR_CHECK(sampler_init(&m_sampler_config));
+    APP_ERROR_CHECK(app_timer_create(&m_timer, APP_TIMER_MODE_REPEATED, timer_handler));
+    APP_ERROR_CHECK(app_timer_start(m_timer, APP_TIMER_TICKS(SAMPLING_PERIOD_MS), NULL));
+
+    emu_app_timer_run_until((uint64_t)days * 86400 * 1000000);
+
+    // The sample of the last tick completes, nothing further is started.
+    APP_ERROR_CHECK(app_timer_stop(m_timer));
+    emu_app_timer_run_until(emu_clock_now_us() + SAMPLING_PERIOD_MS * 1000u);
+
+    emu_env_stats_get(&env);
+    emu_twi_stats_get(&twi);
+    printf("%s, %u days: %u samples, %u lost, %u bus faults, %u HVAC switches, "
+           "%u spikes, digest %016llx\n",
+           p_config->p_name, days, m_samples, m_ticks - m_samples, twi.faults, env.hvac_switches,
+           env.spikes, (unsigned long long)emu_sim_digest_get());
+    printf("  %-9s %11s %11s %12s %12s\n", "", "T rms C", "T max C", "RH rms %", "RH max %");
+    for (int v = 0; v < VARIANT_COUNT; v++)
+    {
+        uint32_t n = m_samples - (SAMPLE_PROC_WINDOW - 1);
+
+        printf("  %-9s %11.4f %11.4f %12.4f %12.4f\n", m_variant_names[v],
+               sqrt(m_error[v][0].sq_sum / n), m_error[v][0].max,
+               sqrt(m_error[v][1].sq_sum / n), m_error[v][1].max);
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    static nrf_drv_twi_config_t const config = { .frequency = NRF_DRV_TWI_FREQ_100K };
+    uint32_t     days         = DEFAULT_DAYS;
+    char const * p_trace_path = NULL;
+    int          opt;
+
+    while ((opt = getopt(argc, argv, "d:t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'd': days = (uint32_t)atoi(optarg); break;
+        case 't': p_trace_path = optarg;         break;
+        default:
+            fprintf(stderr, "usage: %s [-d days] [-t trace] [scenario ...]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (p_trace_path != NULL && argc - optind != 1)
+    {
+        fprintf(stderr, "-t needs exactly one scenario\n");
+        return 2;
+    }
+
+    APP_ERROR_CHECK(nrf_twi_mngr_init(&m_nrf_twi_mngr, &config));
+
+    if (optind == argc)
+    {
+        for (uint32_t i = 0; emu_env_scenario_at(i) != NULL; i++)
+        {
+            run(emu_env_scenario_at(i), days);
+        }
+        return 0;
+    }
+    for (int i = optind; i < argc; i++)
+    {
+        emu_env_config_t const * p_config = emu_env_scenario_get(argv[i]);
+
+        if (p_config == NULL)
+        {
+            fprintf(stderr, "unknown scenario %s\n", argv[i]);
+            return 2;
+        }
+        if (p_trace_path != NULL)
+        {
+            mp_trace = fopen(p_trace_path, "w");
+            if (mp_trace == NULL)
+            {
+                perror(p_trace_path);
+                return 2;
+            }
+            fprintf(mp_trace, "# HDC1080 trace - run_env scenario %s, seed %llu, %u days\n",
+                    p_config->p_name, (unsigned long long)p_config->seed, days);
+            fprintf(mp_trace, "# period_ms: %d\n", SAMPLING_PERIOD_MS);
+        }
+        run(p_config, days);
+        if (mp_trace != NULL)
+        {
+            fclose(mp_trace);
+            mp_trace = NULL;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,321 @@
+/** Emulator run - fused HDC1080 + BMP280 acquisition against sequential.
+ *
+ *    cc -I. -Itools/emu -Itools/emu/include tools/emu/emu_*.c \
+ *       tools/emu/run_fused.c bmp280.c hdc1080.c -lm -o /tmp/run_fused \
+ *        && /tmp/run_fused
+ *
+ *  Sequential: HDC1080 trigger, wait, read, then BMP280 forced trigger,
+ *  wait, read. Fused (FUSED_ACQUISITION_ENABLED in main.c): both triggers
+ *  in one transaction, one wait for the longer conversion, both results in
+ *  one transaction.
+ *
+ *  Wakes are counted the way the target sees them: the sampling tick, every
+ *  conversion timer expiry, and one TWI event per transfer (EasyDMA, a
+ *  register write followed by a read counts once) which also covers the
+ *  transaction callbacks.
+ */
+#include <stdio.h>
+#include "app_error.h"
+#include "emu_clock.h"
+#include "emu_twi.h"
+#include "emu_hdc1080.h"
+#include "emu_bmp280.h"
+#include "bmp280.h"
+#include "hdc1080.h"
+
+#define SAMPLES             10
+#define TICK_US             500000
+
+#define CONVERSION_TIME_MS  HDC1080_CONVERSION_MS
+#define FUSED_CONVERSION_TIME_MS                                    \
+    ((CONVERSION_TIME_MS > BMP280_DEFAULT_MEAS_TIME_MS) ?           \
+     CONVERSION_TIME_MS : BMP280_DEFAULT_MEAS_TIME_MS)
+
+NRF_TWI_MNGR_DEF(m_nrf_twi_mngr, 8, 0);
+
+static uint8_t m_hdc1080_data[4];
+static uint8_t m_bmp280_data[BMP280_DATA_SIZE];
+
+static nrf_twi_mngr_transfer_t const m_hdc1080_trigger[] =
+{
+    HDC1080_WRITE_T_AND_HR(&hdc1080_temp_reg_addr)
+};
+
+static nrf_twi_mngr_transfer_t const m_hdc1080_read[] =
+{
+    HDC1080_READ_T_AND_HR(m_hdc1080_data)
+};
+
+static nrf_twi_mngr_transfer_t const m_bmp280_read[] =
+{
+    BMP280_READ_PRESS_TEMP(m_bmp280_data)
+};
+
+static nrf_twi_mngr_transfer_t const m_fused_trigger[] =
+{
+    BMP280_WRITE_FORCED(),
+    HDC1080_WRITE_T_AND_HR(&hdc1080_temp_reg_addr)
+};
+
+static nrf_twi_mngr_transfer_t const m_fused_read[] =
+{
+    HDC1080_READ_T_AND_HR(m_hdc1080_data),
+    BMP280_READ_PRESS_TEMP(m_bmp280_data)
+};
+
+#define COUNT(a) ((uint8_t)(sizeof(a) / sizeof((a)[0])))
+
+// Single-shot conversion timer.
+static void   (* m_timer_handler)(void);
+static uint64_t  m_timer_deadline_us;
+static uint32_t  m_timer_wakes;
+
+static bool     m_done;
+static uint32_t m_errors;
+
+static void timer_start(uint32_t ms, void (* handler)(void))
+{
+    m_timer_deadline_us = emu_clock_now_us() + ms * 1000u;
+    m_timer_handler     = handler;
+}
+
+static void schedule(nrf_twi_mngr_transaction_t const * p_transaction)
+{
+    APP_ERROR_CHECK(nrf_twi_mngr_schedule(&m_nrf_twi_mngr, p_transaction));
+}
+
+// Runs bus and timer until the sample is complete.
+static void run_until_done(void)
+{
+    while (!m_done)
+    {
+        if (emu_twi_process())
+        {
+            continue;
+        }
+        if (m_timer_handler == NULL)
+        {
+            break;
+        }
+
+        void (* handler)(void) = m_timer_handler;
+
+        if (m_timer_deadline_us > emu_clock_now_us())
+        {
+            emu_clock_advance_us(m_timer_deadline_us - emu_clock_now_us());
+        }
+        m_timer_handler = NULL;
+        m_timer_wakes++;
+        handler();
+    }
+}
+
+static void done_cb(ret_code_t result, void * p_user_data)
+{
+    if (result != NRF_SUCCESS)
+    {
+        m_errors++;
+    }
+    m_done = true;
+}
+
+// Trigger transaction done - wait for the conversion.
+static void conversion_wait(ret_code_t result, uint32_t ms, void (* handler)(void))
+{
+    if (result != NRF_SUCCESS)
+    {
+        m_errors++;
+        m_done = true;
+        return;
+    }
+    timer_start(ms, handler);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sequential: HDC1080 sample, then BMP280 sample.
+//
+static void seq_bmp280_read(void)
+{
+    static nrf_twi_mngr_transaction_t const transaction =
+    {
+        .callback            = done_cb,
+        .p_transfers         = m_bmp280_read,
+        .number_of_transfers = COUNT(m_bmp280_read)
+    };
+
+    schedule(&transaction);
+}
+
+static void seq_bmp280_started_cb(ret_code_t result, void * p_user_data)
+{
+    conversion_wait(result, BMP280_DEFAULT_MEAS_TIME_MS, seq_bmp280_read);
+}
+
+static void seq_hdc1080_read_cb(ret_code_t result, void * p_user_data)
+{
+    static nrf_twi_mngr_transaction_t const transaction =
+    {
+        .callback            = seq_bmp280_started_cb,
+        .p_transfers         = bmp280_forced_transfers,
+        .number_of_transfers = BMP280_FORCED_TRANSFER_COUNT
+    };
+
+    if (result != NRF_SUCCESS)
+    {
+        m_errors++;
+    }
+    schedule(&transaction);
+}
+
+static void seq_hdc1080_read(void)
+{
+    static nrf_twi_mngr_transaction_t const transaction =
+    {
+        .callback            = seq_hdc1080_read_cb,
+        .p_transfers         = m_hdc1080_read,
+        .number_of_transfers = COUNT(m_hdc1080_read)
+    };
+
+    schedule(&transaction);
+}
+
+static void seq_hdc1080_started_cb(ret_code_t result, void * p_user_data)
+{
+    conversion_wait(result, CONVERSION_TIME_MS, seq_hdc1080_read);
+}
+
+static void seq_tick(void)
+{
+    static nrf_twi_mngr_transaction_t const transaction =
+    {
+        .callback            = seq_hdc1080_started_cb,
+        .p_transfers         = m_hdc1080_trigger,
+        .number_of_transfers = COUNT(m_hdc1080_trigger)
+    };
+
+    schedule(&transaction);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Fused: both triggers, one wait, both reads.
+//
+static void fused_read(void)
+{
+    static nrf_twi_mngr_transaction_t const transaction =
+    {
+        .callback            = done_cb,
+        .p_transfers         = m_fused_read,
+        .number_of_transfers = COUNT(m_fused_read)
+    };
+
+    schedule(&transaction);
+}
+
+static void fused_started_cb(ret_code_t result, void * p_user_data)
+{
+    conversion_wait(result, FUSED_CONVERSION_TIME_MS, fused_read);
+}
+
+static void fused_tick(void)
+{
+    static nrf_twi_mngr_transaction_t const transaction =
+    {
+        .callback            = fused_started_cb,
+        .p_transfers         = m_fused_trigger,
+        .number_of_transfers = COUNT(m_fused_trigger)
+    };
+
+    schedule(&transaction);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// TWI events of a transfer list - a write without STOP followed by a read
+// is one TX-RX transfer for the driver.
+static uint32_t twi_events(nrf_twi_mngr_transfer_t const * p_transfers, uint8_t count)
+{
+    uint32_t events = 0;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        bool txrx = !NRF_TWI_MNGR_IS_READ_OP(p_transfers[i].operation) &&
+                    (p_transfers[i].flags & NRF_TWI_MNGR_NO_STOP) &&
+                    i + 1 < count &&
+                    NRF_TWI_MNGR_IS_READ_OP(p_transfers[i + 1].operation);
+
+        events++;
+        i += txrx ? 1 : 0;
+    }
+    return events;
+}
+
+static void run(char const * p_label, void (* tick)(void), uint32_t events_per_sample)
+{
+    emu_twi_stats_t    stats;
+    bmp280_calib_t     calib;
+    uint8_t            calib_raw[BMP280_CALIB_SIZE];
+    uint64_t           latency_us = 0;
+    int32_t            t_fine;
+
+    emu_bmp280_calib_get(calib_raw);
+    bmp280_calib_parse(calib_raw, &calib);
+
+    emu_twi_stats_reset();
+    m_timer_wakes = 0;
+    m_errors      = 0;
+
+    for (int i = 0; i < SAMPLES; i++)
+    {
+        uint64_t start = emu_clock_now_us();
+
+        m_done = false;
+        tick();
+        run_until_done();
+        latency_us += emu_clock_now_us() - start;
+        emu_clock_advance_us(TICK_US - (emu_clock_now_us() - start));
+    }
+
+    emu_twi_stats_get(&stats);
+
+    int32_t  temp  = bmp280_compensate_t(&calib, BMP280_GET_ADC_T(m_bmp280_data), &t_fine);
+    uint32_t press = bmp280_compensate_p(&calib, BMP280_GET_ADC_P(m_bmp280_data), t_fine);
+    uint16_t hdc_t = (uint16_t)((m_hdc1080_data[0] << 8) | m_hdc1080_data[1]);
+    uint16_t hdc_h = (uint16_t)((m_hdc1080_data[2] << 8) | m_hdc1080_data[3]);
+
+    printf("%-10s %5.1f %6.1f %6.1f %6u %5.1f %5u %5u %8.2f\n", p_label,
+           (double)stats.transactions / SAMPLES,
+           (double)stats.busy_us / SAMPLES,
+           (double)latency_us / SAMPLES / 1000.0,
+           1 + m_timer_wakes / SAMPLES + events_per_sample,
+           (double)stats.bytes / SAMPLES,
+           (unsigned)stats.nacks, (unsigned)m_errors,
+           (double)(press >> 8) / 100.0);
+    printf("           last: HDC1080 %.2f C %.2f %%, BMP280 %d.%02d C\n",
+           HDC1080_TEMP_FROM_RAW(hdc_t), HDC1080_HUM_FROM_RAW(hdc_h),
+           temp / 100, temp % 100);
+}
+
+int main(void)
+{
+    static nrf_drv_twi_config_t const config = { .frequency = NRF_DRV_TWI_FREQ_100K };
+
+    APP_ERROR_CHECK(nrf_twi_mngr_init(&m_nrf_twi_mngr, &config));
+    emu_twi_attach(emu_hdc1080_init());
+    emu_twi_attach(emu_bmp280_init());
+    emu_hdc1080_env_set(22.5, 45.0);
+
+    uint32_t seq_events   = twi_events(m_hdc1080_trigger, COUNT(m_hdc1080_trigger)) +
+                            twi_events(m_hdc1080_read, COUNT(m_hdc1080_read)) +
+                            twi_events(bmp280_forced_transfers, BMP280_FORCED_TRANSFER_COUNT) +
+                            twi_events(m_bmp280_read, COUNT(m_bmp280_read));
+    uint32_t fused_events = twi_events(m_fused_trigger, COUNT(m_fused_trigger)) +
+                            twi_events(m_fused_read, COUNT(m_fused_read));
+
+    printf("HDC1080 wait %u ms, BMP280 wait %u ms, fused wait %u ms, %d samples at 100 kHz\n",
+           CONVERSION_TIME_MS, (unsigned)BMP280_DEFAULT_MEAS_TIME_MS,
+           (unsigned)FUSED_CONVERSION_TIME_MS, SAMPLES);
+    printf("per sample  trans  bus us  lat ms  wakes bytes nacks  errs   P hPa\n");
+    run("sequential", seq_tick, seq_events);
+    run("fused", fused_tick, fused_events);
+    return 0;
+}
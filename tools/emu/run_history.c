@@ -0,0 +1,197 @@
+/** Emulator run - tiered history (history.c) against exact statistics.
+ *
+ *    cc -O2 -I. -Itools/emu -Itools/emu/include tools/emu/emu_*.c \
+ *       tools/emu/run_history.c hdc1080.c history.c -lm \
+ *       -o /tmp/run_history && /tmp/run_history [days] [period ms]
+ *
+ *  The office scenario (emu_env.c) is sampled every 500 ms (or the period
+ *  given) through the HDC1080 model; heater and error slots are simulated
+ *  by skipping every 997th sample. After every hour the 24 h trend is compared with the
+ *  min/max/mean of all samples it covers and a least squares fit of the
+ *  exact hourly means. Reported are the worst differences, the size of
+ *  history_t and the cost of an update and of a trend query.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_error.h"
+#include "emu_clock.h"
+#include "emu_env.h"
+#include "emu_hdc1080.h"
+#include "emu_sim.h"
+#include "emu_twi.h"
+#include "hdc1080.h"
+#include "history.h"
+#include "nrf_delay.h"
+
+#define SAMPLING_PERIOD_MS  500
+#define MS_PER_HOUR         3600000ull
+#define SKIP_EVERY          997
+#define DEFAULT_DAYS        3
+
+NRF_TWI_MNGR_DEF(m_nrf_twi_mngr, 8, 0);
+
+static uint8_t m_temp_and_hr_buffer[4];
+
+static nrf_twi_mngr_transfer_t const m_trigger[] =
+{
+    HDC1080_WRITE_T_AND_HR(&hdc1080_temp_reg_addr)
+};
+
+static nrf_twi_mngr_transfer_t const m_read[] =
+{
+    HDC1080_READ_T_AND_HR(m_temp_and_hr_buffer)
+};
+
+typedef struct
+{
+    uint16_t temp;
+    uint16_t hum;
+    bool     valid;
+} slot_t;
+
+static history_t m_history;
+static slot_t *  mp_slots;
+static uint32_t  m_period_ms;
+
+// First slot that starts in the hour - slot i starts at i * m_period_ms.
+static uint32_t hour_slot(uint32_t hour)
+{
+    return (uint32_t)((hour * MS_PER_HOUR + m_period_ms - 1) / m_period_ms);
+}
+
+// Exact statistics over hours [first, last) and the fit of their means,
+// compared with the trend.
+typedef struct
+{
+    double range;   // Worst min/max difference in codes
+    double mean;
+    double slope;
+} diff_t;
+
+static void check(uint32_t first, uint32_t last, history_trend_t const * p_trend, diff_t * p_diff)
+{
+    uint16_t t_min = UINT16_MAX, t_max = 0;
+    double   t_sum = 0.0;
+    uint32_t count = 0;
+    double   n = 0, sx = 0, sxx = 0, sy = 0, sxy = 0;
+
+    for (uint32_t hour = first; hour < last; hour++)
+    {
+        double   h_sum   = 0.0;
+        uint32_t h_count = 0;
+
+        for (uint32_t i = hour_slot(hour); i < hour_slot(hour + 1); i++)
+        {
+            if (!mp_slots[i].valid)
+            {
+                continue;
+            }
+            t_min  = (mp_slots[i].temp < t_min) ? mp_slots[i].temp : t_min;
+            t_max  = (mp_slots[i].temp > t_max) ? mp_slots[i].temp : t_max;
+            h_sum += mp_slots[i].temp;
+            h_count++;
+        }
+        if (h_count == 0)
+        {
+            continue;
+        }
+        double x = hour - first;
+
+        t_sum += h_sum;
+        count += h_count;
+        n++;
+        sx  += x;
+        sxx += x * x;
+        sy  += h_sum / h_count;
+        sxy += x * h_sum / h_count;
+    }
+
+    double slope = (n > 1) ? (n * sxy - sx * sy) / (n * sxx - sx * sx) : 0.0;
+
+    p_diff->range = fmax(p_diff->range, fabs((double)p_trend->range.temp_min - t_min));
+    p_diff->range = fmax(p_diff->range, fabs((double)p_trend->range.temp_max - t_max));
+    p_diff->mean  = fmax(p_diff->mean, fabs(p_trend->range.temp_mean - t_sum / count));
+    p_diff->slope = fmax(p_diff->slope, fabs(p_trend->temp_slope - slope));
+}
+
+int main(int argc, char * argv[])
+{
+    static nrf_drv_twi_config_t const config = { .frequency = NRF_DRV_TWI_FREQ_100K };
+    uint32_t        days  = (argc > 1) ? (uint32_t)atoi(argv[1]) : DEFAULT_DAYS;
+    uint32_t        slots;
+    diff_t          diff  = { 0 };
+    history_trend_t trend;
+    uint32_t        hours = 0;
+    double          add_s = 0.0;
+
+    m_period_ms = (argc > 2) ? (uint32_t)atoi(argv[2]) : SAMPLING_PERIOD_MS;
+    slots       = hour_slot(days * 24);
+    mp_slots    = calloc(slots, sizeof(slot_t));
+    APP_ERROR_CHECK(nrf_twi_mngr_init(&m_nrf_twi_mngr, &config));
+    emu_sim_reset();
+    emu_twi_attach(emu_hdc1080_init());
+    emu_env_init(emu_env_scenario_get("office"));
+    emu_twi_fault_set(0.0, 0);
+    history_init(&m_history, m_period_ms);
+
+    for (uint32_t i = 0; i < slots; i++)
+    {
+        uint8_t rolled;
+        double  t;
+
+        emu_env_update();
+        APP_ERROR_CHECK(nrf_twi_mngr_perform(&m_nrf_twi_mngr, NULL, m_trigger, 1, NULL));
+        nrf_delay_ms(HDC1080_CONVERSION_MS);
+        APP_ERROR_CHECK(nrf_twi_mngr_perform(&m_nrf_twi_mngr, NULL, m_read, 1, NULL));
+
+        mp_slots[i].temp  = ((uint16_t)m_temp_and_hr_buffer[0] << 8) | m_temp_and_hr_buffer[1];
+        mp_slots[i].hum   = ((uint16_t)m_temp_and_hr_buffer[2] << 8) | m_temp_and_hr_buffer[3];
+        mp_slots[i].valid = (i % SKIP_EVERY) != SKIP_EVERY - 1;
+
+        t = emu_sim_wall_s();
+        rolled = mp_slots[i].valid
+               ? history_add(&m_history, mp_slots[i].temp, mp_slots[i].hum)
+               : history_skip(&m_history);
+        add_s += emu_sim_wall_s() - t;
+
+        if (rolled & HISTORY_ROLL_HOUR)
+        {
+            // [a slot longer than an hour rolls several]
+            uint32_t stored;
+
+            hours  = (uint32_t)((uint64_t)(i + 1) * m_period_ms / MS_PER_HOUR);
+            stored = (hours > HISTORY_HOURS - 1) ? HISTORY_HOURS - 1 : hours;
+            history_trend_get(&m_history, &trend);
+            check(hours - stored, hours, &trend, &diff);
+        }
+        emu_clock_advance_us(m_period_ms * 1000ull -
+                             (emu_clock_now_us() % (m_period_ms * 1000ull)));
+    }
+
+    double q0 = emu_sim_wall_s();
+    uint32_t sink = 0;
+
+    for (uint32_t i = 0; i < 1000000; i++)
+    {
+        history_trend_get(&m_history, &trend);
+        sink += trend.range.temp_max;
+    }
+    double query_ns = (emu_sim_wall_s() - q0) * 1e3;
+
+    history_trend_get(&m_history, &trend);
+    printf("%u days, %u slots of %u ms: history_t %zu bytes (budget %d)\n",
+           days, slots, m_period_ms, sizeof(history_t), HISTORY_RAM_BUDGET);
+    printf("  last trend     %u h, T %.2f..%.2f C mean %.3f C, %+.4f C/h\n",
+           trend.hours, HDC1080_TEMP_FROM_RAW(trend.range.temp_min),
+           HDC1080_TEMP_FROM_RAW(trend.range.temp_max),
+           HDC1080_TEMP_FROM_RAW(trend.range.temp_mean),
+           trend.temp_slope * 165.0 / 65536.0);
+    printf("  vs exact       range %.0f, mean %.2f, slope %.2f codes/h (worst of %u hours)\n",
+           diff.range, diff.mean, diff.slope, hours);
+    printf("  cost           %.1f ns per update, %.1f ns per trend query (%u)\n",
+           add_s * 1e9 / slots, query_ns, sink & 1);
+    free(mp_slots);
+    return 0;
+}
@@ -0,0 +1,166 @@
+/** Emulator run - sampling period jitter of the main.c tick under different
+ *  handler loads, measured with jitter.c on the virtual clock.
+ *
+ *    cc -I. -Itools/emu -Itools/emu/include tools/emu/emu_*.c \
+ *       tools/emu/run_jitter.c sampler.c hdc1080.c hdc1080_heater.c \
+ *       bmp280.c task_timer.c timestamp.c jitter.c -lm -o /tmp/run_jitter \
+ *        && /tmp/run_jitter
+ *
+ *  Scenarios (one simulated hour each, 500 ms period):
+ *    async      the firmware acquisition (sampler.c): the tick schedules
+ *               the trigger, a single-shot timer reads the result
+ *    blocking   the tick performs trigger, nrf_delay_ms(20), read and a
+ *               log flush itself (read_t_and_hr() style)
+ *    shared     async tick, plus another handler at the same priority that
+ *               blocks for a while every 300 ms
+ *    rearmed    blocking tick on a single-shot timer restarted at the end
+ *               of the handler instead of APP_TIMER_MODE_REPEATED
+ */
+#include <stdio.h>
+#include "app_error.h"
+#include "app_timer.h"
+#include "nrf_delay.h"
+#include "emu_clock.h"
+#include "emu_twi.h"
+#include "emu_app_timer.h"
+#include "emu_hdc1080.h"
+#include "hdc1080.h"
+#include "jitter.h"
+#include "sampler.h"
+#include "sampling_config.h"
+#include "timestamp.h"
+
+#define SIMULATED_S         3600
+#define OTHER_PERIOD_MS     300
+
+NRF_TWI_MNGR_DEF(m_nrf_twi_mngr, 8, 0);
+APP_TIMER_DEF(m_timer);
+APP_TIMER_DEF(m_other_timer);
+
+static uint8_t m_data[4];
+
+static nrf_twi_mngr_transfer_t const m_trigger[] =
+{
+    HDC1080_WRITE_T_AND_HR(&hdc1080_temp_reg_addr)
+};
+
+static nrf_twi_mngr_transfer_t const m_read[] =
+{
+    HDC1080_READ_T_AND_HR(m_data)
+};
+
+#define COUNT(a) ((uint8_t)(sizeof(a) / sizeof((a)[0])))
+
+static jitter_t m_jitter;
+static uint64_t m_tick_last_us;
+static bool     m_tick_seen;
+static uint32_t m_lcg = 1;
+
+// Deterministic pseudo random log flush time, 2..8 ms.
+static uint32_t log_flush_us(void)
+{
+    m_lcg = m_lcg * 1664525u + 1013904223u;
+    return 2000 + (m_lcg >> 8) % 6000;
+}
+
+static void jitter_tick(void)
+{
+    uint64_t now = emu_clock_now_us();
+
+    if (m_tick_seen)
+    {
+        jitter_record(&m_jitter, (uint32_t)(now - m_tick_last_us));
+    }
+    m_tick_last_us = now;
+    m_tick_seen    = true;
+}
+
+// Only the timing of the tick is of interest here.
+static void record_handler(sample_record_t const * p_record)
+{
+}
+
+static sampler_config_t const m_sampler_config =
+{
+    .p_twi               = &m_nrf_twi_mngr,
+    .record_handler      = record_handler,
+    .read_delay_ticks    = APP_TIMER_TICKS(READ_DELAY_MS),
+#if READY_POLLING_ENABLED
+    .poll_interval_ticks = APP_TIMER_TICKS(READY_POLL_INTERVAL_MS),
+    .poll_max            = READY_POLL_MAX,
+#endif
+};
+
+static void async_tick(void * p_context)
+{
+    jitter_tick();
+    sampler_tick();
+}
+
+static void blocking_tick(void * p_context)
+{
+    jitter_tick();
+    APP_ERROR_CHECK(nrf_twi_mngr_perform(&m_nrf_twi_mngr, NULL, m_trigger,
+                                         COUNT(m_trigger), NULL));
+    nrf_delay_ms(HDC1080_CONVERSION_MS);
+    APP_ERROR_CHECK(nrf_twi_mngr_perform(&m_nrf_twi_mngr, NULL, m_read,
+                                         COUNT(m_read), NULL));
+    nrf_delay_us(log_flush_us());
+}
+
+static void rearmed_tick(void * p_context)
+{
+    blocking_tick(p_context);
+    APP_ERROR_CHECK(app_timer_start(m_timer, APP_TIMER_TICKS(SAMPLING_PERIOD_MS), NULL));
+}
+
+static void other_handler(void * p_context)
+{
+    nrf_delay_us(10000 + log_flush_us());
+}
+
+static void run(char const * p_label, app_timer_mode_t mode,
+                app_timer_timeout_handler_t tick, bool other)
+{
+    jitter_report_t report;
+
+    emu_clock_reset();
+    APP_ERROR_CHECK(app_timer_init());
+    jitter_init(&m_jitter, SAMPLING_PERIOD_MS * 1000);
+    m_tick_seen = false;
+    m_lcg       = 1;
+
+    APP_ERROR_CHECK(timestamp_init());
+    APP_ERROR_CHECK(sampler_init(&m_sampler_config));
+    APP_ERROR_CHECK(app_timer_create(&m_timer, mode, tick));
+    if (other)
+    {
+        APP_ERROR_CHECK(app_timer_create(&m_other_timer, APP_TIMER_MODE_REPEATED,
+                                         other_handler));
+        APP_ERROR_CHECK(app_timer_start(m_other_timer, APP_TIMER_TICKS(OTHER_PERIOD_MS), NULL));
+    }
+    APP_ERROR_CHECK(app_timer_start(m_timer, APP_TIMER_TICKS(SAMPLING_PERIOD_MS), NULL));
+
+    emu_app_timer_run_until((uint64_t)SIMULATED_S * 1000000);
+
+    jitter_report_get(&m_jitter, &report);
+    printf("  %-10s %7u %9d %8u %8u %11.1f\n", p_label, report.samples,
+           report.mean_error_us, report.p99_us, report.max_us, report.phase_us / 1000.0);
+}
+
+int main(void)
+{
+    static nrf_drv_twi_config_t const config = { .frequency = NRF_DRV_TWI_FREQ_100K };
+
+    APP_ERROR_CHECK(nrf_twi_mngr_init(&m_nrf_twi_mngr, &config));
+    emu_twi_attach(emu_hdc1080_init());
+
+    printf("%d ms period, %d s simulated\n", SAMPLING_PERIOD_MS, SIMULATED_S);
+    printf("  %-10s %7s %9s %8s %8s %11s\n", "",
+           "samples", "mean us", "p99 us", "max us", "phase ms");
+    run("async",    APP_TIMER_MODE_REPEATED,    async_tick,    false);
+    run("blocking", APP_TIMER_MODE_REPEATED,    blocking_tick, false);
+    run("shared",   APP_TIMER_MODE_REPEATED,    async_tick,    true);
+    run("rearmed",  APP_TIMER_MODE_SINGLE_SHOT, rearmed_tick,  false);
+    return 0;
+}
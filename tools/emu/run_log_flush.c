@@ -0,0 +1,212 @@
+/** Emulator run - log flushing after every wake-up against the batched
+ *  flushing of main.c (LOG_FLUSH_BATCHED).
+ *
+ *    cc -I. -Itools/emu -Itools/emu/include tools/emu/emu_*.c \
+ *       tools/emu/run_log_flush.c sampler.c hdc1080.c hdc1080_heater.c \
+ *       bmp280.c task_timer.c timestamp.c -lm -o /tmp/run_log_flush \
+ *        && /tmp/run_log_flush
+ *
+ *  The firmware acquisition (sampler.c, sampling_config.h) runs on the
+ *  emulated bus with 1 % injected bus faults. Every interrupt handler is a
+ *  wake-up and is followed by a pass of the main loop
+ *  (emu_app_timer_idle_handler_set()), which flushes - every time, or by
+ *  the watermark and latency rule. Log entries are counted, not formatted:
+ *    log       SAMPLE_STREAM_ENABLED 0 - LOG_ENTRIES_PER_SAMPLE per sample
+ *    stream    samples go out over UARTE, the log only carries the jitter
+ *              report (every JITTER_REPORT_SAMPLES ticks) and warnings
+ *  Entries written by interrupt handlers (the warnings of sampler.c) and by
+ *  the main loop are both counted; latency is from logging to the flush
+ *  that writes the entry to RTT.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "app_error.h"
+#include "app_timer.h"
+#include "emu_app_timer.h"
+#include "emu_clock.h"
+#include "emu_hdc1080.h"
+#include "emu_log.h"
+#include "emu_twi.h"
+#include "hdc1080.h"
+#include "sampler.h"
+#include "sampling_config.h"
+#include "timestamp.h"
+
+#define SIMULATED_S             600
+#define FAULT_PROBABILITY       0.01
+
+// Entries sample_process() in main.c logs per sample without the stream.
+#define LOG_ENTRIES_PER_SAMPLE  6
+
+#define LOG_PENDING_MAX         256
+
+NRF_TWI_MNGR_DEF(m_nrf_twi_mngr, 8, 0);
+APP_TIMER_DEF(m_timer);
+
+typedef struct
+{
+    uint32_t wakes;
+    uint32_t flush_calls;   // NRF_LOG_FLUSH()
+    uint32_t flush_writes;  // ... that had something to write
+    uint32_t entries;
+    uint64_t latency_us;    // Sum over the entries
+    uint64_t latency_max_us;
+} stats_t;
+
+static bool     m_batched;
+static bool     m_stream;
+static stats_t  m_stats;
+static uint64_t m_pending[LOG_PENDING_MAX]; // Time each entry was logged
+static uint32_t m_pending_count;
+static uint32_t m_samples_pending;          // Samples queued for the main loop
+static uint16_t m_log_samples;
+static uint64_t m_log_flushed_us;
+static uint32_t m_ticks;
+
+static void log_entries(uint32_t count)
+{
+    for (uint32_t i = 0; i < count && m_pending_count < LOG_PENDING_MAX; i++)
+    {
+        m_pending[m_pending_count++] = emu_clock_now_us();
+    }
+}
+
+static void log_flush_now(void)
+{
+    uint64_t now = emu_clock_now_us();
+
+    m_stats.flush_calls++;
+    if (m_pending_count == 0)
+    {
+        return;
+    }
+    m_stats.flush_writes++;
+    for (uint32_t i = 0; i < m_pending_count; i++)
+    {
+        uint64_t latency = now - m_pending[i];
+
+        m_stats.latency_us += latency;
+        if (latency > m_stats.latency_max_us)
+        {
+            m_stats.latency_max_us = latency;
+        }
+    }
+    m_stats.entries += m_pending_count;
+    m_pending_count  = 0;
+}
+
+// One pass of the main loop after an interrupt - samples_drain(), then
+// log_flush() or the unconditional NRF_LOG_FLUSH().
+static void main_loop_pass(void)
+{
+    m_stats.wakes++;
+
+    while (m_samples_pending > 0)
+    {
+        m_samples_pending--;
+        if (!m_stream)
+        {
+            log_entries(LOG_ENTRIES_PER_SAMPLE);
+            m_log_samples++;
+        }
+    }
+
+    if (!m_batched)
+    {
+        log_flush_now();
+        return;
+    }
+    if (m_log_samples < LOG_FLUSH_WATERMARK &&
+        emu_clock_now_us() - m_log_flushed_us < LOG_FLUSH_MAX_LATENCY_MS * 1000u)
+    {
+        return;
+    }
+    log_flush_now();
+    m_log_samples    = 0;
+    m_log_flushed_us = emu_clock_now_us();
+}
+
+// Warnings of the modules under test, logged from their handlers.
+static void log_handler(void)
+{
+    log_entries(1);
+}
+
+static void record_handler(sample_record_t const * p_record)
+{
+    // A failed read has already been logged by sampler.c.
+    if (!(p_record->flags & SAMPLE_FLAG_ERROR))
+    {
+        m_samples_pending++;
+    }
+}
+
+static void timer_handler(void * p_context)
+{
+    if (++m_ticks % JITTER_REPORT_SAMPLES == 0)
+    {
+        log_entries(2);
+    }
+    sampler_tick();
+}
+
+static sampler_config_t const m_sampler_config =
+{
+    .p_twi               = &m_nrf_twi_mngr,
+    .record_handler      = record_handler,
+    .read_delay_ticks    = APP_TIMER_TICKS(READ_DELAY_MS),
+#if READY_POLLING_ENABLED
+    .poll_interval_ticks = APP_TIMER_TICKS(READY_POLL_INTERVAL_MS),
+    .poll_max            = READY_POLL_MAX,
+#endif
+};
+
+static void run(char const * p_label, bool stream, bool batched)
+{
+    double minutes = SIMULATED_S / 60.0;
+
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_stream          = stream;
+    m_batched         = batched;
+    m_pending_count   = 0;
+    m_samples_pending = 0;
+    m_log_samples     = 0;
+    m_log_flushed_us  = 0;
+    m_ticks           = 0;
+
+    emu_clock_reset();
+    emu_twi_fault_set(FAULT_PROBABILITY, 1);
+    APP_ERROR_CHECK(app_timer_init());
+    APP_ERROR_CHECK(timestamp_init());
+    APP_ERROR_CHECK(sampler_init(&m_sampler_config));
+    APP_ERROR_CHECK(app_timer_create(&m_timer, APP_TIMER_MODE_REPEATED, timer_handler));
+    APP_ERROR_CHECK(app_timer_start(m_timer, APP_TIMER_TICKS(SAMPLING_PERIOD_MS), NULL));
+    emu_app_timer_run_until((uint64_t)SIMULATED_S * 1000000);
+    APP_ERROR_CHECK(app_timer_stop(m_timer));
+
+    printf("  %-18s %8.1f %8.1f %8.1f %9.1f %9.1f %9.1f\n", p_label,
+           m_stats.wakes / minutes, m_stats.flush_calls / minutes,
+           m_stats.flush_writes / minutes, m_stats.entries / minutes,
+           m_stats.entries ? m_stats.latency_us / 1000.0 / m_stats.entries : 0.0,
+           m_stats.latency_max_us / 1000.0);
+}
+
+int main(void)
+{
+    static nrf_drv_twi_config_t const config = { .frequency = NRF_DRV_TWI_FREQ_100K };
+
+    APP_ERROR_CHECK(nrf_twi_mngr_init(&m_nrf_twi_mngr, &config));
+    emu_twi_attach(emu_hdc1080_init());
+    emu_log_handler_set(log_handler);
+    emu_app_timer_idle_handler_set(main_loop_pass);
+
+    printf("per minute, %d s simulated, %.0f %% bus faults\n",
+           SIMULATED_S, FAULT_PROBABILITY * 100);
+    printf("  %-18s %8s %8s %8s %9s %9s %9s\n", "", "wakes", "flushes", "writes",
+           "entries", "mean ms", "max ms");
+    run("log, every wake",    false, false);
+    run("log, batched",       false, true);
+    run("stream, every wake", true,  false);
+    run("stream, batched",    true,  true);
+    return 0;
+}
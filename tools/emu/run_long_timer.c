@@ -0,0 +1,105 @@
+/** Emulator run - wake-ups per day of the RTC2 long-period scheduler
+ *  (long_timer.c) against the app_timer sampling tick.
+ *
+ *    cc -I. -Itools/emu -Itools/emu/include tools/emu/emu_*.c \
+ *       tools/emu/run_long_timer.c hdc1080.c long_timer.c -lm \
+ *       -o /tmp/run_long_timer && /tmp/run_long_timer
+ *
+ *  Each period runs for SIMULATED_DAYS of virtual time. Reported are the
+ *  prescaler and tick count chosen, the error of the programmed period, the
+ *  measured sampling interrupts per day and the phase of the last sample
+ *  against the ideal schedule.
+ *
+ *  The app_timer column is computed, not run: app_timer (RTC1, 16384 Hz)
+ *  takes the overflow interrupt every 1024 s whether a timer is due or not,
+ *  and a period longer than the largest timeout (1024 s less
+ *  APP_TIMER_SAFE_WINDOW_MS) has to be chained from shorter single-shot
+ *  timeouts, one more wake-up per segment. The wake-ups for reading the
+ *  conversion result are the same with both and not counted.
+ */
+#include <math.h>
+#include <stdio.h>
+#include "app_error.h"
+#include "emu_clock.h"
+#include "emu_rtc.h"
+#include "long_timer.h"
+
+#define SIMULATED_DAYS          7
+#define DAY_US                  (86400ull * 1000000)
+
+#define APP_TIMER_FREQ_HZ       16384
+#define APP_TIMER_OVERFLOW_S    ((double)(1ul << 24) / APP_TIMER_FREQ_HZ)
+#define APP_TIMER_SAFE_WINDOW_S 300.0
+#define APP_TIMER_MAX_TIMEOUT_S (APP_TIMER_OVERFLOW_S - APP_TIMER_SAFE_WINDOW_S)
+
+static uint64_t m_start_us;
+static uint32_t m_samples;
+static int64_t  m_phase_us;
+static uint32_t m_period_ms;
+
+static void sample_handler(void * p_context)
+{
+    m_samples++;
+    m_phase_us = (int64_t)(emu_clock_now_us() - m_start_us) -
+                 (int64_t)m_samples * m_period_ms * 1000;
+}
+
+static double app_timer_wakes_per_day(uint32_t period_ms)
+{
+    double period_s = period_ms / 1000.0;
+    double samples  = 86400.0 / period_s;
+    double segments = ceil(period_s / APP_TIMER_MAX_TIMEOUT_S);
+
+    return samples * segments + 86400.0 / APP_TIMER_OVERFLOW_S;
+}
+
+static void run(char const * p_label, uint32_t period_ms)
+{
+    long_timer_config_t config;
+    emu_rtc_stats_t     stats;
+    double              tick_us;
+    double              error_us;
+
+    emu_clock_reset();
+    emu_rtc_reset();
+    m_samples   = 0;
+    m_phase_us  = 0;
+    m_period_ms = period_ms;
+    m_start_us  = emu_clock_now_us();
+
+    APP_ERROR_CHECK(long_timer_config_get(period_ms, &config));
+    APP_ERROR_CHECK(long_timer_start(period_ms, sample_handler, NULL));
+
+    emu_rtc_run_until(m_start_us + SIMULATED_DAYS * DAY_US);
+    emu_rtc_stats_get(&stats);
+    long_timer_stop();
+
+    tick_us   = (config.prescaler + 1) * 1e6 / LONG_TIMER_RTC_FREQ_HZ;
+    error_us  = config.period_ticks * tick_us - period_ms * 1000.0;
+
+    printf("  %-9s %5u %9u %8.1f %6s %8.2f %12.1f %10.1f %10.1f\n",
+           p_label, config.prescaler, config.period_ticks, tick_us,
+           config.exact ? "yes" : "no", error_us,
+           m_phase_us / 1000.0,
+           (double)stats.interrupts / SIMULATED_DAYS,
+           app_timer_wakes_per_day(period_ms));
+}
+
+int main(void)
+{
+    printf("%d days simulated per period, longest period %u s\n",
+           SIMULATED_DAYS, LONG_TIMER_MAX_PERIOD_MS / 1000);
+    printf("  %-9s %5s %9s %8s %6s %8s %12s %10s %10s\n", "period", "presc",
+           "ticks", "tick us", "exact", "err us", "phase ms", "wakes/day",
+           "app_timer");
+    run("1 s",       1000);
+    run("1 min",     60000);
+    run("10 min",    600000);
+    run("17 min",    1020000);
+    run("1 h",       3600000);
+    run("6 h",       21600000);
+    run("24 h",      86400000);
+    run("7 min 1 s", 421000);
+    run("1 h 1 ms",  3600001);
+    return 0;
+}
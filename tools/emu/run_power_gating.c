@@ -0,0 +1,202 @@
+/** Emulator run - HDC1080 supply switching against standby between samples.
+ *
+ *    cc -I. -Itools/emu -Itools/emu/include tools/emu/emu_*.c \
+ *       tools/emu/run_power_gating.c sampler.c hdc1080.c hdc1080_heater.c \
+ *       bmp280.c task_timer.c timestamp.c -lm -o /tmp/run_power_gating \
+ *        && /tmp/run_power_gating
+ *
+ *  One sample of the firmware acquisition (sampler.c, sampling_config.h) on
+ *  the emulated bus, with and without the power switch
+ *  (SENSOR_POWER_GATING_ENABLED in main.c):
+ *    standby: tick, trigger, conversion timer, read (polled)
+ *    gated:   tick + power up, start-up timer, hdc1080_init(), trigger,
+ *             conversion timer, read (polled), power down from the main
+ *             loop (idle handler) once the record has been handed over
+ *  The charge per sample is then taken from the current model below and the
+ *  sampling period at which both cost the same is reported.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "app_error.h"
+#include "app_timer.h"
+#include "emu_app_timer.h"
+#include "emu_clock.h"
+#include "emu_twi.h"
+#include "emu_hdc1080.h"
+#include "hdc1080.h"
+#include "sampler.h"
+#include "sampling_config.h"
+#include "timestamp.h"
+
+// Current model. Sensor values are HDC1080 datasheet typicals; the start-up
+// current is not specified and is assumed to equal the RH measurement
+// current (pessimistic). MCU values are nRF52832 estimates (DC/DC on).
+#define HDC1080_SLEEP_UA        0.1
+#define HDC1080_CONVERT_UA      175.0   // T 160 uA, RH 190 uA
+#define HDC1080_STARTUP_UA      190.0
+#define SUPPLY_CAP_NF           100.0   // Decoupling, discharged at power-off
+#define SUPPLY_V                3.0
+#define MCU_WAKE_UC             0.07    // Per interrupt: ~20 us at 3.7 mA
+#define MCU_TWI_UA              700.0   // HFCLK + TWIM while the bus is busy
+
+#define CYCLE_MS                100     // Time given to one sample
+
+NRF_TWI_MNGR_DEF(m_nrf_twi_mngr, 8, 0);
+
+typedef struct
+{
+    uint32_t wakes;         // Tick, timer expiries and transaction callbacks
+    uint32_t bus_us;
+    uint32_t on_us;         // Supply on (gated only)
+    uint32_t conversion_us;
+    uint32_t errors;
+} cycle_t;
+
+static cycle_t  m_cycle;
+static uint32_t m_records;
+static uint64_t m_power_on_us;
+
+static void power_set(bool on)
+{
+    emu_hdc1080_power_set(on);
+    if (on)
+    {
+        m_power_on_us = emu_clock_now_us();
+    }
+    else
+    {
+        m_cycle.on_us = (uint32_t)(emu_clock_now_us() - m_power_on_us);
+    }
+}
+
+static void record_handler(sample_record_t const * p_record)
+{
+    m_records++;
+    if (p_record->flags & SAMPLE_FLAG_ERROR)
+    {
+        m_cycle.errors++;
+    }
+}
+
+// Main loop pass of the firmware - nothing to process, the release follows
+// the record right away.
+static void main_loop_pass(void)
+{
+    sampler_power_release();
+}
+
+static cycle_t cycle_run(bool gated)
+{
+    static sampler_config_t config =
+    {
+        .p_twi               = &m_nrf_twi_mngr,
+        .record_handler      = record_handler,
+        .read_delay_ticks    = APP_TIMER_TICKS(READ_DELAY_MS),
+#if READY_POLLING_ENABLED
+        .poll_interval_ticks = APP_TIMER_TICKS(READY_POLL_INTERVAL_MS),
+        .poll_max            = READY_POLL_MAX,
+#endif
+    };
+    emu_app_timer_stats_t timer_stats;
+    emu_twi_stats_t       stats;
+
+    // [no emu_sim_reset() - the clock keeps running for the sensor model]
+    emu_twi_stats_reset();
+    APP_ERROR_CHECK(app_timer_init());
+    memset(&m_cycle, 0, sizeof(m_cycle));
+    m_records = 0;
+    hdc1080_config_shadow_reset();
+
+    config.power_set = gated ? power_set : NULL;
+    APP_ERROR_CHECK(timestamp_init());
+    APP_ERROR_CHECK(sampler_init(&config));
+    if (gated)
+    {
+        sampler_power_down();
+    }
+
+    emu_app_timer_idle_handler_set(main_loop_pass);
+
+    sampler_tick();
+    emu_app_timer_run_until(emu_clock_now_us() + CYCLE_MS * 1000u);
+
+    emu_app_timer_stats_get(&timer_stats);
+    emu_twi_stats_get(&stats);
+    m_cycle.wakes         = 1 + timer_stats.expiries + stats.transactions;
+    m_cycle.bus_us        = (uint32_t)stats.busy_us;
+    m_cycle.conversion_us = emu_hdc1080_conversion_us();
+    if (m_records == 0)
+    {
+        m_cycle.errors++;   // The configuration failed
+    }
+    return m_cycle;
+}
+
+// Charge per sample in uC that does not depend on the sampling period.
+static double cycle_charge_uc(cycle_t const * p_cycle, bool gated)
+{
+    double q = p_cycle->wakes * MCU_WAKE_UC +
+               p_cycle->bus_us * 1e-6 * MCU_TWI_UA +
+               p_cycle->conversion_us * 1e-6 * HDC1080_CONVERT_UA;
+
+    if (gated)
+    {
+        uint32_t idle_us = p_cycle->on_us - HDC1080_STARTUP_MS * 1000u - p_cycle->conversion_us;
+
+        q += HDC1080_STARTUP_MS * 1e-3 * HDC1080_STARTUP_UA +
+             idle_us * 1e-6 * HDC1080_SLEEP_UA +
+             SUPPLY_CAP_NF * 1e-3 * SUPPLY_V;
+    }
+    else
+    {
+        // Standby outside the conversion is added per period by the caller.
+        q -= p_cycle->conversion_us * 1e-6 * HDC1080_SLEEP_UA;
+    }
+    return q;
+}
+
+int main(void)
+{
+    static nrf_drv_twi_config_t const config = { .frequency = NRF_DRV_TWI_FREQ_100K };
+    static double const periods_s[] = { 0.5, 1, 5, 10, 30, 60, 120, 300, 600 };
+
+    APP_ERROR_CHECK(nrf_twi_mngr_init(&m_nrf_twi_mngr, &config));
+    emu_twi_attach(emu_hdc1080_init());
+
+    // The start-up time is honoured: an init right after power-up is NACKed.
+    emu_hdc1080_power_set(false);
+    emu_hdc1080_power_set(true);
+    ret_code_t early = nrf_twi_mngr_perform(&m_nrf_twi_mngr, NULL, hdc1080_init_transfers,
+                                            HDC1080_INIT_TRANSFER_COUNT, NULL);
+    emu_clock_advance_us(HDC1080_STARTUP_MS * 1000u);
+    ret_code_t late  = nrf_twi_mngr_perform(&m_nrf_twi_mngr, NULL, hdc1080_init_transfers,
+                                            HDC1080_INIT_TRANSFER_COUNT, NULL);
+    printf("init at 0 ms after power-up: %s, at %d ms: %s\n",
+           early == NRF_SUCCESS ? "ACK" : "NACK", HDC1080_STARTUP_MS,
+           late == NRF_SUCCESS ? "ACK" : "NACK");
+
+    cycle_t standby = cycle_run(false);
+    cycle_t gated   = cycle_run(true);
+    double  q_standby = cycle_charge_uc(&standby, false);
+    double  q_gated   = cycle_charge_uc(&gated, true);
+
+    printf("per sample        wakes  bus us  on ms  errs  charge uC\n");
+    printf("  standby         %5u %7u      - %5u %10.3f + %.1f uA x period\n",
+           standby.wakes, standby.bus_us, standby.errors, q_standby, HDC1080_SLEEP_UA);
+    printf("  gated           %5u %7u %6.2f %5u %10.3f\n",
+           gated.wakes, gated.bus_us, gated.on_us / 1000.0, gated.errors, q_gated);
+
+    printf("average current [uA]\n  period s   standby     gated\n");
+    for (unsigned i = 0; i < sizeof(periods_s) / sizeof(periods_s[0]); i++)
+    {
+        double t = periods_s[i];
+
+        printf("  %8.1f %9.4f %9.4f\n", t,
+               q_standby / t + HDC1080_SLEEP_UA, q_gated / t);
+    }
+
+    // q_standby / t + I_sleep = q_gated / t
+    printf("crossover: gating pays off above %.1f s\n",
+           (q_gated - q_standby) / HDC1080_SLEEP_UA);
+    return 0;
+}
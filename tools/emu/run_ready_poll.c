@@ -0,0 +1,108 @@
+/** Emulator run - HDC1080 ready detection by NACK polling against the
+ *  fixed conversion wait.
+ *
+ *    cc -I. -Itools/emu -Itools/emu/include tools/emu/emu_*.c \
+ *       tools/emu/run_ready_poll.c sampler.c hdc1080.c hdc1080_heater.c \
+ *       bmp280.c task_timer.c timestamp.c -lm -o /tmp/run_ready_poll \
+ *        && /tmp/run_ready_poll
+ *
+ *  The firmware acquisition (sampler.c) in both configurations. Fixed:
+ *  trigger, wait HDC1080_CONVERSION_MS, read. Polling
+ *  (READY_POLLING_ENABLED in sampling_config.h): trigger, wait
+ *  READ_DELAY_MS, then repeat the read every interval until it is
+ *  acknowledged. The conversion time of the emulated part is scaled to show
+ *  how the latency follows it.
+ */
+#include <stdio.h>
+#include "app_error.h"
+#include "app_timer.h"
+#include "emu_app_timer.h"
+#include "emu_clock.h"
+#include "emu_twi.h"
+#include "emu_hdc1080.h"
+#include "hdc1080.h"
+#include "sampler.h"
+#include "sampling_config.h"
+#include "timestamp.h"
+
+#define SAMPLES     20
+#define TICK_US     500000
+
+// Sub-millisecond intervals, APP_TIMER_TICKS() takes whole milliseconds.
+#define US_TO_TICKS(US) ((uint32_t)(((uint64_t)(US) * APP_TIMER_CLOCK_FREQ + 500000) / 1000000))
+
+NRF_TWI_MNGR_DEF(m_nrf_twi_mngr, 8, 0);
+
+static uint32_t m_errors;
+static uint64_t m_latency_us;
+static uint64_t m_tick_us;
+
+static void record_handler(sample_record_t const * p_record)
+{
+    if (p_record->flags & SAMPLE_FLAG_ERROR)
+    {
+        m_errors++;
+    }
+    m_latency_us += emu_clock_now_us() - m_tick_us;
+}
+
+static void run(char const * p_label, uint32_t delay_ticks, uint32_t interval_ticks)
+{
+    sampler_config_t const config =
+    {
+        .p_twi               = &m_nrf_twi_mngr,
+        .record_handler      = record_handler,
+        .read_delay_ticks    = delay_ticks,
+        .poll_interval_ticks = interval_ticks,
+        .poll_max            = READY_POLL_MAX
+    };
+    emu_app_timer_stats_t timer_stats;
+    emu_twi_stats_t       stats;
+
+    m_errors     = 0;
+    m_latency_us = 0;
+    emu_twi_stats_reset();
+    APP_ERROR_CHECK(app_timer_init());
+    APP_ERROR_CHECK(timestamp_init());
+    APP_ERROR_CHECK(sampler_init(&config));
+
+    for (int i = 0; i < SAMPLES; i++)
+    {
+        m_tick_us = emu_clock_now_us();
+        sampler_tick();
+        emu_app_timer_run_until(m_tick_us + TICK_US);
+    }
+
+    emu_app_timer_stats_get(&timer_stats);
+    emu_twi_stats_get(&stats);
+    printf("  %-14s %7.2f %6.2f %6.2f %7.1f %5u\n", p_label,
+           (double)m_latency_us / SAMPLES / 1000.0,
+           (double)stats.nacks / SAMPLES,
+           (double)timer_stats.expiries / SAMPLES,
+           (double)stats.busy_us / SAMPLES,
+           (unsigned)m_errors);
+}
+
+int main(void)
+{
+    static nrf_drv_twi_config_t const config = { .frequency = NRF_DRV_TWI_FREQ_100K };
+    static double const scales[] = { 0.8, 1.0, 1.1, 1.3 };
+
+    APP_ERROR_CHECK(nrf_twi_mngr_init(&m_nrf_twi_mngr, &config));
+    emu_twi_attach(emu_hdc1080_init());
+
+    for (unsigned i = 0; i < sizeof(scales) / sizeof(scales[0]); i++)
+    {
+        uint32_t delay_ticks = APP_TIMER_TICKS(READ_DELAY_MS);
+
+        emu_hdc1080_conversion_scale_set(scales[i]);
+        printf("conversion %.2f ms (x%.1f), %d samples at 100 kHz\n",
+               emu_hdc1080_conversion_us() / 1000.0, scales[i], SAMPLES);
+        printf("  %-14s %7s %6s %6s %7s %5s\n", "", "lat ms", "nacks", "timers", "bus us", "errs");
+        run("fixed 20 ms", APP_TIMER_TICKS(HDC1080_CONVERSION_MS), 0);
+        run("poll 0.5 ms", delay_ticks, US_TO_TICKS(500));
+        run("poll 1 ms", delay_ticks, US_TO_TICKS(1000));
+        run("poll 2 ms", delay_ticks, US_TO_TICKS(2000));
+    }
+    return 0;
+}
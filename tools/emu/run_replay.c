@@ -0,0 +1,458 @@
+/** Trace replay - recorded HDC1080 frames through the main.c processing
+ *  chain as fast as the host runs it.
+ *
+ *    cc -O2 -I. -Itools/emu -Itools/emu/include tools/emu/emu_*.c \
+ *       tools/emu/run_replay.c sample_proc.c summary.c median_filter.c \
+ *       ema_filter.c psychro.c sample_stream.c cobs.c window_stats.c \
+ *       deadband.c -lm -o /tmp/run_replay \
+ *        && /tmp/run_replay [-p passes] [-r | -d] tools/emu/traces/condensation_1h.trace
+ *
+ *  A trace is text, one m_temp_and_hr_buffer frame per line as 8 hex
+ *  digits; lines starting with '#' are comments. These comment keys are
+ *  understood:
+ *    # period_ms: <n>          sampling period, for the record timestamps
+ *    # digest: <hex>           expected digest of the replay output
+ *    # digest-records: <hex>   the same with -r
+ *    # digest-deadband: <hex>  the same with -d
+ *  With a digest for the mode in the file the trace is a regression
+ *  fixture - the run fails if the output differs. A change that is only meant to be faster
+ *  has to keep it; a change of behaviour updates it.
+ *
+ *  Stages, as in sample_process() of main.c with the settings of
+ *  sampling_config.h:
+ *    decode    frame bytes to sample_record_t
+ *    process   heater flag of the record, sample_proc.c (median filter,
+ *              average, dew point and absolute humidity), heater start when
+ *              heater_due
+ *    deadband  with -d, report on change (DEADBAND_ENABLED, deadband.c)
+ *    summary   window statistics of the codes (summary.c, SUMMARY_ENABLED)
+ *    stream    CRC-8, COBS framing and buffering (sample_stream.c) of the
+ *              summaries, with -r of every record (SUMMARY_ENABLED 0) or
+ *              with -d of the reported records
+ *  Frames are processed in blocks of REPLAY_BLOCK, stage by stage, so the
+ *  time of each stage can be taken without timing every frame. The digest
+ *  covers the stream bytes and the averaged and derived values of the
+ *  first pass; further passes only add to the timing.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "app_error.h"
+#include "deadband.h"
+#include "emu_sim.h"
+#include "emu_uarte.h"
+#include "app_timer.h"
+#include "hdc1080.h"
+#include "sample.h"
+#include "sample_proc.h"
+#include "sample_stream.h"
+#include "sampling_config.h"
+#include "summary.h"
+
+#define REPLAY_BLOCK            1024
+#define DEFAULT_PERIOD_MS       500
+
+typedef enum
+{
+    STAGE_DECODE,
+    STAGE_PROCESS,
+    STAGE_DEADBAND,
+    STAGE_SUMMARY,
+    STAGE_STREAM,
+    STAGE_COUNT
+} stage_t;
+
+static char const * const m_stage_names[STAGE_COUNT] =
+{
+    "decode", "process", "deadband", "summary", "stream"
+};
+
+typedef struct
+{
+    float temp;
+    float hum;
+} sample_t;
+
+// Output modes, each with its own digest in the trace.
+typedef enum
+{
+    MODE_SUMMARY,   // Default
+    MODE_RECORDS,   // -r
+    MODE_DEADBAND,  // -d
+    MODE_COUNT
+} output_mode_t;
+
+static char const * const m_digest_keys[MODE_COUNT] =
+{
+    [MODE_SUMMARY]  = "# digest: %llx",
+    [MODE_RECORDS]  = "# digest-records: %llx",
+    [MODE_DEADBAND] = "# digest-deadband: %llx"
+};
+
+typedef struct
+{
+    uint8_t (* p_frames)[4];
+    size_t   count;
+    size_t   capacity;
+    uint32_t period_ms;
+    uint64_t digest[MODE_COUNT];
+    bool     has_digest[MODE_COUNT];
+} trace_t;
+
+// Pipeline state, reset for every pass.
+static sample_proc_t        m_proc;
+static sample_proc_ring_t   m_proc_ring;
+static sample_proc_result_t m_result;
+static uint32_t        m_heater_left;
+static uint32_t        m_alarms;
+static uint32_t        m_heater_frames;
+static summary_t       m_summary;
+static bool            m_stream_records;    // -r: SUMMARY_ENABLED 0
+static bool            m_deadband_on;       // -d: DEADBAND_ENABLED 1
+static deadband_t      m_deadband;
+static uint32_t        m_reasons[4];        // Reports per DEADBAND_REPORT_ bit
+
+// Block buffers.
+static sample_record_t m_records[REPLAY_BLOCK];
+static sample_t        m_average[REPLAY_BLOCK];
+static int16_t         m_dew[REPLAY_BLOCK];
+static uint32_t        m_abs[REPLAY_BLOCK];
+static bool            m_report[REPLAY_BLOCK];
+static sample_summary_t m_summaries[REPLAY_BLOCK / SUMMARY_WINDOW_SAMPLES + 1];
+static size_t          m_summary_count;
+static uint8_t         m_wire[REPLAY_BLOCK * (SAMPLE_STREAM_FUSED_SIZE + 2)];
+static size_t          m_wire_len;
+
+static double          m_stage_s[STAGE_COUNT];
+
+static void wire_sink(uint8_t const * p_data, size_t length)
+{
+    if (m_wire_len + length <= sizeof(m_wire))
+    {
+        memcpy(&m_wire[m_wire_len], p_data, length);
+        m_wire_len += length;
+    }
+}
+
+static void trace_load(char const * p_path, trace_t * p_trace)
+{
+    FILE * p_file = fopen(p_path, "r");
+    char   line[128];
+
+    if (p_file == NULL)
+    {
+        perror(p_path);
+        exit(2);
+    }
+    memset(p_trace, 0, sizeof(*p_trace));
+    p_trace->period_ms = DEFAULT_PERIOD_MS;
+
+    while (fgets(line, sizeof(line), p_file) != NULL)
+    {
+        unsigned long long value;
+        unsigned int       period;
+
+        if (line[0] == '#')
+        {
+            if (sscanf(line, "# period_ms: %u", &period) == 1)
+            {
+                p_trace->period_ms = period;
+            }
+            for (int m = 0; m < MODE_COUNT; m++)
+            {
+                if (sscanf(line, m_digest_keys[m], &value) == 1)
+                {
+                    p_trace->digest[m]     = value;
+                    p_trace->has_digest[m] = true;
+                }
+            }
+            continue;
+        }
+        if (sscanf(line, "%8llx", &value) != 1)
+        {
+            continue;
+        }
+        if (p_trace->count == p_trace->capacity)
+        {
+            p_trace->capacity = (p_trace->capacity != 0) ? p_trace->capacity * 2 : 4096;
+            p_trace->p_frames = realloc(p_trace->p_frames, p_trace->capacity * 4);
+            if (p_trace->p_frames == NULL)
+            {
+                perror("realloc");
+                exit(2);
+            }
+        }
+        p_trace->p_frames[p_trace->count][0] = (uint8_t)(value >> 24);
+        p_trace->p_frames[p_trace->count][1] = (uint8_t)(value >> 16);
+        p_trace->p_frames[p_trace->count][2] = (uint8_t)(value >> 8);
+        p_trace->p_frames[p_trace->count][3] = (uint8_t)value;
+        p_trace->count++;
+    }
+    fclose(p_file);
+}
+
+static void stage_decode(trace_t const * p_trace, size_t first, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        uint8_t const *   p_frame  = p_trace->p_frames[first + i];
+        sample_record_t * p_record = &m_records[i];
+
+        p_record->t_trigger = (uint32_t)APP_TIMER_TICKS((uint64_t)(first + i) * p_trace->period_ms);
+        p_record->t_done    = p_record->t_trigger + APP_TIMER_TICKS(READ_DELAY_MS);
+        p_record->temp_raw  = ((uint16_t)p_frame[0] << 8) | p_frame[1];
+        p_record->hum_raw   = ((uint16_t)p_frame[2] << 8) | p_frame[3];
+        p_record->flags     = 0;
+    }
+}
+
+// main.c sample_process() - the heater flag is taken at the trigger, ahead
+// of this sample's average; a heater cycle runs HEATER_BURST_CONVERSIONS
+// ticks.
+static void stage_process(size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (m_heater_left > 0)
+        {
+            m_records[i].flags |= SAMPLE_FLAG_HEATER;
+            m_heater_left--;
+            m_heater_frames++;
+        }
+
+        // Heater samples leave the average as it is.
+        bool processed = sample_proc_update(&m_proc, &m_records[i], &m_result);
+
+        m_average[i].temp = m_result.temp;
+        m_average[i].hum  = m_result.hum;
+        m_dew[i]          = m_result.dew_point;
+        m_abs[i]          = m_result.abs_humidity;
+
+        if (processed && m_result.heater_due && m_heater_left == 0)
+        {
+            m_heater_left = HEATER_BURST_CONVERSIONS;
+            m_alarms++;
+        }
+    }
+}
+
+// main.c sample_process() - heater samples always go out.
+static void stage_deadband(size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        uint8_t reasons;
+
+        if (!m_deadband_on || (m_records[i].flags & SAMPLE_FLAG_HEATER))
+        {
+            m_report[i] = true;
+            continue;
+        }
+        reasons      = deadband_update(&m_deadband, m_records[i].temp_raw,
+                                       m_records[i].hum_raw);
+        m_report[i]  = (reasons != 0);
+        for (int b = 0; b < 4; b++)
+        {
+            m_reasons[b] += (reasons >> b) & 1;
+        }
+    }
+}
+
+static void stage_summary(size_t n)
+{
+    m_summary_count = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (summary_add(&m_summary, &m_records[i]))
+        {
+            m_summaries[m_summary_count++] = m_summary.summary;
+        }
+    }
+}
+
+static void stage_stream(size_t n)
+{
+    if (m_stream_records)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            if (m_report[i])
+            {
+                sample_stream_put(&m_records[i]);
+            }
+        }
+        return;
+    }
+    for (size_t i = 0; i < m_summary_count; i++)
+    {
+        sample_stream_summary_put(&m_summaries[i]);
+    }
+}
+
+static void stage_end(stage_t stage, double * p_t)
+{
+    double now = emu_sim_wall_s();
+
+    m_stage_s[stage] += now - *p_t;
+    *p_t              = now;
+}
+
+static void pass(trace_t const * p_trace, bool digest)
+{
+    deadband_config_t const deadband_config =
+    {
+        .temp_abs  = DEADBAND_TEMP_ABS,
+        .temp_rel  = DEADBAND_TEMP_REL,
+        .hum_abs   = DEADBAND_HUM_ABS,
+        .hum_rel   = DEADBAND_HUM_REL,
+        .heartbeat = (uint16_t)(DEADBAND_HEARTBEAT_MS / p_trace->period_ms)
+    };
+
+    sample_proc_config_t const proc_config =
+    {
+        .median    = MEDIAN_FILTER_ENABLED,
+        .ema       = AVERAGING_USE_EMA,
+        .heater_rh = HEATER_RH_THRESHOLD
+    };
+
+    memset(&m_result, 0, sizeof(m_result));
+    m_heater_left   = 0;
+    m_alarms        = 0;
+    m_heater_frames = 0;
+    sample_proc_init(&m_proc, &proc_config, &m_proc_ring);
+    summary_init(&m_summary, SUMMARY_WINDOW_SAMPLES);
+    deadband_init(&m_deadband, &deadband_config);
+    memset(m_reasons, 0, sizeof(m_reasons));
+
+    for (size_t first = 0; first < p_trace->count; first += REPLAY_BLOCK)
+    {
+        size_t n = p_trace->count - first;
+        double t;
+
+        if (n > REPLAY_BLOCK)
+        {
+            n = REPLAY_BLOCK;
+        }
+        m_wire_len = 0;
+
+        t = emu_sim_wall_s();
+        stage_decode(p_trace, first, n);
+        stage_end(STAGE_DECODE, &t);
+        stage_process(n);
+        stage_end(STAGE_PROCESS, &t);
+        stage_deadband(n);
+        stage_end(STAGE_DEADBAND, &t);
+        if (!m_stream_records)
+        {
+            stage_summary(n);
+        }
+        stage_end(STAGE_SUMMARY, &t);
+        stage_stream(n);
+        stage_end(STAGE_STREAM, &t);
+
+        if (digest)
+        {
+            emu_sim_digest_add(m_wire, m_wire_len);
+            emu_sim_digest_add(m_average, n * sizeof(m_average[0]));
+            emu_sim_digest_add(m_dew, n * sizeof(m_dew[0]));
+            emu_sim_digest_add(m_abs, n * sizeof(m_abs[0]));
+        }
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    sample_stream_stats_t stream;
+    trace_t               trace;
+    uint32_t              passes = 1;
+    double                total_s = 0.0;
+    int                   opt;
+
+    while ((opt = getopt(argc, argv, "p:rd")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p': passes = (uint32_t)atoi(optarg); break;
+        case 'r': m_stream_records = true;         break;
+        case 'd': m_stream_records = true;
+                  m_deadband_on    = true;         break;
+        default:  passes = 0;                      break;
+        }
+    }
+    if (optind >= argc || passes == 0)
+    {
+        fprintf(stderr, "usage: %s [-p passes] [-r | -d] trace\n", argv[0]);
+        return 2;
+    }
+
+    trace_load(argv[optind], &trace);
+    if (trace.count == 0)
+    {
+        fprintf(stderr, "%s: no frames\n", argv[optind]);
+        return 2;
+    }
+
+    emu_uarte_sink_set(wire_sink);
+    APP_ERROR_CHECK(sample_stream_init(0));
+
+    for (uint32_t i = 0; i < passes; i++)
+    {
+        pass(&trace, i == 0);
+        if (i == 0)
+        {
+            sample_stream_stats_get(&stream);
+        }
+    }
+    for (int s = 0; s < STAGE_COUNT; s++)
+    {
+        total_s += m_stage_s[s];
+    }
+
+    double frames    = (double)trace.count * passes;
+    double frame_ns  = total_s * 1e9 / frames;
+    double sim_days  = frames * trace.period_ms / 1000.0 / 86400.0;
+
+    printf("%s: %zu frames at %u ms, %u passes\n", argv[optind], trace.count,
+           trace.period_ms, passes);
+    printf("  throughput   %.2f M frames/s, %.1f ns/frame, %.0f days of samples per s\n",
+           frames / total_s / 1e6, frame_ns, sim_days / total_s);
+    for (int s = 0; s < STAGE_COUNT; s++)
+    {
+        printf("    %-9s  %7.1f ns/frame  %5.1f %%\n", m_stage_names[s],
+               m_stage_s[s] * 1e9 / frames, 100.0 * m_stage_s[s] / total_s);
+    }
+    printf("  alarms       %u heater starts, %u frames flagged\n",
+           m_alarms, m_heater_frames);
+    printf("  stream       %u %s, %u bytes on the wire, %u dropped\n",
+           stream.records, m_stream_records ? "sample records" : "summaries",
+           stream.wire_bytes, stream.dropped);
+    if (m_deadband_on)
+    {
+        uint32_t total = m_deadband.reported + m_deadband.suppressed;
+
+        printf("  deadband     %u of %u held back (%.1f %%), reported for T %u, RH %u,"
+               " heartbeat %u\n", m_deadband.suppressed, total,
+               100.0 * m_deadband.suppressed / total,
+               m_reasons[1], m_reasons[2], m_reasons[3]);
+    }
+    printf("  digest       %016llx", (unsigned long long)emu_sim_digest_get());
+
+    output_mode_t mode = m_deadband_on    ? MODE_DEADBAND :
+                         m_stream_records ? MODE_RECORDS  : MODE_SUMMARY;
+
+    if (!trace.has_digest[mode])
+    {
+        printf("\n");
+        return 0;
+    }
+    if (trace.digest[mode] != emu_sim_digest_get())
+    {
+        printf(" - MISMATCH, fixture has %016llx\n",
+               (unsigned long long)trace.digest[mode]);
+        return 1;
+    }
+    printf(" - matches the fixture\n");
+    return 0;
+}
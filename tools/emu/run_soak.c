@@ -0,0 +1,231 @@
+/** Emulator run - weeks of the main.c sampling loop in accelerated virtual
+ *  time, for effects that only show up after a long time.
+ *
+ *    cc -O2 -I. -Itools/emu -Itools/emu/include tools/emu/emu_*.c \
+ *       tools/emu/run_soak.c sampler.c sample_proc.c hdc1080.c \
+ *       hdc1080_heater.c bmp280.c task_timer.c timestamp.c median_filter.c \
+ *       ema_filter.c psychro.c -lm -o /tmp/run_soak && /tmp/run_soak [days]
+ *
+ *  The acquisition (sampler.c) and the processing (sample_proc.c) are those
+ *  of the firmware, configured from sampling_config.h, with a diurnal
+ *  temperature and humidity cycle plus a random walk as the environment.
+ *  Checked over the run:
+ *    - drift of the float running sum of the window mean against the exact
+ *      window sum of the codes
+ *    - sample timestamps (timestamp.c) across the 24-bit RTC overflows and
+ *      the 32-bit timestamp wrap (every 72.8 h)
+ *  The run is done twice and the digests of everything produced compared;
+ *  speed is reported as simulated hours per wall second.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_error.h"
+#include "app_timer.h"
+#include "emu_app_timer.h"
+#include "emu_clock.h"
+#include "emu_hdc1080.h"
+#include "emu_sim.h"
+#include "emu_twi.h"
+#include "hdc1080.h"
+#include "sample_proc.h"
+#include "sampler.h"
+#include "sampling_config.h"
+#include "timestamp.h"
+
+#define DEFAULT_DAYS            28
+
+#define DAY_S                   86400.0
+#define PI                      3.14159265358979
+
+NRF_TWI_MNGR_DEF(m_nrf_twi_mngr, 8, 0);
+APP_TIMER_DEF(m_timer);
+
+typedef struct
+{
+    float temp;
+    float hum;
+} sample_t;
+
+typedef struct
+{
+    uint32_t samples;
+    uint32_t errors;
+    uint32_t ts_wraps;          // 32-bit timestamp wrap-arounds
+    uint32_t ts_bad_intervals;  // Tick intervals off by more than a tick
+    double   drift_temp_max;    // |float average - exact average|
+    double   drift_hum_max;
+    double   drift_temp_end;
+    double   drift_hum_end;
+    uint64_t digest;
+} soak_result_t;
+
+static soak_result_t        m_result;
+static sample_proc_t        m_proc;
+static sample_proc_ring_t   m_proc_ring;
+static sample_proc_result_t m_average;
+static uint32_t             m_raw_sum_temp;      // Exact window sums of the codes
+static uint32_t             m_raw_sum_hum;
+static uint16_t             m_raw_temp[SAMPLE_PROC_WINDOW];
+static uint16_t             m_raw_hum[SAMPLE_PROC_WINDOW];
+static uint8_t              m_sample_idx;
+static uint32_t             m_t_last;
+static uint32_t             m_lcg;
+static double               m_walk_temp;
+static double               m_walk_hum;
+
+static double lcg_unit(void)
+{
+    m_lcg = m_lcg * 1664525u + 1013904223u;
+    return (m_lcg >> 8) / 16777216.0 - 0.5;
+}
+
+static void environment_update(void)
+{
+    double day = 2.0 * PI * (emu_clock_now_us() / 1e6) / DAY_S;
+
+    m_walk_temp = 0.999 * m_walk_temp + 0.02 * lcg_unit();
+    m_walk_hum  = 0.999 * m_walk_hum  + 0.10 * lcg_unit();
+    emu_hdc1080_env_set(22.0 + 4.0 * sin(day) + m_walk_temp,
+                        50.0 - 15.0 * sin(day) + m_walk_hum);
+}
+
+static void timestamp_check(uint32_t t_trigger)
+{
+    if (m_result.samples + m_result.errors > 0)
+    {
+        uint32_t interval = timestamp_diff_us(t_trigger, m_t_last);
+
+        if (t_trigger < m_t_last)
+        {
+            m_result.ts_wraps++;
+        }
+        if (labs((long)interval - SAMPLING_PERIOD_MS * 1000L) > 1000000L / APP_TIMER_CLOCK_FREQ)
+        {
+            m_result.ts_bad_intervals++;
+        }
+    }
+    m_t_last = t_trigger;
+}
+
+static void record_handler(sample_record_t const * p_record)
+{
+    timestamp_check(p_record->t_trigger);
+
+    if (!sample_proc_update(&m_proc, p_record, &m_average))
+    {
+        m_result.errors++;
+        return;
+    }
+
+    // Reference from the integer window sums of the (median filtered) codes.
+    m_raw_sum_temp += m_average.temp_raw - m_raw_temp[m_sample_idx];
+    m_raw_sum_hum  += m_average.hum_raw - m_raw_hum[m_sample_idx];
+    m_raw_temp[m_sample_idx] = m_average.temp_raw;
+    m_raw_hum[m_sample_idx]  = m_average.hum_raw;
+
+    if (++m_sample_idx >= SAMPLE_PROC_WINDOW)
+    {
+        m_sample_idx = 0;
+    }
+
+    m_result.samples++;
+    if (m_result.samples >= SAMPLE_PROC_WINDOW)
+    {
+        double exact_temp = m_raw_sum_temp * (165.0 / 65536.0) / SAMPLE_PROC_WINDOW - 40.0;
+        double exact_hum  = m_raw_sum_hum * (100.0 / 65536.0) / SAMPLE_PROC_WINDOW;
+
+        m_result.drift_temp_end = fabs(m_average.temp - exact_temp);
+        m_result.drift_hum_end  = fabs(m_average.hum - exact_hum);
+        m_result.drift_temp_max = fmax(m_result.drift_temp_max, m_result.drift_temp_end);
+        m_result.drift_hum_max  = fmax(m_result.drift_hum_max, m_result.drift_hum_end);
+    }
+
+    emu_sim_digest_add(&p_record->t_trigger, sizeof(p_record->t_trigger));
+    emu_sim_digest_add(&p_record->temp_raw, sizeof(p_record->temp_raw));
+    emu_sim_digest_add(&p_record->hum_raw, sizeof(p_record->hum_raw));
+    emu_sim_digest_add(&m_average.temp, sizeof(m_average.temp));
+    emu_sim_digest_add(&m_average.hum, sizeof(m_average.hum));
+}
+
+static void timer_handler(void * p_context)
+{
+    environment_update();
+    sampler_tick();
+}
+
+static sampler_config_t const m_sampler_config =
+{
+    .p_twi               = &m_nrf_twi_mngr,
+    .record_handler      = record_handler,
+    .read_delay_ticks    = APP_TIMER_TICKS(READ_DELAY_MS),
+#if READY_POLLING_ENABLED
+    .poll_interval_ticks = APP_TIMER_TICKS(READY_POLL_INTERVAL_MS),
+    .poll_max            = READY_POLL_MAX,
+#endif
+};
+
+static void soak(uint32_t days)
+{
+    static sample_proc_config_t const proc_config =
+    {
+        .median    = MEDIAN_FILTER_ENABLED,
+        .ema       = false,     // The drift check is on the window mean
+        .heater_rh = HEATER_RH_THRESHOLD
+    };
+
+    emu_sim_reset();
+    memset(&m_result, 0, sizeof(m_result));
+    memset(m_raw_temp, 0, sizeof(m_raw_temp));
+    memset(m_raw_hum, 0, sizeof(m_raw_hum));
+    m_raw_sum_temp = 0;
+    m_raw_sum_hum  = 0;
+    m_sample_idx   = 0;
+    m_lcg          = 1;
+    m_walk_temp    = 0.0;
+    m_walk_hum     = 0.0;
+    sample_proc_init(&m_proc, &proc_config, &m_proc_ring);
+
+    APP_ERROR_CHECK(timestamp_init());
+    APP_ERROR_CHECK(sampler_init(&m_sampler_config));
+    APP_ERROR_CHECK(app_timer_create(&m_timer, APP_TIMER_MODE_REPEATED, timer_handler));
+    APP_ERROR_CHECK(app_timer_start(m_timer, APP_TIMER_TICKS(SAMPLING_PERIOD_MS), NULL));
+
+    emu_app_timer_run_until((uint64_t)days * 86400 * 1000000);
+    m_result.digest = emu_sim_digest_get();
+}
+
+int main(int argc, char * argv[])
+{
+    static nrf_drv_twi_config_t const config = { .frequency = NRF_DRV_TWI_FREQ_100K };
+    uint32_t        days = (argc > 1) ? (uint32_t)atoi(argv[1]) : DEFAULT_DAYS;
+    soak_result_t   first;
+    emu_twi_stats_t stats;
+    double          wall_s;
+
+    APP_ERROR_CHECK(nrf_twi_mngr_init(&m_nrf_twi_mngr, &config));
+    emu_twi_attach(emu_hdc1080_init());
+
+    wall_s = emu_sim_wall_s();
+    soak(days);
+    wall_s = emu_sim_wall_s() - wall_s;
+    first  = m_result;
+    emu_twi_stats_get(&stats);
+    soak(days);
+
+    printf("%u days at %d ms: %u samples, %u errors, %u NACKed reads\n",
+           days, SAMPLING_PERIOD_MS, first.samples, first.errors, stats.nacks);
+    printf("  speed            %.0f simulated h per wall s, %.0fx real time (%.2f s)\n",
+           days * 24.0 / wall_s, days * DAY_S / wall_s, wall_s);
+    printf("  digest           %016llx, second run %s\n",
+           (unsigned long long)first.digest,
+           (first.digest == m_result.digest) ? "identical" : "DIFFERENT");
+    printf("  timestamps       %u wraps, %u intervals off by more than a tick\n",
+           first.ts_wraps, first.ts_bad_intervals);
+    printf("  mean drift       T max %.2g C, at end %.2g C\n",
+           first.drift_temp_max, first.drift_temp_end);
+    printf("                   RH max %.2g %%, at end %.2g %%\n",
+           first.drift_hum_max, first.drift_hum_end);
+    return (first.digest == m_result.digest) ? 0 : 1;
+}
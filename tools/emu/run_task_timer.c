@@ -0,0 +1,251 @@
+/** Emulator run - wake-ups of one app_timer per task against the
+ *  coalescing task_timer.c on a single app_timer.
+ *
+ *    cc -I. -Itools/emu -Itools/emu/include tools/emu/emu_*.c \
+ *       tools/emu/run_task_timer.c task_timer.c timestamp.c -lm \
+ *       -o /tmp/run_task_timer && /tmp/run_task_timer
+ *
+ *  Each task set runs for SIMULATED_S of virtual time, once with an
+ *  app_timer per task and twice on task_timer.c - with the tolerances of
+ *  the table and with all of them 0. Tasks are started at their offset from
+ *  boot, as they would be by the parts of an application coming up one
+ *  after the other. Handlers take no time; handlers running at the same
+ *  instant are one wake-up, as timers expiring in the same RTC tick are on
+ *  the target. The conversion read is a single-shot task started by every
+ *  sampling tick.
+ *  Reported per hour are the wake-ups, the handlers run and, for
+ *  task_timer.c, the app_timer restarts; the largest lateness of any
+ *  handler against its own deadline, and the most any handler ran past its
+ *  deadline plus tolerance.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "app_error.h"
+#include "app_timer.h"
+#include "emu_app_timer.h"
+#include "emu_clock.h"
+#include "sampling_config.h"
+#include "task_timer.h"
+#include "timestamp.h"
+
+#define SIMULATED_S             3600
+#define TASKS_MAX               8
+
+typedef struct
+{
+    char const * p_name;
+    uint32_t     period_ms;     // 0 - the conversion read after the task above
+    uint32_t     tolerance_ms;
+    uint32_t     offset_ms;     // Started at, ascending
+} task_desc_t;
+
+typedef struct
+{
+    task_desc_t const * p_desc;
+    uint32_t            tolerance;  // Ticks, 0 unless coalescing
+    app_timer_t         app_timer;
+    task_timer_t        task;
+    uint64_t            due;        // emu_app_timer_ticks()
+    uint64_t            late_max;
+    uint64_t            over_max;   // Past the tolerance
+} task_t;
+
+typedef enum
+{
+    MODE_APP_TIMER,
+    MODE_TASK_TIMER,
+    MODE_TASK_TIMER_EXACT   // Tolerances 0
+} run_mode_t;
+
+// The sampling loop of main.c with TASK_TIMER_ENABLED, sampling_config.h.
+static task_desc_t const m_firmware[] =
+{
+    { "sample",  SAMPLING_PERIOD_MS,   0,                              0    },
+    { "read",    0,                    0,                              0    },
+    { "report",  TASK_TIMER_REPORT_MS, TASK_TIMER_REPORT_TOLERANCE_MS, 0    },
+};
+
+// The same with the periodic work of a typical sensor node added - battery
+// and status, a watchdog feed, an indicator LED, housekeeping and a radio
+// interval that is not a multiple of the others.
+static task_desc_t const m_node[] =
+{
+    { "wdt",     1000,                 250,                            2    },
+    { "sample",  SAMPLING_PERIOD_MS,   0,                              31   },
+    { "read",    0,                    0,                              31   },
+    { "report",  TASK_TIMER_REPORT_MS, TASK_TIMER_REPORT_TOLERANCE_MS, 31   },
+    { "led",     2000,                 100,                            140  },
+    { "status",  10000,                500,                            377  },
+    { "radio",   1285,                 20,                             1210 },
+    { "house",   300000,               5000,                           2650 },
+};
+
+static task_t     m_tasks[TASKS_MAX];
+static run_mode_t m_mode;
+static task_t *   mp_sample;
+static task_t *   mp_read;
+static uint64_t   m_last_us;
+static uint32_t   m_wakes;
+static uint32_t   m_runs;
+
+static uint32_t ticks(uint32_t ms)
+{
+    return APP_TIMER_TICKS(ms);
+}
+
+static void read_start(void)
+{
+    mp_read->due = emu_app_timer_ticks() + ticks(READ_DELAY_MS);
+    if (m_mode == MODE_APP_TIMER)
+    {
+        APP_ERROR_CHECK(app_timer_start(&mp_read->app_timer, ticks(READ_DELAY_MS), mp_read));
+    }
+    else
+    {
+        APP_ERROR_CHECK(task_timer_start(&mp_read->task, ticks(READ_DELAY_MS), 0, mp_read));
+    }
+}
+
+static void task_handler(void * p_context)
+{
+    task_t * p_task = p_context;
+    uint64_t now_us = emu_clock_now_us();
+    uint64_t now    = emu_app_timer_ticks();
+
+    if (now_us != m_last_us)
+    {
+        m_wakes++;
+        m_last_us = now_us;
+    }
+    m_runs++;
+
+    if (now > p_task->due && now - p_task->due > p_task->late_max)
+    {
+        p_task->late_max = now - p_task->due;
+    }
+    if (now > p_task->due + p_task->tolerance &&
+        now - p_task->due - p_task->tolerance > p_task->over_max)
+    {
+        p_task->over_max = now - p_task->due - p_task->tolerance;
+    }
+
+    if (p_task->p_desc->period_ms != 0)
+    {
+        p_task->due += ticks(p_task->p_desc->period_ms);
+    }
+    if (p_task == mp_sample && mp_read != NULL)
+    {
+        read_start();
+    }
+}
+
+static void run(char const * p_label, task_desc_t const * p_descs,
+                uint32_t count, run_mode_t mode)
+{
+    task_timer_stats_t stats = {0};
+    uint64_t           late_max = 0;
+    uint64_t           over_max = 0;
+    double             hours = SIMULATED_S / 3600.0;
+
+    emu_clock_reset();
+    APP_ERROR_CHECK(app_timer_init());
+    APP_ERROR_CHECK(timestamp_init());
+    if (mode != MODE_APP_TIMER)
+    {
+        APP_ERROR_CHECK(task_timer_init());
+    }
+
+    memset(m_tasks, 0, sizeof(m_tasks));
+    m_mode       = mode;
+    mp_sample    = NULL;
+    mp_read      = NULL;
+    m_last_us    = UINT64_MAX;
+    m_wakes      = 0;
+    m_runs       = 0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        task_t * p_task    = &m_tasks[i];
+        uint32_t period_ms = p_descs[i].period_ms;
+        uint32_t tolerance = (mode == MODE_TASK_TIMER) ? ticks(p_descs[i].tolerance_ms) : 0;
+
+        emu_app_timer_run_until(p_descs[i].offset_ms * 1000ull);
+
+        p_task->p_desc    = &p_descs[i];
+        p_task->tolerance = tolerance;
+        if (mode == MODE_APP_TIMER)
+        {
+            app_timer_id_t id = &p_task->app_timer;
+
+            APP_ERROR_CHECK(app_timer_create(&id,
+                                             period_ms ? APP_TIMER_MODE_REPEATED
+                                                       : APP_TIMER_MODE_SINGLE_SHOT,
+                                             task_handler));
+        }
+        else
+        {
+            task_timer_create(&p_task->task, task_handler, tolerance);
+        }
+
+        if (period_ms == 0)
+        {
+            mp_sample = p_task - 1; // Starts the read
+            mp_read   = p_task;
+            continue;
+        }
+        p_task->due = emu_app_timer_ticks() + ticks(period_ms);
+        if (mode == MODE_APP_TIMER)
+        {
+            APP_ERROR_CHECK(app_timer_start(&p_task->app_timer, ticks(period_ms), p_task));
+        }
+        else
+        {
+            APP_ERROR_CHECK(task_timer_start(&p_task->task, ticks(period_ms),
+                                             ticks(period_ms), p_task));
+        }
+    }
+
+    emu_app_timer_run_until(SIMULATED_S * 1000000ull);
+
+    if (mode != MODE_APP_TIMER)
+    {
+        task_timer_stats_get(&stats);
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (m_tasks[i].late_max > late_max)
+        {
+            late_max = m_tasks[i].late_max;
+        }
+        if (m_tasks[i].over_max > over_max)
+        {
+            over_max = m_tasks[i].over_max;
+        }
+    }
+
+    printf("  %-10s %-16s %9.0f %9.0f %9.0f %10.2f %8.2f\n",
+           p_label,
+           (mode == MODE_APP_TIMER) ? "app_timer each" :
+           (mode == MODE_TASK_TIMER) ? "task_timer" : "task_timer tol 0",
+           m_wakes / hours, m_runs / hours,
+           (mode == MODE_APP_TIMER) ? 0.0 : stats.rearms / hours,
+           late_max * 1000.0 / APP_TIMER_CLOCK_FREQ,
+           over_max * 1000.0 / APP_TIMER_CLOCK_FREQ);
+}
+
+static void run_set(char const * p_label, task_desc_t const * p_descs, uint32_t count)
+{
+    run(p_label, p_descs, count, MODE_APP_TIMER);
+    run(p_label, p_descs, count, MODE_TASK_TIMER_EXACT);
+    run(p_label, p_descs, count, MODE_TASK_TIMER);
+}
+
+int main(void)
+{
+    printf("%u s simulated, per hour\n", SIMULATED_S);
+    printf("  %-10s %-16s %9s %9s %9s %10s %8s\n", "tasks", "timers", "wakes",
+           "handlers", "restarts", "late ms", "over ms");
+    run_set("firmware", m_firmware, sizeof(m_firmware) / sizeof(m_firmware[0]));
+    run_set("node", m_node, sizeof(m_node) / sizeof(m_node[0]));
+    return 0;
+}
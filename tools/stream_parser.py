@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+"""Host side parser for the binary sample stream (see sample_stream.h).
+
+Reads COBS framed records from a serial port or pty and prints the decoded
+samples together with the sustained record rate and the byte overhead.
+
+    python3 tools/stream_parser.py /dev/ttyACM0 [--baud 115200] [--quiet]
+"""
+
+import argparse
+import os
+import struct
+import sys
+import termios
+import time
+
+RECORD_SAMPLE = 0x01
+RECORD_FUSED = 0x02
+RECORD_SUMMARY = 0x03
+RECORD_SUMMARY_FUSED = 0x04
+RECORD_SIZES = {RECORD_SAMPLE: 17, RECORD_FUSED: 23, RECORD_SUMMARY: 37,
+                RECORD_SUMMARY_FUSED: 61}
+SUMMARY_PRESS_SHIFT = 4
+REPORT_INTERVAL_S = 5.0
+
+BAUD_RATES = {
+    9600: termios.B9600, 19200: termios.B19200, 38400: termios.B38400,
+    57600: termios.B57600, 115200: termios.B115200, 230400: termios.B230400,
+    460800: termios.B460800, 921600: termios.B921600,
+}
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def cobs_decode(frame):
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0:
+            raise ValueError("zero byte inside frame")
+        i += 1
+        out += frame[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def open_port(path, baud):
+    fd = os.open(path, os.O_RDONLY | os.O_NOCTTY)
+    if os.isatty(fd):
+        attrs = termios.tcgetattr(fd)
+        attrs[0] = 0                                    # iflag
+        attrs[1] = 0                                    # oflag
+        attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+        attrs[3] = 0                                    # lflag
+        attrs[4] = attrs[5] = BAUD_RATES[baud]
+        attrs[6][termios.VMIN] = 1
+        attrs[6][termios.VTIME] = 0
+        termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+
+class Stats:
+    def __init__(self):
+        self.records = 0
+        self.payload_bytes = 0
+        self.wire_bytes = 0
+        self.crc_errors = 0
+        self.framing_errors = 0
+        self.lost = 0
+        self.last_seq = None
+        self.start = time.monotonic()
+
+    def report(self):
+        elapsed = max(time.monotonic() - self.start, 1e-9)
+        overhead = (self.wire_bytes / self.payload_bytes - 1.0) * 100.0 \
+            if self.payload_bytes else 0.0
+        print("# %.1f records/s, %.0f B/s, overhead %.1f %%, "
+              "lost %d, crc errors %d, framing errors %d"
+              % (self.records / elapsed, self.wire_bytes / elapsed, overhead,
+                 self.lost, self.crc_errors, self.framing_errors),
+              file=sys.stderr)
+
+
+def summary_channel(record, offset, scale, shift):
+    """min, max, mean, standard deviation of one channel in units."""
+    lo, hi = struct.unpack_from("<HH", record, offset)
+    mean = int.from_bytes(record[offset + 4:offset + 7], "little") / 256.0
+    var = struct.unpack_from("<I", record, offset + 7)[0]
+    unit = scale / 65536.0
+    return (lo * unit + shift, hi * unit + shift, mean * unit + shift,
+            var ** 0.5 * unit)
+
+
+def print_summary(record):
+    seq, t_first, t_last, count = struct.unpack_from("<HIIH", record, 1)
+    temp = summary_channel(record, 13, 165.0, -40.0)
+    hum = summary_channel(record, 24, 100.0, 0.0)
+    line = "%5d %10u %10u n=%3d T %7.2f..%7.2f mean %7.3f sd %6.3f C " \
+        "RH %6.2f..%6.2f mean %6.3f sd %6.3f %% %02x" \
+        % ((seq, t_first, t_last, count) + temp + hum + (record[35],))
+    if record[0] == RECORD_SUMMARY_FUSED:
+        # BMP280 ADC codes, back to 20 bits - compensation needs the
+        # sensor's calibration.
+        press_count = struct.unpack_from("<H", record, 36)[0]
+        scale = 65536.0 * (1 << SUMMARY_PRESS_SHIFT)
+        press = summary_channel(record, 38, scale, 0.0)
+        ptemp = summary_channel(record, 49, scale, 0.0)
+        line += " n=%3d P %6d..%6d mean %8.1f sd %6.1f T %6d..%6d mean %8.1f sd %6.1f" \
+            % ((press_count,) + press + ptemp)
+    print(line)
+
+
+def handle_frame(frame, stats, quiet):
+    stats.wire_bytes += len(frame) + 1      # delimiter included
+    try:
+        record = cobs_decode(frame)
+    except ValueError:
+        stats.framing_errors += 1
+        return
+    if not record or RECORD_SIZES.get(record[0]) != len(record):
+        stats.framing_errors += 1
+        return
+    if crc8(record[:-1]) != record[-1]:
+        stats.crc_errors += 1
+        return
+
+    seq = struct.unpack_from("<H", record, 1)[0]
+    if stats.last_seq is not None:
+        stats.lost += (seq - stats.last_seq - 1) & 0xFFFF
+    stats.last_seq = seq
+    stats.records += 1
+    stats.payload_bytes += len(record)
+
+    if record[0] in (RECORD_SUMMARY, RECORD_SUMMARY_FUSED):
+        if not quiet:
+            print_summary(record)
+        return
+
+    _, _, t_trigger, t_done, temp_raw, hum_raw, flags = \
+        struct.unpack_from("<BHIIHHB", record)
+
+    if not quiet:
+        temp = temp_raw / 65536.0 * 165.0 - 40.0
+        hum = hum_raw / 65536.0 * 100.0
+        line = "%5d %10u %10u %7.2f C %6.2f %% %02x" \
+            % (seq, t_trigger, t_done, temp, hum, flags)
+        if record[0] == RECORD_FUSED:
+            # BMP280 ADC codes - compensation needs the sensor's calibration.
+            press_raw = int.from_bytes(record[16:19], "little")
+            ptemp_raw = int.from_bytes(record[19:22], "little")
+            line += " P %6d T %6d" % (press_raw, ptemp_raw)
+        print(line)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("device")
+    parser.add_argument("--baud", type=int, default=115200, choices=sorted(BAUD_RATES))
+    parser.add_argument("--quiet", action="store_true", help="statistics only")
+    args = parser.parse_args()
+
+    fd = open_port(args.device, args.baud)
+    stats = Stats()
+    next_report = stats.start + REPORT_INTERVAL_S
+    pending = bytearray()
+
+    try:
+        while True:
+            chunk = os.read(fd, 4096)
+            if not chunk:
+                break
+            pending += chunk
+            while True:
+                end = pending.find(b"\x00")
+                if end < 0:
+                    break
+                if end > 0:
+                    handle_frame(bytes(pending[:end]), stats, args.quiet)
+                del pending[:end + 1]
+            if time.monotonic() >= next_report:
+                stats.report()
+                next_report += REPORT_INTERVAL_S
+    except KeyboardInterrupt:
+        pass
+    stats.report()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,62 @@
+#include "window_stats.h"
+
+#define FRAC    WINDOW_STATS_MEAN_FRAC_BITS
+
+void window_stats_reset(window_stats_t * p_stats)
+{
+    p_stats->count = 0;
+    p_stats->min   = UINT16_MAX;
+    p_stats->max   = 0;
+    p_stats->mean  = 0;
+    p_stats->m2    = 0;
+}
+
+void window_stats_update(window_stats_t * p_stats, uint16_t value)
+{
+    int32_t x = (int32_t)((uint32_t)value << FRAC);
+    int32_t n;
+    int32_t delta;
+    int32_t step;
+
+    if (p_stats->count == UINT16_MAX)
+    {
+        return;
+    }
+
+    n     = ++p_stats->count;
+    delta = x - p_stats->mean;
+
+    // Rounded division - truncation would bias the mean towards zero.
+    // [the step never exceeds delta, so the mean stays between the old mean
+    //  and x and the product below cannot become negative]
+    step = (delta >= 0) ? (delta + n / 2) / n : -((-delta + n / 2) / n);
+
+    p_stats->mean += step;
+    p_stats->m2   += (uint64_t)((int64_t)delta * (x - p_stats->mean));
+
+    if (value < p_stats->min)
+    {
+        p_stats->min = value;
+    }
+    if (value > p_stats->max)
+    {
+        p_stats->max = value;
+    }
+}
+
+uint32_t window_stats_mean_get(window_stats_t const * p_stats)
+{
+    return (uint32_t)p_stats->mean;
+}
+
+uint32_t window_stats_variance_get(window_stats_t const * p_stats)
+{
+    uint64_t div;
+
+    if (p_stats->count < 2)
+    {
+        return 0;
+    }
+    div = (uint64_t)(p_stats->count - 1) << (2 * FRAC);
+    return (uint32_t)((p_stats->m2 + div / 2) / div);
+}
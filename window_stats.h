@@ -0,0 +1,41 @@
+#ifndef WINDOW_STATS_H__
+#define WINDOW_STATS_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Count, min, max, mean and variance of raw sensor codes, updated one
+ *  sample at a time (Welford) so no window of samples has to be kept.
+ *  The mean is kept with WINDOW_STATS_MEAN_FRAC_BITS fraction bits and the
+ *  sum of squared deviations with twice that, in integers only: an update
+ *  is one 32-bit division and one 32x32->64 bit multiply.
+ */
+#define WINDOW_STATS_MEAN_FRAC_BITS 8
+
+typedef struct
+{
+    uint16_t count;
+    uint16_t min;
+    uint16_t max;
+    int32_t  mean;  // << WINDOW_STATS_MEAN_FRAC_BITS
+    uint64_t m2;    // Sum of squared deviations << (2 * WINDOW_STATS_MEAN_FRAC_BITS)
+} window_stats_t;
+
+void window_stats_reset(window_stats_t * p_stats);
+
+void window_stats_update(window_stats_t * p_stats, uint16_t value);
+
+// Mean << WINDOW_STATS_MEAN_FRAC_BITS (fits 24 bits).
+uint32_t window_stats_mean_get(window_stats_t const * p_stats);
+
+// Sample variance in code^2, rounded. 0 below two samples.
+uint32_t window_stats_variance_get(window_stats_t const * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WINDOW_STATS_H__